@@ -16,6 +16,7 @@
  * - Baudrate: 38400 baudios (3840 × 10 bits/byte)
  * - Modo: Bidireccional no bloqueante
  * - Latencia: ~0.6-0.8 ms
+ * - Filtro opcional en el dispositivo, cargado desde SerialPlotter (ver filtro.h)
  * 
  * Ventajas sobre Arduino Uno:
  * - Un solo puerto (PORTA) para los 8 bits = mayor eficiencia
@@ -29,12 +30,14 @@
 #include "timer1.h"    // Timer1 para interrupciones precisas  
 #include "tablas.h"    // Tablas de formas de onda
 #include "usart.h"     // Comunicación serie
+#include "filtro.h"    // Filtro en punto fijo y comandos de SerialPlotter
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
 // Instancias de controladores
 ADCController adc;           // Controlador del ADC
 Timer1 timer1(3840.0);       // Timer a 11520 Hz para muestreo
+FiltroDispositivo dispositivo;  // Filtro cargado desde SerialPlotter (ver filtro.h)
 
 /**
  * Escribe un valor de 8 bits al DAC R2R usando PORTA completo
@@ -195,23 +198,45 @@ void loop()
    // CÓDIGO DSP ACTIVO - Sistema bidireccional ADC ↔ PC ↔ DAC
    // Funcionamiento:
    // 1. Lee señal analógica del ADC a 3840 Hz
-   // 2. Envía muestra por serie a la PC/interfaz C++
-   // 3. Si recibe datos procesados de la PC, los usa para el DAC
-   // 4. Si no, usa directamente el ADC invertido para el DAC
+   // 2. Envía muestra por serie a la PC/interfaz C++ (o una respuesta a un comando)
+   // 3. Si el filtro en el dispositivo está activo, lo aplica y mide sus ciclos
+   // 4. Si no, usa los datos procesados de la PC o el ADC directo para el DAC
    if (beat){
       beat = false;
       
       // Enviar muestra actual por serie a la interfaz C++
       uint8_t muestra_adc = adc.get();           // Leer ADC (0-255)
-      usart.escribir(muestra_adc);               // Enviar a PC para análisis/filtrado
+      if (muestra_adc == 255)
+         muestra_adc = 254;                      // 255 reservado para tramas (ver filtro.h)
+      usart.escribir(dispositivo.byte_salida(muestra_adc));
       
-      // Recibir datos procesados desde la interfaz C++
-      if (usart.pendiente_lectura()){
-         valor = usart.leer();                   // Usar señal filtrada/procesada de la PC
+      // Recibir desde la interfaz C++: los bytes de comandos reemplazan muestras,
+      // se consumen hasta encontrar una muestra para no acumular atraso
+      bool leido = false, muestra_pc = false;
+      uint8_t desde_pc = 0;
+      while (!muestra_pc && usart.pendiente_lectura()){
+         desde_pc = usart.leer();
+         muestra_pc = !dispositivo.recibir(desde_pc);
+         leido = true;
       }
-      else {
+      
+      if (dispositivo.en_dispositivo()){
+         // Ciclos de CPU del filtro: TCNT1 se reinicia en OCR1A (modo CTC)
+         uint16_t inicio = TCNT1;
+         valor = dispositivo.filtrar(muestra_adc);
+         uint16_t fin = TCNT1;
+         uint16_t cuentas = fin >= inicio ? fin - inicio : fin + OCR1A + 1 - inicio;
+         dispositivo.registrar_ciclos(cuentas * timer1.get_prescaler());
+      }
+      else if (muestra_pc){
+         valor = desde_pc;                       // Usar señal filtrada/procesada de la PC
+      }
+      else if (!leido){
          valor = muestra_adc;                    // Usar ADC directo como fallback
       }
+      // Solo comandos: se mantiene el valor anterior
+      
+      dispositivo.tarea();                       // Avanza la prueba de igualdad si hay una en curso
       
       // El valor ya se escribirá al DAC en la próxima interrupción del Timer1
    }
@@ -0,0 +1,137 @@
+#pragma once
+/**
+ * Biquad en punto fijo compartido entre el firmware y SerialPlotter
+ *
+ * El mismo archivo compila en el AVR (loop de DSP.ino) y en la PC (emulador de
+ * SerialPlotter, ver DeviceFilter.h). Toda la aritmética usa tipos de ancho fijo y
+ * conversiones explícitas a 32 bits, así la salida es idéntica bit a bit en ambos
+ * lados. En el AVR int es de 16 bits: sin las conversiones los productos desbordan.
+ *
+ * Formato:
+ * - Muestras en Q15: el código de 8 bits centrado (Q7) desplazado 8 bits
+ * - a1, a2 en Q2.14 (rango [-2, 2))
+ * - b0, b1, b2 en Q2.(14 + desplazamiento_b): las secciones pasa bajos de corte bajo
+ *   tienen coeficientes b muy chicos que en Q14 perderían casi toda la precisión
+ * - Forma directa I: acumulador de 32 bits y saturación a 16 bits
+ * - Realimentación del error: el resto que se descarta al pasar el acumulador a Q15 se
+ *   suma en la muestra siguiente. Saca el ruido de cuantización de DC, donde los polos
+ *   cercanos a z = 1 (cortes bajos) lo amplifican (orden 8 a 20 Hz: de 1 dB a 25 dB de SNR)
+ *
+ * Códigos de salida: 0 a 254. El 255 queda reservado como inicio de trama de
+ * comandos en ambos sentidos del puerto serie.
+ */
+#include <stdint.h>
+
+#define BIQUAD_Q15_SECCIONES 4   // Máximo en el dispositivo (orden 8)
+#define BIQUAD_Q15_FRACCION 14
+
+struct SeccionQ15 {
+  int16_t b0, b1, b2;
+  int16_t a1, a2;              // Signo de la ecuación de diferencias: y = ... - a1 y1 - a2 y2
+  uint8_t desplazamiento_b;    // Bits extra de fracción de b0, b1 y b2
+  int16_t x1, x2, y1, y2;      // Estado
+  int16_t resto;               // Error de truncado de la salida anterior (0 a 2^14 - 1)
+};
+
+struct BiquadQ15 {
+  uint8_t secciones;
+  SeccionQ15 s[BIQUAD_Q15_SECCIONES];
+};
+
+static inline int16_t saturar_q15(int32_t v) {
+  if (v > 32767)
+    return 32767;
+  if (v < -32768)
+    return -32768;
+  return (int16_t)v;
+}
+
+static inline int16_t codigo_a_q15(uint8_t codigo) {
+  return (int16_t)(((int16_t)codigo - 128) * 256);
+}
+
+static inline uint8_t q15_a_codigo(int16_t v) {
+  int16_t codigo = (int16_t)((((int32_t)v + 128) >> 8) + 128);
+  if (codigo < 0)
+    return 0;
+  if (codigo > 254)
+    return 254;
+  return (uint8_t)codigo;
+}
+
+static inline void biquad_q15_reiniciar(BiquadQ15* f) {
+  for (uint8_t k = 0; k < BIQUAD_Q15_SECCIONES; k++)
+    f->s[k].x1 = f->s[k].x2 = f->s[k].y1 = f->s[k].y2 = f->s[k].resto = 0;
+}
+
+/**
+ * Filtra una muestra Q15 por todas las secciones
+ * Las sumas se hacen en uint32_t (desborde definido) y se reinterpretan con signo
+ */
+static inline int16_t biquad_q15_filtrar(BiquadQ15* f, int16_t x) {
+  for (uint8_t k = 0; k < f->secciones; k++) {
+    SeccionQ15* s = &f->s[k];
+    uint32_t suma_b = (uint32_t)((int32_t)s->b0 * x)
+                    + (uint32_t)((int32_t)s->b1 * s->x1)
+                    + (uint32_t)((int32_t)s->b2 * s->x2);
+    uint32_t acumulador = (uint32_t)((int32_t)suma_b >> s->desplazamiento_b)
+                        - (uint32_t)((int32_t)s->a1 * s->y1)
+                        - (uint32_t)((int32_t)s->a2 * s->y2)
+                        + (uint32_t)s->resto;
+    int16_t y = saturar_q15((int32_t)acumulador >> BIQUAD_Q15_FRACCION);
+    s->resto = (int16_t)(acumulador & (((uint32_t)1 << BIQUAD_Q15_FRACCION) - 1));
+
+    s->x2 = s->x1;
+    s->x1 = x;
+    s->y2 = s->y1;
+    s->y1 = y;
+    x = y;
+  }
+  return x;
+}
+
+static inline uint8_t biquad_q15_filtrar_codigo(BiquadQ15* f, uint8_t codigo) {
+  return q15_a_codigo(biquad_q15_filtrar(f, codigo_a_q15(codigo)));
+}
+
+/**
+ * CRC-16/CCITT (polinomio 0x1021) de un byte
+ */
+static inline uint16_t crc16_ccitt(uint16_t crc, uint8_t byte) {
+  crc ^= (uint16_t)byte << 8;
+  for (uint8_t i = 0; i < 8; i++)
+    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  return crc;
+}
+
+/**
+ * Prueba de igualdad bit a bit: filtra una secuencia pseudoaleatoria (LFSR de 16 bits)
+ * con una copia del filtro desde estado cero y acumula el CRC de los códigos de salida.
+ * El dispositivo la ejecuta de a pocas muestras por ciclo del loop; la PC de una vez.
+ */
+struct PruebaQ15 {
+  BiquadQ15 filtro;
+  uint16_t lfsr;
+  uint16_t crc;
+  uint16_t restantes;
+};
+
+static inline void prueba_q15_iniciar(PruebaQ15* p, const BiquadQ15* f, uint16_t semilla, uint16_t muestras) {
+  p->filtro = *f;
+  biquad_q15_reiniciar(&p->filtro);
+  p->lfsr = semilla ? semilla : 1;
+  p->crc = 0xFFFF;
+  p->restantes = muestras;
+}
+
+static inline void prueba_q15_paso(PruebaQ15* p) {
+  // LFSR de Galois (x^16 + x^14 + x^13 + x^11 + 1)
+  uint16_t bit = p->lfsr & 1;
+  p->lfsr >>= 1;
+  if (bit)
+    p->lfsr ^= 0xB400;
+
+  uint8_t salida = biquad_q15_filtrar_codigo(&p->filtro, (uint8_t)p->lfsr);
+  p->crc = crc16_ccitt(p->crc, salida);
+  p->restantes--;
+}
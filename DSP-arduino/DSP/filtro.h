@@ -0,0 +1,190 @@
+#pragma once
+#include "biquad_q15.h"
+
+/**
+ * Filtro en el dispositivo y protocolo de comandos con SerialPlotter
+ *
+ * El byte 255 inicia una trama en ambos sentidos; las muestras del ADC y del DAC
+ * usan 0 a 254. SerialPlotter envía los comandos en lugar de muestras del DAC
+ * (mantiene un byte por muestra) y reemplaza las respuestas por la muestra anterior.
+ *
+ * PC -> dispositivo:
+ * - 255 'Q' n [b0 b1 b2 a1 a2 (int16 LE) desplazamiento_b] x n suma: coeficientes nuevos,
+ *   se cambian entre dos muestras; suma = suma de los bytes desde n (módulo 256)
+ * - 255 'M' modo: 0 = procesado en la PC, 1 = filtro en el dispositivo
+ * - 255 'T' semilla (uint16 LE): prueba de igualdad bit a bit (ver PruebaQ15)
+ * - 255 'S': pide los ciclos de CPU del filtro desde el último pedido
+ *
+ * Dispositivo -> PC (siempre 6 bytes):
+ * - 255 'A' n correcto 0 0: confirmación de coeficientes
+ * - 255 'T' crc muestras (uint16 LE): resultado de la prueba
+ * - 255 'C' promedio máximo (uint16 LE): ciclos de CPU por muestra
+ */
+class FiltroDispositivo {
+  BiquadQ15 filtro = {};
+  bool activo = false;  // Filtro en el dispositivo en lugar del procesado en la PC
+
+  // Trama recibida en curso (recibidos = 0: ninguna)
+  uint8_t comando[3 + BIQUAD_Q15_SECCIONES * 11 + 1];
+  uint8_t recibidos = 0, esperados = 0;
+
+  // Respuesta en curso; si llega otro pedido mientras se envía se descarta
+  uint8_t respuesta[6];
+  uint8_t enviados = sizeof(respuesta);
+
+  PruebaQ15 prueba;
+  bool prueba_activa = false;
+
+  uint32_t ciclos_suma = 0;
+  uint16_t ciclos_cuenta = 0, ciclos_max = 0;
+
+  static int16_t leer_int16(const uint8_t* p) {
+    return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+  }
+
+  void responder(uint8_t tipo, uint16_t a, uint16_t b) {
+    if (enviados < sizeof(respuesta))
+      return;
+
+    respuesta[0] = 255;
+    respuesta[1] = tipo;
+    respuesta[2] = a & 255;
+    respuesta[3] = a >> 8;
+    respuesta[4] = b & 255;
+    respuesta[5] = b >> 8;
+    enviados = 0;
+  }
+
+  void cargar_coeficientes() {
+    uint8_t secciones = comando[2];
+    uint8_t suma = 0;
+    for (uint8_t i = 2; i < esperados - 1; i++)
+      suma += comando[i];
+
+    bool correcto = suma == comando[esperados - 1];
+    if (correcto) {
+      // Misma cantidad de secciones: conserva el estado para no generar un transitorio
+      if (secciones != filtro.secciones) {
+        biquad_q15_reiniciar(&filtro);
+        filtro.secciones = secciones;
+      }
+
+      const uint8_t* p = comando + 3;
+      for (uint8_t k = 0; k < secciones; k++, p += 11) {
+        SeccionQ15* s = &filtro.s[k];
+        s->b0 = leer_int16(p);
+        s->b1 = leer_int16(p + 2);
+        s->b2 = leer_int16(p + 4);
+        s->a1 = leer_int16(p + 6);
+        s->a2 = leer_int16(p + 8);
+        s->desplazamiento_b = p[10];
+      }
+    }
+    responder('A', secciones | ((uint16_t)correcto << 8), 0);
+  }
+
+  void ejecutar() {
+    switch (comando[1]) {
+    case 'Q':
+      cargar_coeficientes();
+      break;
+    case 'M':
+      if (comando[2] && !activo)
+        biquad_q15_reiniciar(&filtro);
+      activo = comando[2] != 0;
+      break;
+    case 'T':
+      prueba_q15_iniciar(&prueba, &filtro, (uint16_t)comando[2] | ((uint16_t)comando[3] << 8), 4096);
+      prueba_activa = true;
+      break;
+    case 'S':
+      responder('C', ciclos_cuenta ? ciclos_suma / ciclos_cuenta : 0, ciclos_max);
+      ciclos_suma = 0;
+      ciclos_cuenta = 0;
+      ciclos_max = 0;
+      break;
+    }
+  }
+
+public:
+  bool en_dispositivo() const {
+    return activo;
+  }
+
+  /**
+   * Procesa un byte recibido de la PC
+   * @return false si el byte es una muestra para el DAC
+   */
+  bool recibir(uint8_t byte) {
+    if (recibidos == 0) {
+      if (byte != 255)
+        return false;
+      comando[recibidos++] = byte;
+      esperados = 2;
+      return true;
+    }
+
+    comando[recibidos++] = byte;
+    if (recibidos == 2) {
+      switch (byte) {
+      case 'Q': esperados = 3; break;
+      case 'M': esperados = 3; break;
+      case 'T': esperados = 4; break;
+      case 'S': esperados = 2; break;
+      default:
+        recibidos = 0;  // Comando desconocido
+        return true;
+      }
+    }
+    else if (recibidos == 3 && comando[1] == 'Q') {
+      if (byte > BIQUAD_Q15_SECCIONES) {
+        recibidos = 0;
+        return true;
+      }
+      esperados = 3 + byte * 11 + 1;
+    }
+
+    if (recibidos == esperados) {
+      ejecutar();
+      recibidos = 0;
+    }
+    return true;
+  }
+
+  uint8_t filtrar(uint8_t codigo) {
+    return biquad_q15_filtrar_codigo(&filtro, codigo);
+  }
+
+  void registrar_ciclos(uint16_t ciclos) {
+    if (ciclos_cuenta == 65535)
+      return;
+    ciclos_suma += ciclos;
+    ciclos_cuenta++;
+    if (ciclos > ciclos_max)
+      ciclos_max = ciclos;
+  }
+
+  /**
+   * Byte a enviar en este ciclo: la respuesta pendiente o la muestra del ADC
+   */
+  uint8_t byte_salida(uint8_t muestra) {
+    if (enviados < sizeof(respuesta))
+      return respuesta[enviados++];
+    return muestra;
+  }
+
+  /**
+   * Avanza la prueba de igualdad: una muestra por ciclo para no exceder el
+   * presupuesto del loop (4096 muestras = 1,07 s a 3840 Hz)
+   */
+  void tarea() {
+    if (!prueba_activa)
+      return;
+
+    prueba_q15_paso(&prueba);
+    if (prueba.restantes == 0) {
+      prueba_activa = false;
+      responder('T', prueba.crc, 4096);
+    }
+  }
+};
@@ -30,6 +30,13 @@ public:
     comparador = 16e6 / (prescaler * frecuencia) - 1;
   }
 
+  /**
+   * Divisor del clock: TCNT1 × prescaler = ciclos de CPU
+   */
+  uint16_t get_prescaler() const {
+    return prescaler;
+  }
+
   /**
    * Configurar registros del Timer1 en modo CTC (Clear Timer on Compare)
    * Configura el timer pero NO lo inicia
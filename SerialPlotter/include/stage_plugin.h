@@ -0,0 +1,70 @@
+/* stage_plugin.h - Interfaz C estable para etapas de procesamiento cargadas en tiempo de ejecución
+ *
+ * Un plugin es una DLL en la carpeta "plugins" junto al ejecutable que exporta
+ * sp_stage_api(). SerialPlotter la carga con LoadLibrary (dlopen fuera de Windows) y la
+ * ofrece como etapa más de la cadena (ver ProcessingChain.h).
+ *
+ * Contrato:
+ * - init: crea el estado de una instancia para la frecuencia de muestreo y los parámetros
+ *   dados (param_count valores en el orden de describe_params). NULL si falla
+ * - process: procesa 'count' muestras (volts, 128 como máximo por lote). 'in' y 'out' son
+ *   el mismo buffer de la cadena (sin copias): el plugin debe admitir procesar en el lugar
+ * - reset: descarta la historia sin cambiar los parámetros
+ * - release: libera el estado creado por init
+ * - configure (opcional, puede ser NULL): cambia los parámetros conservando el estado; si
+ *   falta, la cadena crea una instancia nueva con init
+ *
+ * Todas las funciones salvo describe_params se llaman desde el hilo de adquisición: no deben
+ * bloquear ni reservar memoria en process. El costo de cada etapa se muestra en la interfaz.
+ *
+ * Compatibilidad: solo tipos de C y punteros a funciones; api_version cambia si cambia la
+ * estructura y la cadena rechaza los plugins de otra versión.
+ */
+
+#ifndef STAGE_PLUGIN_H
+#define STAGE_PLUGIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SP_API_VERSION 1
+#define SP_MAX_PARAMS 8
+
+#ifdef _WIN32
+#define SP_EXPORT __declspec(dllexport)
+#else
+#define SP_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* Descripción de un parámetro (valor double entre min y max) */
+typedef struct SpParam {
+    const char* name;
+    double min, max, initial;
+} SpParam;
+
+typedef struct SpStageApi {
+    uint32_t api_version;   /* SP_API_VERSION */
+    const char* name;
+
+    /* Devuelve la cantidad de parámetros (SP_MAX_PARAMS como máximo) y su descripción */
+    uint32_t (*describe_params)(const SpParam** params);
+
+    void* (*init)(double sampling_rate, const double* params, uint32_t param_count);
+    void (*process)(void* state, const double* in, double* out, uint32_t count);
+    void (*reset)(void* state);
+    void (*release)(void* state);
+    void (*configure)(void* state, const double* params, uint32_t param_count);
+} SpStageApi;
+
+/* Único símbolo exportado por el plugin */
+typedef const SpStageApi* (*SpStageApiFunction)(void);
+#define SP_STAGE_API_SYMBOL "sp_stage_api"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
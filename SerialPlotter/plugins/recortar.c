@@ -0,0 +1,59 @@
+/* recortar.c - Plugin de ejemplo: recorte suave (tanh) con umbral y ganancia previa
+ *
+ * Muestra el uso mínimo de stage_plugin.h: sin estado entre muestras, procesa en el lugar.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "stage_plugin.h"
+
+typedef struct Recortar {
+    double threshold, drive;
+} Recortar;
+
+static const SpParam params[] = {
+    { "Umbral (V)", 0.1, 6, 3 },
+    { "Ganancia", 1, 20, 1 },
+};
+
+static uint32_t DescribeParams(const SpParam** out) {
+    *out = params;
+    return 2;
+}
+
+static void Configure(void* state, const double* values, uint32_t count) {
+    Recortar* recortar = (Recortar*)state;
+    recortar->threshold = count > 0 ? values[0] : params[0].initial;
+    recortar->drive = count > 1 ? values[1] : params[1].initial;
+}
+
+static void* Init(double sampling_rate, const double* values, uint32_t count) {
+    (void)sampling_rate;
+    Recortar* recortar = (Recortar*)malloc(sizeof(Recortar));
+    if (recortar)
+        Configure(recortar, values, count);
+    return recortar;
+}
+
+static void Process(void* state, const double* in, double* out, uint32_t count) {
+    const Recortar* recortar = (const Recortar*)state;
+    for (uint32_t n = 0; n < count; n++)
+        out[n] = recortar->threshold * tanh(recortar->drive * in[n] / recortar->threshold);
+}
+
+static void Reset(void* state) {
+    (void)state;
+}
+
+static void Release(void* state) {
+    free(state);
+}
+
+static const SpStageApi api = {
+    SP_API_VERSION, "Recortar", DescribeParams, Init, Process, Reset, Release, Configure
+};
+
+SP_EXPORT const SpStageApi* sp_stage_api(void) {
+    return &api;
+}
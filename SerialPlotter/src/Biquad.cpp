@@ -0,0 +1,195 @@
+// Biquad.cpp - Implementación de la cascada SOS por bloques (escalar y AVX2)
+
+#include "Biquad.h"
+
+#include <array>
+#include <utility>
+
+#include "Simd.h"
+
+// Cada muestra atraviesa las N secciones con los coeficientes y el estado en variables locales
+// de índice constante (el compilador las mantiene en registros). Sin dependencia entre la
+// sección k de la muestra n + 1 y la sección k + 1 de la muestra n, el procesador superpone
+// las N recursiones: el costo por sección queda limitado por el ancho, no por la latencia
+template <int N>
+void BiquadCascade::ProcessFixed(BiquadCascade& cascade, int first, double* data, uint32_t count) {
+    if constexpr (N > 0) {
+        double c_b0[N], c_b1[N], c_b2[N], c_a1[N], c_a2[N], z1[N], z2[N];
+        for (int k = 0; k < N; k++) {
+            c_b0[k] = cascade.b0[first + k];
+            c_b1[k] = cascade.b1[first + k];
+            c_b2[k] = cascade.b2[first + k];
+            c_a1[k] = cascade.a1[first + k];
+            c_a2[k] = cascade.a2[first + k];
+            z1[k] = cascade.s1[first + k];
+            z2[k] = cascade.s2[first + k];
+        }
+
+        for (uint32_t n = 0; n < count; n++) {
+            double x = data[n];
+            auto step = [&](auto index) {
+                constexpr int k = decltype(index)::value;
+                double y = c_b0[k] * x + z1[k];
+                z1[k] = c_b1[k] * x - c_a1[k] * y + z2[k];
+                z2[k] = c_b2[k] * x - c_a2[k] * y;
+                x = y;
+            };
+            [&]<int... K>(std::integer_sequence<int, K...>) {
+                (step(std::integral_constant<int, K>{}), ...);
+            }(std::make_integer_sequence<int, N>{});
+            data[n] = x;
+        }
+
+        for (int k = 0; k < N; k++) {
+            cascade.s1[first + k] = z1[k];
+            cascade.s2[first + k] = z2[k];
+        }
+    }
+}
+
+BiquadCascade::Kernel BiquadCascade::SelectKernel(int count) {
+    static constexpr auto kernels = []<int... N>(std::integer_sequence<int, N...>) {
+        return std::array<Kernel, sizeof...(N)>{ &ProcessFixed<N>... };
+    }(std::make_integer_sequence<int, max_sections + 1>{});
+    return kernels[count < 0 ? 0 : count > max_sections ? max_sections : count];
+}
+
+void BiquadCascade::SetCoefficients(const BiquadCoefficients* coefficients, int count) {
+    if (count != sections) {
+        Reset();
+        kernel = SelectKernel(count);
+        tail_kernel = SelectKernel(count % 4);
+    }
+
+    sections = count;
+    for (int k = 0; k < count; k++) {
+        b0[k] = coefficients[k].b0;
+        b1[k] = coefficients[k].b1;
+        b2[k] = coefficients[k].b2;
+        a1[k] = coefficients[k].a1;
+        a2[k] = coefficients[k].a2;
+    }
+}
+
+void BiquadCascade::Reset() {
+    for (int k = 0; k < max_sections; k++)
+        s1[k] = s2[k] = 0;
+}
+
+void BiquadCascade::Prime(double x) {
+    for (int k = 0; k < sections; k++) {
+        // Ganancia en continua de la sección: H(1) = (b0 + b1 + b2) / (1 + a1 + a2)
+        double denom = 1 + a1[k] + a2[k];
+        double y = denom != 0 ? (b0[k] + b1[k] + b2[k]) / denom * x : 0;
+        s2[k] = b2[k] * x - a2[k] * y;
+        s1[k] = b1[k] * x - a1[k] * y + s2[k];
+        x = y;
+    }
+}
+
+void BiquadCascade::SetState(const double* state1, const double* state2) {
+    for (int k = 0; k < sections; k++) {
+        s1[k] = state1[k];
+        s2[k] = state2[k];
+    }
+}
+
+void BiquadCascade::Process(double* data, uint32_t count) {
+    if (CpuHasAvx2())
+        ProcessAvx2(data, count);
+    else
+        ProcessUnrolled(data, count);
+}
+
+void BiquadCascade::ProcessScalar(double* data, uint32_t count) {
+    for (int k = 0; k < sections; k++)
+        ProcessSection(k, data, count);
+}
+
+double BiquadCascade::Filter(double x) {
+    for (int k = 0; k < sections; k++) {
+        double y = b0[k] * x + s1[k];
+        s1[k] = b1[k] * x - a1[k] * y + s2[k];
+        s2[k] = b2[k] * x - a2[k] * y;
+        x = y;
+    }
+    return x;
+}
+
+// Una sección sobre todo el bloque: coeficientes y estado quedan en registros
+void BiquadCascade::ProcessSection(int k, double* data, uint32_t count) {
+    const double c_b0 = b0[k], c_b1 = b1[k], c_b2 = b2[k], c_a1 = a1[k], c_a2 = a2[k];
+    double z1 = s1[k], z2 = s2[k];
+    for (uint32_t n = 0; n < count; n++) {
+        double x = data[n];
+        double y = c_b0 * x + z1;
+        z1 = c_b1 * x - c_a1 * y + z2;
+        z2 = c_b2 * x - c_a2 * y;
+        data[n] = y;
+    }
+    s1[k] = z1;
+    s2[k] = z2;
+}
+
+void BiquadCascade::ProcessAvx2(double* data, uint32_t count) {
+    if (count < 4) {
+        kernel(*this, 0, data, count);
+        return;
+    }
+    int k = 0;
+    for (; k + 4 <= sections; k += 4)
+        ProcessGroupAvx2(k, data, count);
+    tail_kernel(*this, k, data, count);
+}
+
+// Cuatro secciones consecutivas en pipeline: en el paso t el carril k procesa la muestra t - k.
+// Las primeras y últimas muestras de cada sección se procesan en escalar, así el pipeline
+// se llena y se vacía dentro del bloque y el estado entre bloques es el de la forma escalar.
+SIMD_TARGET_AVX2 void BiquadCascade::ProcessGroupAvx2(int first, double* data, uint32_t count) {
+    const int k0 = first, k1 = first + 1, k2 = first + 2, k3 = first + 3;
+    auto step = [this](int k, double x) {
+        double y = b0[k] * x + s1[k];
+        s1[k] = b1[k] * x - a1[k] * y + s2[k];
+        s2[k] = b2[k] * x - a2[k] * y;
+        return y;
+    };
+
+    // Llenado: la sección k procesa sus primeras 3 - k muestras
+    double w0_0 = step(k0, data[0]), w0_1 = step(k0, data[1]), w0_2 = step(k0, data[2]);
+    double w1_0 = step(k1, w0_0), w1_1 = step(k1, w0_1);
+    double w2_0 = step(k2, w1_0);
+
+    const __m256d v_b0 = _mm256_load_pd(&b0[first]), v_b1 = _mm256_load_pd(&b1[first]);
+    const __m256d v_b2 = _mm256_load_pd(&b2[first]), v_a1 = _mm256_load_pd(&a1[first]);
+    const __m256d v_a2 = _mm256_load_pd(&a2[first]);
+    __m256d z1 = _mm256_load_pd(&s1[first]), z2 = _mm256_load_pd(&s2[first]);
+
+    __m256d x = _mm256_set_pd(w2_0, w1_1, w0_2, data[3]);
+    __m256d y = x;
+    for (uint32_t t = 3; t < count; t++) {
+        y = _mm256_fmadd_pd(v_b0, x, z1);
+        z1 = _mm256_fmadd_pd(v_b1, x, _mm256_fnmadd_pd(v_a1, y, z2));
+        z2 = _mm256_fnmadd_pd(v_a2, y, _mm256_mul_pd(v_b2, x));
+
+        // El carril 3 entrega la salida final de la muestra t - 3
+        __m128d high = _mm256_extractf128_pd(y, 1);
+        data[t - 3] = _mm_cvtsd_f64(_mm_unpackhi_pd(high, high));
+
+        // Cada carril pasa su salida al siguiente; el carril 0 toma la muestra nueva
+        if (t + 1 < count)
+            x = _mm256_blend_pd(_mm256_permute4x64_pd(y, _MM_SHUFFLE(2, 1, 0, 3)), _mm256_set1_pd(data[t + 1]), 0x1);
+    }
+
+    _mm256_store_pd(&s1[first], z1);
+    _mm256_store_pd(&s2[first], z2);
+
+    // Vaciado: la sección k procesa sus últimas k muestras
+    alignas(32) double last[4];
+    _mm256_store_pd(last, y);
+    double w1_n1 = step(k1, last[0]);
+    double w2_n2 = step(k2, last[1]);
+    double w2_n1 = step(k2, w1_n1);
+    data[count - 3] = step(k3, last[2]);
+    data[count - 2] = step(k3, w2_n2);
+    data[count - 1] = step(k3, w2_n1);
+}
@@ -0,0 +1,97 @@
+// Biquad.h - Cascada de secciones de segundo orden (SOS) procesada por bloques
+//
+// Reemplaza el filtrado muestra a muestra de iir1 en SerialWorker: los coeficientes se
+// diseñan con iir1 y se copian a BiquadCascade, que filtra el lote completo.
+//
+// Características:
+// - Forma directa II transpuesta, estado de cada sección en registros durante el bloque
+// - Ruta AVX2: 4 secciones en los 4 carriles de un registro, en pipeline (el carril k
+//   procesa la muestra n - k), con entrada y salida del pipeline escalares para que el
+//   resultado no tenga latencia extra
+// - Ruta escalar (sección por sección sobre el bloque) si no hay AVX2
+// - Kernels desenrollados en compilación para cada cantidad de secciones (0 a max_sections):
+//   todas las secciones por muestra con el estado en registros, sin lazo ni saltos por
+//   sección. Se eligen por tabla de punteros al cambiar la cantidad de secciones: uno para
+//   la cascada completa (sin AVX2) y otro para las secciones que sobran de los grupos de 4
+//
+// Thread-safety: una instancia pertenece a un único hilo (el que llama a Process)
+
+#pragma once
+
+#include <cstdint>
+
+// Coeficientes normalizados (a0 = 1) de una sección de segundo orden
+struct BiquadCoefficients {
+	double b0, b1, b2;
+	double a1, a2;
+};
+
+// Coeficientes normalizados de una sección de iir1 (Iir::Biquad, etapas de una cascada o RBJ)
+// iir1 devuelve los coeficientes sin normalizar: se dividen por a0
+template <typename Stage>
+BiquadCoefficients ToCoefficients(const Stage& stage) {
+	double a0 = stage.getA0();
+	return { stage.getB0() / a0, stage.getB1() / a0, stage.getB2() / a0, stage.getA1() / a0, stage.getA2() / a0 };
+}
+
+class BiquadCascade {
+public:
+	static constexpr int max_sections = 16;  // Hasta orden 32
+
+	// Copia los coeficientes de una cascada de iir1 (Iir::Cascade o derivados)
+	// Conserva el estado si la cantidad de secciones no cambia
+	template <typename Cascade>
+	void LoadFrom(const Cascade& cascade) {
+		BiquadCoefficients coefficients[max_sections];
+		int count = cascade.getNumStages();
+		if (count > max_sections)
+			count = max_sections;
+		for (int i = 0; i < count; i++)
+			coefficients[i] = ToCoefficients(cascade[i]);
+		SetCoefficients(coefficients, count);
+	}
+
+	void SetCoefficients(const BiquadCoefficients* coefficients, int count);
+
+	// Limpia el estado interno de todas las secciones
+	void Reset();
+
+	// Carga el estado de régimen para una entrada constante x (como si x hubiera entrado
+	// desde siempre): al activar un filtro nuevo la salida arranca sin transitorio
+	void Prime(double x);
+
+	// Carga el estado de cada sección (p. ej. el de otro filtro con los mismos coeficientes)
+	void SetState(const double* state1, const double* state2);
+
+	// Filtra 'count' muestras en el lugar (elige la ruta AVX2 si está disponible)
+	void Process(double* data, uint32_t count);
+
+	void ProcessScalar(double* data, uint32_t count);
+	void ProcessAvx2(double* data, uint32_t count);
+	void ProcessUnrolled(double* data, uint32_t count) { kernel(*this, 0, data, count); }
+
+	// Filtra una sola muestra (usado fuera de los lotes)
+	double Filter(double x);
+
+	int Sections() const { return sections; }
+
+private:
+	using Kernel = void (*)(BiquadCascade& cascade, int first, double* data, uint32_t count);
+
+	// Secciones first a first + N - 1 desenrolladas (ver Biquad.cpp)
+	template <int N>
+	static void ProcessFixed(BiquadCascade& cascade, int first, double* data, uint32_t count);
+	static Kernel SelectKernel(int sections);
+
+	void ProcessSection(int k, double* data, uint32_t count);
+	void ProcessGroupAvx2(int first, double* data, uint32_t count);
+
+	int sections = 0;
+	Kernel kernel = SelectKernel(0);       // Todas las secciones
+	Kernel tail_kernel = SelectKernel(0);  // Últimas sections % 4 (después de los grupos AVX2)
+
+	// Coeficientes y estado en estructura de arreglos (carga directa en registros AVX)
+	alignas(32) double b0[max_sections], b1[max_sections], b2[max_sections];
+	alignas(32) double a1[max_sections], a2[max_sections];
+	alignas(32) double s1[max_sections] = {}, s2[max_sections] = {};
+};
@@ -6,23 +6,46 @@
 // - Gestiona automticamente el offset cuando los datos exceden la capacidad de vista
 // - Ideal para grficos de tiempo real donde solo se visualizan los ltimos N puntos
 //
+// BlockSummaries:
+// - Resmenes por bloque (min, max, suma, suma de cuadrados, tiempos) de una seal que ya
+//   guarda un ScrollBuffer, sin copiar las muestras
+// - Estadsticas de rangos de tiempo (RMS, auto-ajuste del eje Y) en O(bloques)
+//
 // Buffer<T>:
 // - Buffer circular thread-safe con lectura/escritura concurrente
 // - Usa ndices atmicos (start/end) para evitar condiciones de carrera
 // - Protegido con mutex durante operaciones de copia de datos
 // - Diseado para comunicacin productor-consumidor
+//
+// El almacenamiento de ScrollBuffer se reserva con ReservedMemory: el espacio de direcciones
+// completo se reserva al crear el buffer y las pginas se comprometen a medida que crece.
+//
+// ViewPublisher (ViewPublisher.h):
+// - Publica la ventana visible (inicio, cantidad, generacin) de los ScrollBuffer
+// - Los lectores obtienen una vista consistente sin tomar el mutex de adquisicin (seqlock)
 
 #pragma once
 
+#include <atomic>
+#include <cmath>
 #include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <format>
 #include <implot.h>
+#include <type_traits>
+
+#include "Memory.h"
+#include "ViewPublisher.h"
 
 // ScrollBuffer - Buffer circular con ventana deslizante para visualizacin
 // Template genrico que funciona con cualquier tipo numrico (int, double, float, etc.)
 template <typename T>
 class ScrollBuffer {
+	static_assert(std::is_trivially_copyable_v<T>, "ScrollBuffer usa memoria reservada sin construir elementos");
 public:
 	// Constructor
 	// capacity: tamao mximo del buffer interno (cantidad de elementos que puede almacenar)
@@ -30,18 +53,22 @@ public:
 	ScrollBuffer(uint32_t capacity, uint32_t view) :
 		capacity(capacity), view(view)
 	{
-		m_data = new T[capacity];
+		memory.Reserve((size_t)capacity * sizeof(T));
+		m_data = (T*)memory.data();
 	}
 
 	// Constructor de copia - crea una copia independiente del buffer
+	// Solo se copia la ventana visible, que queda al inicio del nuevo almacenamiento
 	ScrollBuffer(const ScrollBuffer& other) {
 		capacity = other.capacity;
-		m_size = other.m_size;
 		view = other.view;
-		m_data = new T[capacity];
-		uint32_t copy = view < m_size ? view : m_size;
-		for (size_t i = 0; i < copy; i++)
-			m_data[i] = other.m_data[i + offset];
+		memory.Reserve((size_t)capacity * sizeof(T));
+		m_data = (T*)memory.data();
+		m_size = other.count();
+		if (!commit(m_size))
+			m_size = 0;
+		for (size_t i = 0; i < m_size; i++)
+			m_data[i] = other.m_data[i + other.offset];
 	}
 
 	// Constructor de movimiento - transfiere la propiedad del buffer
@@ -50,43 +77,48 @@ public:
 		m_size = other.m_size;
 		view = other.view;
 		offset = other.offset;
+		committed = other.committed;
+		memory = std::move(other.memory);
 		m_data = other.m_data;
 		other.m_data = nullptr;
 	}
 
 	// Operador de asignacin por copia
 	ScrollBuffer& operator=(const ScrollBuffer& other) {
-		if (capacity < other.capacity) {
-			delete[] m_data;
-			m_data = new T[other.capacity];
+		if (this == &other)
+			return *this;
+
+		if (capacity < other.capacity || !m_data) {
+			memory.Reserve((size_t)other.capacity * sizeof(T));
+			m_data = (T*)memory.data();
+			committed = 0;
 		}
 
+		capacity = other.capacity;
 		view = other.view;
-		m_size = other.m_size;
+		m_size = other.count();
 		offset = 0;
-		uint32_t copy = view < m_size ? view : m_size;
-		for (size_t i = 0; i < copy; i++)
-			m_data[i] = other.m_data[i + offset];
+		if (!commit(m_size))
+			m_size = 0;
+		for (size_t i = 0; i < m_size; i++)
+			m_data[i] = other.m_data[i + other.offset];
 
         return *this;
 	}
 
 	// Operador de asignacin por movimiento
 	ScrollBuffer& operator=(ScrollBuffer&& other) {
-		delete[] m_data;
 		m_size = other.m_size;
 		capacity = other.capacity;
 		view = other.view;
 		offset = other.offset;
+		committed = other.committed;
+		memory = std::move(other.memory);
 		m_data = other.m_data;
 		other.m_data = nullptr;
         return *this;
 	}
 
-	~ScrollBuffer() {
-		delete[] m_data;
-	}
-
 	// Escribe mltiples elementos desde un buffer externo
 	// Si count > view, solo se escriben los ltimos 'view' elementos
 	// Gestiona automticamente el desplazamiento circular del buffer
@@ -98,6 +130,8 @@ public:
 
 		uint32_t new_size = m_size + count;
 		if (new_size <= capacity) {
+			if (!commit(new_size))
+				return;
 			std::copy(buffer, &buffer[count], &m_data[m_size]);
 			m_size = new_size;
 			if (m_size > view)
@@ -124,6 +158,13 @@ public:
 		m_size = 0;
 	}
 
+	// Vaca el buffer y devuelve sus pginas al sistema (conserva la reserva de direcciones)
+	void release_pages() {
+		clear();
+		memory.Decommit();
+		committed = 0;
+	}
+
 	// Agrega un nico elemento al final del buffer
 	// Si el buffer est lleno, desplaza los datos antiguos automticamente
 	void push(T value) {
@@ -137,6 +178,9 @@ public:
 			return;
 		}
 
+		// Sin memoria el elemento se descarta: el productor debe llamar antes a prepare()
+		if (m_size == committed && !commit(m_size + 1))
+			return;
 		m_data[m_size++] = value;
 		if (m_size > view)
 			offset = m_size - view;
@@ -172,10 +216,181 @@ public:
 		return m_data + offset;
 	}
 
+	// Posicin del primer elemento visible dentro del almacenamiento interno
+	uint32_t start() const {
+		return offset;
+	}
+
+	// Puntero al inicio del almacenamiento interno (no de la ventana visible)
+	// Se combina con BufferView::start para leer una ventana publicada
+	const T* storage() const {
+		return m_data;
+	}
+
+	// Compromete por adelantado las pginas para agregar 'count' elementos con push()
+	// Retorna false si el sistema no pudo comprometerlas: el lote no se debe agregar
+	bool prepare(uint32_t count) {
+		return commit(m_size + count < capacity ? m_size + count : capacity);
+	}
+
+	// Indica si agregar 'count' elementos con push() provocar una compactacin
+	// (mover los datos visibles al inicio del almacenamiento)
+	bool will_wrap(uint32_t count) const {
+		return m_size + count > capacity;
+	}
+
+	// Recorre los tramos [first, last) del almacenamiento que modificar agregar 'count'
+	// elementos con push(): primero el final del almacenamiento y, si hay compactacin,
+	// el inicio donde se copian los datos visibles y se siguen agregando los restantes
+	template <typename F>
+	void for_each_write_range(uint32_t count, F on_range) const {
+		if (!will_wrap(count)) {
+			on_range(m_size, m_size + count);
+			return;
+		}
+
+		uint32_t before = capacity - m_size;
+		if (before > 0)
+			on_range(m_size, capacity);
+		on_range(0, view - 1 + (count - before));
+	}
+
+	// Bytes de memoria comprometidos / reservados para el almacenamiento
+	size_t committed_bytes() const {
+		return memory.committed();
+	}
+
+	size_t reserved_bytes() const {
+		return memory.reserved();
+	}
+
 private:
 
-	uint32_t capacity, view, m_size = 0, offset = 0;
-	T* m_data;
+	// Compromete las pginas necesarias para almacenar 'count' elementos
+	// Se llama solo al cruzar el lmite comprometido (una vez por commit_step bytes)
+	// Retorna false si no se pudieron comprometer
+	bool commit(uint32_t count) {
+		if (count <= committed)
+			return true;
+		bool ok = memory.Commit((size_t)count * sizeof(T));
+		committed = (uint32_t)(memory.committed() / sizeof(T));
+		return ok;
+	}
+
+	uint32_t capacity, view, m_size = 0, offset = 0, committed = 0;
+	T* m_data = nullptr;
+	ReservedMemory memory;
+};
+
+// Resumen de un bloque (o de un rango) de muestras
+struct BlockSummary {
+	double min = INFINITY, max = -INFINITY;
+	double sum = 0, sum_squares = 0;
+	double first_time = INFINITY, last_time = -INFINITY;  // Tiempo de la primera y ltima muestra
+	uint32_t count = 0;
+
+	void add(double value, double time) {
+		if (value < min) min = value;
+		if (value > max) max = value;
+		sum += value;
+		sum_squares += value * value;
+		if (time < first_time) first_time = time;
+		if (time > last_time) last_time = time;
+		count++;
+	}
+
+	void merge(const BlockSummary& other) {
+		if (other.min < min) min = other.min;
+		if (other.max > max) max = other.max;
+		sum += other.sum;
+		sum_squares += other.sum_squares;
+		if (other.first_time < first_time) first_time = other.first_time;
+		if (other.last_time > last_time) last_time = other.last_time;
+		count += other.count;
+	}
+
+	double mean() const { return count ? sum / count : 0; }
+	double rms() const { return count ? std::sqrt(sum_squares / count) : 0; }
+};
+
+// BlockSummaries - Resmenes por bloque de una seal guardada en un ScrollBuffer
+// Solo guarda el resumen (min, max, suma, suma de cuadrados y tiempos de la primera y ltima
+// muestra) de cada bloque de BlockSize muestras, no las muestras: las estadsticas de un rango
+// de tiempo (RMS, auto-ajuste del eje Y) cuestan O(bloques) sin duplicar los datos. Los
+// bloques forman un anillo: agregar y descartar el ms antiguo es O(1), sin compactacin.
+//
+// Los bloques que el rango corta en los bordes se completan con las muestras del ScrollBuffer
+// a travs de la funcin 'edge' que recibe Summarize(); si las muestras ya no estn
+// disponibles se usa el resumen del bloque completo (error de a lo sumo un bloque por borde).
+//
+// Thread-safety: write() y Summarize() toman un mutex interno, de modo que un productor
+// puede agregar lotes mientras la UI consulta estadsticas.
+template <uint32_t BlockSize = 256>
+class BlockSummaries {
+public:
+	static constexpr uint32_t block_size = BlockSize;
+
+	// capacity: cantidad mnima de muestras cubiertas por los resmenes
+	explicit BlockSummaries(uint32_t capacity) :
+		blocks((capacity + BlockSize - 1) / BlockSize + 1)
+	{
+	}
+
+	// Agrega un lote de valores con sus tiempos tomando el mutex una sola vez
+	void write(const double* values, const double* times, uint32_t count) {
+		std::lock_guard lock(mutex);
+		for (uint32_t i = 0; i < count; i++) {
+			if (empty || blocks[newest].count == BlockSize) {
+				// Avanzar al bloque siguiente; si el anillo est lleno se recicla el ms antiguo
+				if (!empty) {
+					newest = (newest + 1) % blocks.size();
+					if (newest == oldest)
+						oldest = (oldest + 1) % blocks.size();
+				}
+				blocks[newest] = BlockSummary{};
+				empty = false;
+			}
+			blocks[newest].add(values[i], times[i]);
+		}
+	}
+
+	void clear() {
+		std::lock_guard lock(mutex);
+		oldest = newest = 0;
+		empty = true;
+	}
+
+	// Resumen de las muestras con tiempo en [from, to]
+	// Los bloques completamente dentro del rango se combinan con su resumen; para los bloques
+	// de los bordes se llama edge(first, last, result), que debe agregar a result las muestras
+	// con tiempo en [first, last] y devolver true (o false si ya no las tiene)
+	template <typename Edge>
+	BlockSummary Summarize(double from, double to, Edge&& edge) const {
+		std::lock_guard lock(mutex);
+		BlockSummary result;
+		if (empty)
+			return result;
+
+		for (size_t i = oldest;; i = (i + 1) % blocks.size()) {
+			const BlockSummary& summary = blocks[i];
+			if (summary.count > 0 && summary.last_time >= from && summary.first_time <= to) {
+				if (summary.first_time >= from && summary.last_time <= to)
+					result.merge(summary);
+				else if (!edge(from > summary.first_time ? from : summary.first_time,
+				               to < summary.last_time ? to : summary.last_time, result))
+					result.merge(summary);
+			}
+			if (i == newest)
+				break;
+		}
+		return result;
+	}
+
+private:
+	std::vector<BlockSummary> blocks;  // Anillo de resmenes (siempre hay uno libre)
+	size_t oldest = 0, newest = 0;
+	bool empty = true;
+	mutable std::mutex mutex;
 };
 
 // Buffer - Buffer circular thread-safe para comunicacin productor-consumidor
@@ -330,4 +545,4 @@ private:
 	T* data;
 
 	std::mutex data_mutex;  // Protege las operaciones de copia de datos
-};
\ No newline at end of file
+};
@@ -0,0 +1,126 @@
+// Cic.cpp - Integradores y peines en punto fijo y compensación de la caída sinc^N
+
+#include "Cic.h"
+
+#include <algorithm>
+#include <cmath>
+
+static int CeilLog2(int value) {
+    int bits = 0;
+    while ((1 << bits) < value)
+        bits++;
+    return bits;
+}
+
+double CicFilter::CompensationAlpha(int length, int stages) {
+    // Cerca de continua: sinc^N ≈ 1 - N pi² f² (R² - 1) / 6 y el FIR ≈ 1 + 4 a pi² f² R²
+    double r2 = (double)length * length;
+    return stages * (r2 - 1) / (24 * r2);
+}
+
+void CicFilter::Configure(int new_length, int new_stages, bool new_compensate) {
+    new_length = new_length < 1 ? 1 : new_length > max_length ? max_length : new_length;
+    new_stages = new_stages < 1 ? 1 : new_stages > max_stages ? max_stages : new_stages;
+    bool reset = new_length != length || new_stages != stages;
+    length = new_length;
+    stages = new_stages;
+
+    // La entrada se acota a ±16 V (5 bits con signo): la salida final ocupa 5 + frac_bits +
+    // N ceil(log2 R) bits y los resultados intermedios pueden desbordar (aritmética modular)
+    int growth = stages * CeilLog2(length);
+    frac_bits = 58 - growth < 24 ? 58 - growth : 24;
+    to_fixed = std::ldexp(1.0, frac_bits);
+    to_double = 1 / (to_fixed * std::pow((double)length, stages));
+
+    if (new_compensate != compensate || reset) {
+        history.assign(2 * length + 1, 0);
+        history_position = 0;
+    }
+    compensate = new_compensate;
+    alpha = CompensationAlpha(length, stages);
+
+    if (reset) {
+        combs.assign((size_t)stages * length, 0);
+        Reset();
+    }
+}
+
+void CicFilter::Reset() {
+    for (uint64_t& integrator : integrators)
+        integrator = 0;
+    std::fill(combs.begin(), combs.end(), 0);
+    std::fill(history.begin(), history.end(), 0);
+    position = 0;
+    history_position = 0;
+}
+
+double CicFilter::GroupDelay() const {
+    return stages * (length - 1) / 2.0 + (compensate ? length : 0);
+}
+
+void CicFilter::Process(double* data, uint32_t count) {
+    if (stages == 0)
+        return;
+
+    const double limit = 16 * to_fixed - 1;
+    uint32_t size = (uint32_t)history.size();
+    for (uint32_t n = 0; n < count; n++) {
+        // Redondeo al punto fijo (truncar x + 0.5 con signo es más barato que llround)
+        double scaled = data[n] * to_fixed;
+        scaled = scaled > limit ? limit : scaled < -limit ? -limit : scaled;
+        uint64_t value = (uint64_t)(int64_t)(scaled + (scaled >= 0 ? 0.5 : -0.5));
+
+        for (int s = 0; s < stages; s++)
+            value = integrators[s] += value;
+        for (int s = 0; s < stages; s++) {
+            uint64_t& delayed = combs[(size_t)s * length + position];
+            uint64_t input = value;
+            value -= delayed;
+            delayed = input;
+        }
+        if (++position == (uint32_t)length)
+            position = 0;
+
+        double y = (double)(int64_t)value * to_double;
+        if (compensate) {
+            // y[n - R] (1 + 2a) - a (y[n] + y[n - 2R])
+            history[history_position] = y;
+            uint32_t middle = history_position >= (uint32_t)length ? history_position - length : history_position + size - length;
+            uint32_t oldest = history_position + 1 == size ? 0 : history_position + 1;
+            y = (1 + 2 * alpha) * history[middle] - alpha * (y + history[oldest]);
+            history_position = oldest;
+        }
+        data[n] = y;
+    }
+}
+
+std::vector<double> CicFilter::Taps(int length, int stages, bool compensate) {
+    length = length < 1 ? 1 : length > max_length ? max_length : length;
+    stages = stages < 1 ? 1 : stages > max_stages ? max_stages : stages;
+
+    // Convolución sucesiva con una ventana de R unos (suma móvil de la respuesta anterior)
+    std::vector<double> taps{ 1.0 };
+    for (int s = 0; s < stages; s++) {
+        std::vector<double> next(taps.size() + length - 1, 0);
+        double sum = 0;
+        for (size_t i = 0; i < next.size(); i++) {
+            if (i < taps.size())
+                sum += taps[i];
+            if (i >= (size_t)length)
+                sum -= taps[i - length];
+            next[i] = sum / length;
+        }
+        taps = std::move(next);
+    }
+    if (!compensate)
+        return taps;
+
+    double a = CompensationAlpha(length, stages);
+    std::vector<double> compensated(taps.size() + 2 * length, 0);
+    for (size_t i = 0; i < taps.size(); i++) {
+        compensated[i] -= a * taps[i];
+        compensated[i + length] += (1 + 2 * a) * taps[i];
+        compensated[i + 2 * length] -= a * taps[i];
+    }
+    return compensated;
+}
@@ -0,0 +1,57 @@
+// Cic.h - Media móvil y filtro CIC (integrador-peine en cascada) en aritmética entera
+//
+// H(z) = [(1 - z^-R) / (R (1 - z^-1))]^N: N medias móviles de R muestras en cascada
+// (N = 1 es la media móvil simple). Se calcula con N integradores seguidos de N peines de
+// retardo R, de modo que el costo por muestra es O(N) sin importar la longitud R.
+//
+// Características:
+// - Entrada en punto fijo (int64 con frac_bits bits fraccionarios): integradores y peines
+//   en aritmética modular exacta, sin la deriva que acumula una suma móvil en double
+// - frac_bits se elige para que la ganancia R^N quepa en 64 bits (24 como máximo, ~0.06 µV)
+// - Compensación opcional: FIR de 3 coeficientes espaciados R muestras, -a (1+2a) -a,
+//   que aplana la caída de la banda pasante (sinc^N) hasta el segundo orden
+// - Sin diezmado: la salida sigue a la frecuencia de entrada (ver Decimator.h para bajarla)
+//
+// Retardo de grupo: N (R - 1) / 2 muestras, más R con la compensación
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class CicFilter {
+public:
+	static constexpr int max_length = 4096;
+	static constexpr int max_stages = 4;
+
+	// Conserva el estado si no cambian la longitud ni la cantidad de etapas
+	void Configure(int length, int stages, bool compensate);
+	void Reset();
+
+	// Filtra 'count' muestras en el lugar
+	void Process(double* data, uint32_t count);
+
+	int Length() const { return length; }
+	int Stages() const { return stages; }
+	double GroupDelay() const;
+
+	// Respuesta al impulso (N (R - 1) + 1 coeficientes, 2R más con la compensación)
+	static std::vector<double> Taps(int length, int stages, bool compensate);
+
+	// Coeficiente a de la compensación para R y N
+	static double CompensationAlpha(int length, int stages);
+
+private:
+	int length = 0, stages = 0;
+	int frac_bits = 0;
+	double to_fixed = 1, to_double = 1;  // 2^frac_bits y 1 / (2^frac_bits R^N)
+
+	uint64_t integrators[max_stages] = {};
+	std::vector<uint64_t> combs;         // stages * length: entradas anteriores de cada peine
+	uint32_t position = 0;               // Posición común en las líneas de los peines
+
+	bool compensate = false;
+	double alpha = 0;
+	std::vector<double> history;         // 2R + 1 salidas para la compensación
+	uint32_t history_position = 0;
+};
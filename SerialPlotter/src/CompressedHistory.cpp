@@ -0,0 +1,249 @@
+// CompressedHistory.cpp - Compresión delta + empaquetado de bits de los códigos de 8 bits
+
+#include "CompressedHistory.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+
+using clock_type = std::chrono::steady_clock;
+
+void CompressedHistory::Open() {
+    Close();
+    cache.assign(cache_blocks, CacheLine{});
+    open = true;
+}
+
+void CompressedHistory::Close() {
+    open = false;
+    fill = 0;
+    page_used = page_bytes;
+    pages.clear();
+    index.clear();
+    cache.clear();
+    block_count.store(0);
+    compressed_bytes.store(0);
+    encode_seconds.store(0);
+    decoded_samples = 0;
+    decode_seconds = 0;
+}
+
+// Formato de un bloque: [primer valor][bits][(block_samples - 1) diferencias de 'bits' bits]
+// Las diferencias se codifican en zigzag (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...) para que
+// las pequeñas, positivas o negativas, ocupen pocos bits
+uint32_t CompressedHistory::Encode(const uint8_t* values, uint8_t* dst) {
+    uint16_t zigzag[block_samples];
+    uint32_t all = 0;
+    for (uint32_t i = 1; i < block_samples; i++) {
+        int delta = (int)values[i] - (int)values[i - 1];
+        zigzag[i] = (uint16_t)((delta << 1) ^ (delta >> 31));
+        all |= zigzag[i];
+    }
+    uint32_t bits = std::bit_width(all);
+
+    dst[0] = values[0];
+    dst[1] = (uint8_t)bits;
+    uint8_t* p = dst + 2;
+
+    uint64_t acc = 0;
+    uint32_t pending = 0;
+    for (uint32_t i = 1; i < block_samples && bits > 0; i++) {
+        acc |= (uint64_t)zigzag[i] << pending;
+        pending += bits;
+        while (pending >= 8) {
+            *p++ = (uint8_t)acc;
+            acc >>= 8;
+            pending -= 8;
+        }
+    }
+    if (pending > 0)
+        *p++ = (uint8_t)acc;
+
+    return (uint32_t)(p - dst);
+}
+
+const uint8_t* CompressedHistory::Decode(const uint8_t* src, uint8_t* values) {
+    uint8_t previous = src[0];
+    uint32_t bits = src[1];
+    const uint8_t* p = src + 2;
+
+    values[0] = previous;
+    if (bits == 0) {
+        std::memset(values + 1, previous, block_samples - 1);
+        return p;
+    }
+
+    uint32_t mask = (1u << bits) - 1;
+    uint64_t acc = 0;
+    uint32_t available = 0;
+    for (uint32_t i = 1; i < block_samples; i++) {
+        while (available < bits) {
+            acc |= (uint64_t)*p++ << available;
+            available += 8;
+        }
+        uint32_t zigzag = (uint32_t)acc & mask;
+        acc >>= bits;
+        available -= bits;
+        previous += (uint8_t)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+        values[i] = previous;
+    }
+    return p;
+}
+
+void CompressedHistory::EncodeBlock() {
+    auto begin = clock_type::now();
+
+    // Página nueva si el bloque (entrada + salida) podría no entrar en la actual
+    if (page_used + 2 * max_block_bytes > page_bytes) {
+        auto page = std::make_unique<uint8_t[]>(page_bytes);
+        std::lock_guard lock(mutex);
+        pages.push_back(std::move(page));
+        page_used = 0;
+    }
+
+    // Solo el productor modifica 'pages', así que puede leerlo sin el mutex
+    uint8_t* dst = pages.back().get() + page_used;
+    uint32_t size_in = Encode(raw_in, dst);
+    uint32_t size_out = Encode(raw_out, dst + size_in);
+
+    auto [min_in, max_in] = std::minmax_element(raw_in, raw_in + block_samples);
+    auto [min_out, max_out] = std::minmax_element(raw_out, raw_out + block_samples);
+    BlockEntry entry{ dst, (uint16_t)size_in, *min_in, *max_in, *min_out, *max_out };
+    {
+        std::lock_guard lock(mutex);
+        index.push_back(entry);
+        block_count.store((uint32_t)index.size(), std::memory_order_release);
+    }
+
+    page_used += size_in + size_out;
+    compressed_bytes.fetch_add(size_in + size_out, std::memory_order_relaxed);
+    double seconds = std::chrono::duration<double>(clock_type::now() - begin).count();
+    encode_seconds.store(encode_seconds.load(std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+}
+
+const CompressedHistory::CacheLine& CompressedHistory::Decode(uint64_t block) {
+    CacheLine& line = cache[block % cache_blocks];
+    if (line.block == block)
+        return line;
+
+    BlockEntry entry;
+    {
+        std::lock_guard lock(mutex);
+        entry = index[block];
+    }
+
+    // Los bloques cerrados no cambian: se decodifican fuera del mutex
+    auto begin = clock_type::now();
+    Decode(entry.data, line.in);
+    Decode(entry.data + entry.size_in, line.out);
+    decode_seconds += std::chrono::duration<double>(clock_type::now() - begin).count();
+    decoded_samples += block_samples;
+
+    line.block = block;
+    return line;
+}
+
+uint32_t CompressedHistory::Read(uint64_t first, uint32_t count, uint8_t* in, uint8_t* out) {
+    uint64_t size = Size();
+    if (!open || first >= size)
+        return 0;
+    if (count > size - first)
+        count = (uint32_t)(size - first);
+
+    uint32_t copied = 0;
+    while (copied < count) {
+        uint64_t n = first + copied;
+        const CacheLine& line = Decode(n / block_samples);
+        uint32_t offset = (uint32_t)(n % block_samples);
+        uint32_t length = std::min(block_samples - offset, count - copied);
+        if (in)
+            std::memcpy(in + copied, line.in + offset, length);
+        if (out)
+            std::memcpy(out + copied, line.out + offset, length);
+        copied += length;
+    }
+    return copied;
+}
+
+void CompressedHistory::Envelope(uint64_t first, uint64_t last, int pixels, double period,
+                                 std::vector<double>& xs, std::vector<double>& in, std::vector<double>& out) {
+    xs.clear();
+    in.clear();
+    out.clear();
+
+    last = std::min(last, Size());
+    if (!open || first >= last || pixels <= 0)
+        return;
+
+    uint64_t count = last - first;
+    double per_pixel = (double)count / pixels;
+
+    // Pocas muestras por píxel: decodificar el rango (como máximo block_samples * pixels)
+    if (per_pixel < block_samples) {
+        std::vector<uint8_t> raw_in(count), raw_out(count);
+        Read(first, (uint32_t)count, raw_in.data(), raw_out.data());
+
+        if (per_pixel < 2) {
+            for (uint64_t i = 0; i < count; i++) {
+                xs.push_back((first + i) * period);
+                in.push_back(raw_in[i]);
+                out.push_back(raw_out[i]);
+            }
+            return;
+        }
+
+        for (int p = 0; p < pixels; p++) {
+            uint64_t a = (uint64_t)(p * per_pixel), b = std::min<uint64_t>(count, (uint64_t)((p + 1) * per_pixel));
+            if (a >= b)
+                continue;
+            auto [min_in, max_in] = std::minmax_element(raw_in.begin() + a, raw_in.begin() + b);
+            auto [min_out, max_out] = std::minmax_element(raw_out.begin() + a, raw_out.begin() + b);
+            double x = (first + a) * period;
+            xs.insert(xs.end(), { x, x });
+            in.insert(in.end(), { (double)*min_in, (double)*max_in });
+            out.insert(out.end(), { (double)*min_out, (double)*max_out });
+        }
+        return;
+    }
+
+    // Muchas muestras por píxel: combinar los resúmenes del índice (sin descomprimir)
+    std::lock_guard lock(mutex);
+    for (int p = 0; p < pixels; p++) {
+        uint64_t a = first + (uint64_t)(p * per_pixel);
+        uint64_t b = std::min(last, first + (uint64_t)((p + 1) * per_pixel));
+        if (a >= b)
+            continue;
+
+        uint8_t min_in = 255, max_in = 0, min_out = 255, max_out = 0;
+        for (uint64_t block = a / block_samples; block * block_samples < b; block++) {
+            const BlockEntry& entry = index[block];
+            min_in = std::min(min_in, entry.min_in);
+            max_in = std::max(max_in, entry.max_in);
+            min_out = std::min(min_out, entry.min_out);
+            max_out = std::max(max_out, entry.max_out);
+        }
+
+        double x = a * period;
+        xs.insert(xs.end(), { x, x });
+        in.insert(in.end(), { (double)min_in, (double)max_in });
+        out.insert(out.end(), { (double)min_out, (double)max_out });
+    }
+}
+
+CompressionStats CompressedHistory::Stats() const {
+    CompressionStats stats;
+    stats.samples = Size();
+    stats.bytes = compressed_bytes.load(std::memory_order_relaxed);
+    if (stats.bytes > 0) {
+        stats.ratio_codes = 2.0 * stats.samples / stats.bytes;
+        stats.ratio_doubles = 2.0 * sizeof(double) * stats.samples / stats.bytes;
+    }
+
+    double seconds = encode_seconds.load(std::memory_order_relaxed);
+    if (seconds > 0)
+        stats.encode_msps = 2.0 * stats.samples / seconds / 1e6;
+    if (decode_seconds > 0)
+        stats.decode_msps = 2.0 * decoded_samples / decode_seconds / 1e6;
+    return stats;
+}
@@ -0,0 +1,113 @@
+// CompressedHistory.h - Historial comprimido en RAM de los códigos de 8 bits
+//
+// Alternativa al historial en disco: guarda los códigos ADC recibidos y los códigos
+// devueltos al Arduino (un byte por muestra en lugar de un double) comprimidos por
+// bloques de block_samples muestras:
+// - Codificación delta (diferencia con la muestra anterior) con zigzag
+// - Empaquetado de bits al ancho mínimo que necesita el bloque (0 a 9 bits)
+//
+// Las señales lentas (triángulo, seno) usan 1-3 bits por muestra. Cada bloque guarda
+// además su mínimo y máximo, así la envolvente de rangos largos no descomprime nada.
+// Los bloques se descomprimen bajo demanda en una caché pequeña (mapeo directo).
+//
+// Thread-safety:
+// - Un único productor (SerialWorker) llama a Append(); solo toma el mutex al cerrar
+//   un bloque, para agregarlo al índice
+// - Read()/Envelope() se llaman solo desde el hilo de UI (la caché no está protegida)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Métricas de compresión y rendimiento
+struct CompressionStats {
+	uint64_t samples = 0;             // Muestras comprimidas (por canal)
+	uint64_t bytes = 0;               // Bytes ocupados por los bloques comprimidos
+	double ratio_codes = 0;           // Relación frente a guardar un byte por muestra
+	double ratio_doubles = 0;         // Relación frente a guardar doubles (como ScrollBuffer)
+	double encode_msps = 0;           // Velocidad de codificación (millones de muestras/s)
+	double decode_msps = 0;           // Velocidad de decodificación
+};
+
+class CompressedHistory {
+public:
+	static constexpr uint32_t block_samples = 256;         // Muestras por bloque (por canal)
+	static constexpr uint32_t page_bytes = 1 << 20;        // Páginas de 1 MB para los bloques
+	static constexpr uint32_t cache_blocks = 64;           // Bloques decodificados en caché
+	static constexpr uint32_t max_block_bytes = 2 + ((block_samples - 1) * 9 + 7) / 8;
+
+	void Open();
+	void Close();
+	bool IsOpen() const { return open; }
+
+	// Productor: agrega el código recibido y el código enviado de una muestra
+	void Append(uint8_t in, uint8_t out) {
+		if (!open)
+			return;
+
+		raw_in[fill] = in;
+		raw_out[fill] = out;
+		if (++fill == block_samples) {
+			EncodeBlock();
+			fill = 0;
+		}
+	}
+
+	// Muestras disponibles para leer (solo bloques completos)
+	uint64_t Size() const { return (uint64_t)block_count.load(std::memory_order_acquire) * block_samples; }
+
+	// Copia los códigos [first, first + count) en 'in' y/o 'out' (pueden ser nullptr)
+	// Retorna la cantidad de muestras copiadas
+	uint32_t Read(uint64_t first, uint32_t count, uint8_t* in, uint8_t* out);
+
+	// Envolvente min/max de los códigos del rango [first, last) para 'pixels' píxeles
+	// (mismo formato que HistoryStore::Envelope, valores en códigos 0-255)
+	void Envelope(uint64_t first, uint64_t last, int pixels, double period,
+	              std::vector<double>& xs, std::vector<double>& in, std::vector<double>& out);
+
+	CompressionStats Stats() const;
+
+private:
+	// Ubicación y resumen de un bloque comprimido (entrada y salida consecutivas)
+	struct BlockEntry {
+		const uint8_t* data;      // Bloque de entrada; el de salida empieza en data + size_in
+		uint16_t size_in;
+		uint8_t min_in, max_in;
+		uint8_t min_out, max_out;
+	};
+
+	struct CacheLine {
+		uint64_t block = UINT64_MAX;
+		uint8_t in[block_samples];
+		uint8_t out[block_samples];
+	};
+
+	void EncodeBlock();
+	const CacheLine& Decode(uint64_t block);
+
+	static uint32_t Encode(const uint8_t* values, uint8_t* dst);
+	static const uint8_t* Decode(const uint8_t* src, uint8_t* values);
+
+	bool open = false;
+
+	// Estado del productor
+	uint8_t raw_in[block_samples], raw_out[block_samples];
+	uint32_t fill = 0;
+	uint32_t page_used = page_bytes;
+
+	std::vector<std::unique_ptr<uint8_t[]>> pages;
+	std::vector<BlockEntry> index;
+	std::atomic_uint32_t block_count = 0;
+	std::mutex mutex;                          // Protege pages e index
+
+	std::vector<CacheLine> cache;              // Solo hilo de UI
+
+	std::atomic_uint64_t compressed_bytes = 0;
+	std::atomic<double> encode_seconds = 0;
+	uint64_t decoded_samples = 0;
+	double decode_seconds = 0;
+};
@@ -0,0 +1,119 @@
+// Decimator.cpp - Etapas de media banda polifásicas y verificación del rechazo de alias
+
+#include "Decimator.h"
+
+#include <cmath>
+#include <numbers>
+
+using std::numbers::pi;
+
+// Función de Bessel modificada de orden 0 (serie de potencias, para la ventana de Kaiser)
+static double BesselI0(double x) {
+    double sum = 1, term = 1;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-16)
+            break;
+    }
+    return sum;
+}
+
+Decimator::Decimator() {
+    // Media banda: sinc de corte fs/4 con ventana de Kaiser (beta = 8, ~80 dB de rechazo)
+    constexpr double beta = 8;
+    constexpr int half = halfband_taps / 2;
+    for (int i = 0; i <= half / 2; i++) {
+        int n = 2 * i + 1;
+        double ratio = (double)n / half;
+        double window = BesselI0(beta * std::sqrt(1 - ratio * ratio)) / BesselI0(beta);
+        odd[i] = std::sin(pi * n / 2) / (pi * n) * window;
+    }
+}
+
+double Decimator::Response(double f) const {
+    double gain = 1;
+    double rate = input_rate;
+    for (int s = 0; s < stages; s++) {
+        // H(f) = 1/2 + 2 sum h[n] cos(2 pi f n / rate), n impar
+        double h = 0.5;
+        for (int i = 0; i <= halfband_taps / 4; i++)
+            h += 2 * odd[i] * std::cos(2 * pi * f * (2 * i + 1) / rate);
+        gain *= std::fabs(h);
+        rate /= 2;
+    }
+    return gain;
+}
+
+void Decimator::Configure(double rate, double min_rate) {
+    input_rate = rate;
+    stages = 0;
+    while (stages < max_stages && rate / (1 << (stages + 1)) >= min_rate)
+        stages++;
+    Reset();
+
+    // Verificar el rechazo: recorrer 0..fs/2 y medir la ganancia de cada frecuencia que,
+    // al diezmar, se pliega dentro de la banda útil (|f - m fs_salida| <= passband fs_salida)
+    alias_rejection_db = 0;
+    if (stages == 0)
+        return;
+    double output_rate = OutputRate();
+    double worst = 0;
+    constexpr int points = 16384;
+    for (int i = 0; i <= points; i++) {
+        double f = input_rate / 2 * i / points;
+        double folded = std::fmod(f, output_rate);
+        folded = folded > output_rate / 2 ? output_rate - folded : folded;
+        if (f >= output_rate / 2 && folded <= passband * output_rate) {
+            double gain = Response(f);
+            worst = gain > worst ? gain : worst;
+        }
+    }
+    alias_rejection_db = 20 * std::log10(worst > 1e-12 ? worst : 1e-12);
+}
+
+void Decimator::Reset() {
+    for (int s = 0; s < max_stages; s++)
+        lines[s].assign(s < stages ? halfband_taps - 1 : 0, 0.0);
+}
+
+double Decimator::Delay() const {
+    double delay = 0, rate = input_rate;
+    for (int s = 0; s < stages; s++) {
+        delay += (halfband_taps / 2) / rate;
+        rate /= 2;
+    }
+    return delay;
+}
+
+uint32_t Decimator::Process(const double* in, uint32_t count, double* out) {
+    if (stages == 0) {
+        std::copy(in, in + count, out);
+        return count;
+    }
+
+    constexpr int half = halfband_taps / 2;
+    const double* source = in;
+    uint32_t available = count;
+    for (int s = 0; s < stages; s++) {
+        std::vector<double>& line = lines[s];
+        line.insert(line.end(), source, source + available);
+
+        // Cada salida usa una ventana de 'halfband_taps' muestras y avanza dos
+        double* target = s + 1 == stages ? out : (scratch[s & 1].resize(line.size() / 2 + 1), scratch[s & 1].data());
+        uint32_t produced = 0;
+        size_t position = 0;
+        for (; position + halfband_taps <= line.size(); position += 2) {
+            const double* window = &line[position];
+            double y = 0.5 * window[half];
+            for (int i = 0; i <= half / 2; i++)
+                y += odd[i] * (window[half - 2 * i - 1] + window[half + 2 * i + 1]);
+            target[produced++] = y;
+        }
+        line.erase(line.begin(), line.begin() + position);
+
+        source = target;
+        available = produced;
+    }
+    return available;
+}
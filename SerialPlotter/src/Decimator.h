@@ -0,0 +1,61 @@
+// Decimator.h - Diezmado multietapa con filtros de media banda (polifásico)
+//
+// Produce, en paralelo con la señal a frecuencia completa, una señal a fs / 2^k sin
+// aliasing para las bases de tiempo lentas y el espectro de baja frecuencia.
+//
+// Cada etapa es un FIR de media banda (sinc enventanado con Kaiser): la mitad de sus
+// coeficientes son cero y el central vale 1/2, y es simétrico. Se calcula solo en las
+// muestras de salida (una de cada dos entradas), así cada salida cuesta taps / 4
+// multiplicaciones. La cascada de k etapas diezma por 2^k.
+//
+// Banda útil de la salida: 0 a passband * fs_salida. Todo lo que cae ahí por aliasing
+// se atenúa al menos AliasRejectionDb() (calculado sobre la respuesta de la cascada).
+//
+// Thread-safety: una instancia pertenece a un único hilo (el que llama a Process)
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Decimator {
+public:
+	static constexpr int halfband_taps = 47;   // 4 * 12 - 1: 12 coeficientes impares distintos
+	static constexpr int max_stages = 8;       // Hasta diezmar por 256
+	static constexpr double passband = 0.375;  // Banda útil relativa a la frecuencia de salida
+
+	Decimator();
+
+	// Elige la cantidad de etapas: la frecuencia de salida más baja que no baje de min_rate
+	// (ninguna etapa si input_rate < 2 * min_rate). Limpia el estado
+	void Configure(double input_rate, double min_rate);
+
+	void Reset();
+
+	// Diezma 'count' muestras; escribe las salidas en 'out' (hasta count / Factor() + 1)
+	// y retorna cuántas se produjeron
+	uint32_t Process(const double* in, uint32_t count, double* out);
+
+	int Stages() const { return stages; }
+	int Factor() const { return 1 << stages; }
+	double OutputRate() const { return input_rate / Factor(); }
+
+	// Retardo de grupo de la cascada en segundos (para alinear la salida con la entrada)
+	double Delay() const;
+
+	// Peor atenuación (dB, negativa) de las frecuencias que se pliegan sobre la banda útil
+	double AliasRejectionDb() const { return alias_rejection_db; }
+
+	// Ganancia de la cascada a la frecuencia f (Hz, referida a la entrada)
+	double Response(double f) const;
+
+private:
+	// Coeficientes impares h[1], h[3], ... (el resto es cero salvo h[0] = 1/2)
+	double odd[halfband_taps / 4 + 1];
+
+	double input_rate = 0;
+	int stages = 0;
+	std::vector<double> lines[max_stages];  // Historia de cada etapa: [taps - 1 | entradas nuevas]
+	std::vector<double> scratch[2];          // Salidas intermedias entre etapas
+	double alias_rejection_db = 0;
+};
@@ -0,0 +1,241 @@
+// DeviceFilter.cpp - Cuantización, tramas del protocolo y emulación del filtro del dispositivo
+
+#include "DeviceFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+static int16_t QuantizeQ(double v, int fraction, bool& fits) {
+    double q = std::round(std::ldexp(v, fraction));
+    if (q > 32767 || q < -32768) {
+        fits = false;
+        return 0;
+    }
+    return (int16_t)q;
+}
+
+bool QuantizeDesign(const FilterDesign& design, BiquadQ15& out, std::string& error) {
+    if (design.fir) {
+        error = "Los FIR no se cuantizan para el dispositivo";
+        return false;
+    }
+    if (design.sections == 0 || design.sections > BIQUAD_Q15_SECCIONES) {
+        error = "El dispositivo admite de 1 a " + std::to_string(BIQUAD_Q15_SECCIONES) + " secciones (orden 8)";
+        return false;
+    }
+
+    out = {};
+    out.secciones = (uint8_t)design.sections;
+    for (int k = 0; k < design.sections; k++) {
+        const BiquadCoefficients& c = design.coefficients[k];
+        SeccionQ15& s = out.s[k];
+
+        // Mayor desplazamiento con suma de |b| < 1 en Q15: la suma de los tres productos no
+        // desborda antes del desplazamiento. Sin desplazamiento alcanza con que cada b entre
+        double sum = std::fabs(c.b0) + std::fabs(c.b1) + std::fabs(c.b2);
+        int shift = 0;
+        while (shift < 15 && sum > 0 && std::ldexp(sum, BIQUAD_Q15_FRACCION + shift + 1) < 32767)
+            shift++;
+
+        bool fits = true;
+        s.b0 = QuantizeQ(c.b0, BIQUAD_Q15_FRACCION + shift, fits);
+        s.b1 = QuantizeQ(c.b1, BIQUAD_Q15_FRACCION + shift, fits);
+        s.b2 = QuantizeQ(c.b2, BIQUAD_Q15_FRACCION + shift, fits);
+        s.a1 = QuantizeQ(c.a1, BIQUAD_Q15_FRACCION, fits);
+        s.a2 = QuantizeQ(c.a2, BIQUAD_Q15_FRACCION, fits);
+        s.desplazamiento_b = (uint8_t)shift;
+        if (!fits) {
+            error = "La sección " + std::to_string(k + 1) + " tiene coeficientes fuera de [-2, 2)";
+            return false;
+        }
+    }
+    error.clear();
+    return true;
+}
+
+// Misma secuencia que la prueba del dispositivo (LFSR de Galois de 16 bits)
+static uint16_t NextLfsr(uint16_t lfsr) {
+    uint16_t bit = lfsr & 1;
+    lfsr >>= 1;
+    if (bit)
+        lfsr ^= 0xB400;
+    return lfsr;
+}
+
+double QuantizationSnrDb(const FilterDesign& design, const BiquadQ15& filter) {
+    BiquadCascade reference;
+    reference.SetCoefficients(design.coefficients, design.sections);
+    BiquadQ15 fixed = filter;
+    biquad_q15_reiniciar(&fixed);
+
+    // Ruido de +-32 códigos alrededor del centro: margen para filtros con ganancia > 1
+    double signal = 0, noise = 0;
+    uint16_t lfsr = 0xACE1;
+    for (int i = 0; i < 16384; i++) {
+        lfsr = NextLfsr(lfsr);
+        int16_t x = codigo_a_q15((uint8_t)(96 + (lfsr & 63)));
+        double y = reference.Filter(x);
+        double yq = biquad_q15_filtrar(&fixed, x);
+        if (i < 1024)
+            continue;  // Transitorio inicial
+        signal += y * y;
+        noise += (y - yq) * (y - yq);
+    }
+    if (noise == 0)
+        return INFINITY;
+    return 10 * std::log10(signal / noise);
+}
+
+uint16_t EmulateTest(const BiquadQ15& filter, uint16_t seed, uint16_t samples) {
+    PruebaQ15 test;
+    prueba_q15_iniciar(&test, &filter, seed, samples);
+    while (test.restantes)
+        prueba_q15_paso(&test);
+    return test.crc;
+}
+
+static void PutInt16(std::vector<uint8_t>& out, int16_t v) {
+    out.push_back((uint8_t)(v & 255));
+    out.push_back((uint8_t)(((uint16_t)v) >> 8));
+}
+
+std::vector<uint8_t> CoefficientsCommand(const BiquadQ15& filter) {
+    std::vector<uint8_t> out = { 255, 'Q', filter.secciones };
+    for (int k = 0; k < filter.secciones; k++) {
+        const SeccionQ15& s = filter.s[k];
+        PutInt16(out, s.b0);
+        PutInt16(out, s.b1);
+        PutInt16(out, s.b2);
+        PutInt16(out, s.a1);
+        PutInt16(out, s.a2);
+        out.push_back(s.desplazamiento_b);
+    }
+    uint8_t sum = 0;
+    for (size_t i = 2; i < out.size(); i++)
+        sum += out[i];
+    out.push_back(sum);
+    return out;
+}
+
+std::vector<uint8_t> ModeCommand(bool on_device) {
+    return { 255, 'M', (uint8_t)(on_device ? 1 : 0) };
+}
+
+std::vector<uint8_t> TestCommand(uint16_t seed) {
+    return { 255, 'T', (uint8_t)(seed & 255), (uint8_t)(seed >> 8) };
+}
+
+std::vector<uint8_t> StatusCommand() {
+    return { 255, 'S' };
+}
+
+
+// ════════════════════════════════════════════════════════════════════════════════════════
+// DeviceLink
+// ════════════════════════════════════════════════════════════════════════════════════════
+
+void DeviceLink::Send(const std::vector<uint8_t>& command) {
+    std::lock_guard lock(mutex);
+    pending.insert(pending.end(), command.begin(), command.end());
+    enabled.store(true, std::memory_order_release);
+}
+
+void DeviceLink::Upload(const BiquadQ15& filter) {
+    Send(CoefficientsCommand(filter));
+
+    std::lock_guard lock(mutex);
+    if (filter.secciones != emulated.secciones) {
+        emulated = filter;
+        biquad_q15_reiniciar(&emulated);
+        return;
+    }
+    for (int k = 0; k < filter.secciones; k++) {
+        SeccionQ15& s = emulated.s[k];
+        const SeccionQ15& c = filter.s[k];
+        s.b0 = c.b0;
+        s.b1 = c.b1;
+        s.b2 = c.b2;
+        s.a1 = c.a1;
+        s.a2 = c.a2;
+        s.desplazamiento_b = c.desplazamiento_b;
+    }
+}
+
+void DeviceLink::SetOnDevice(bool value) {
+    Send(ModeCommand(value));
+
+    std::lock_guard lock(mutex);
+    if (value && !on_device.load(std::memory_order_relaxed))
+        biquad_q15_reiniciar(&emulated);
+    on_device.store(value, std::memory_order_release);
+}
+
+void DeviceLink::Emulate(const uint8_t* codes, uint32_t count, uint8_t* out) {
+    std::lock_guard lock(mutex);
+    for (uint32_t i = 0; i < count; i++)
+        out[i] = biquad_q15_filtrar_codigo(&emulated, codes[i]);
+}
+
+uint32_t DeviceLink::TakeCommandBytes(uint8_t* out, uint32_t max) {
+    std::lock_guard lock(mutex);
+    uint32_t count = pending.size() < max ? (uint32_t)pending.size() : max;
+    std::copy(pending.begin(), pending.begin() + count, out);
+    pending.erase(pending.begin(), pending.begin() + count);
+    return count;
+}
+
+void DeviceLink::Parse(uint8_t* data, uint32_t count) {
+    if (!enabled.load(std::memory_order_acquire))
+        return;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (frame_size == 0 && data[i] != 255) {
+            last_sample = data[i];
+            continue;
+        }
+        frame[frame_size++] = data[i];
+        data[i] = last_sample;
+        if (frame_size == sizeof(frame)) {
+            Decode();
+            frame_size = 0;
+        }
+    }
+}
+
+void DeviceLink::Decode() {
+    uint16_t a = frame[2] | (frame[3] << 8);
+    uint16_t b = frame[4] | (frame[5] << 8);
+
+    std::lock_guard lock(mutex);
+    switch (frame[1]) {
+    case 'A':
+        status.acks++;
+        status.ack_sections = a & 255;
+        status.ack_ok = (a >> 8) != 0;
+        break;
+    case 'T':
+        status.tests++;
+        status.test_crc = a;
+        status.test_samples = b;
+        break;
+    case 'C':
+        status.cycle_reports++;
+        status.cycles_average = a;
+        status.cycles_max = b;
+        break;
+    }
+}
+
+DeviceStatus DeviceLink::Status() {
+    std::lock_guard lock(mutex);
+    return status;
+}
+
+void DeviceLink::Reset() {
+    std::lock_guard lock(mutex);
+    pending.clear();
+    enabled.store(false, std::memory_order_release);
+    on_device.store(false, std::memory_order_release);
+    frame_size = 0;
+    last_sample = 128;
+}
@@ -0,0 +1,107 @@
+// DeviceFilter.h - Filtro en punto fijo para el dispositivo (AVR) y su emulador exacto
+//
+// Cuantiza un diseño IIR (ver FilterDesign.h) al formato de biquad_q15.h, el mismo
+// archivo que compila el firmware (DSP-arduino/DSP): la emulación en la PC es idéntica
+// bit a bit a lo que calcula el AVR. La igualdad se verifica en el dispositivo con una
+// secuencia pseudoaleatoria: ambos lados calculan el CRC-16 de las salidas.
+//
+// Protocolo (detalle en DSP-arduino/DSP/filtro.h): el byte 255 inicia una trama en
+// ambos sentidos, por eso las muestras van de 0 a 254. Los comandos reemplazan bytes
+// de muestras del DAC (el enlace sigue en un byte por muestra) y las respuestas de 6
+// bytes se reemplazan por la muestra anterior antes de llegar a los buffers.
+//
+// Thread-safety: DeviceLink se usa desde la UI (Send, Status) y SerialWorker
+// (TakeCommandBytes, Parse); las funciones libres no tienen estado
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <biquad_q15.h>
+
+#include "FilterDesign.h"
+
+constexpr uint16_t device_test_samples = 4096;  // Largo de la prueba de igualdad (igual que filtro.h)
+constexpr double device_clock = 16e6;           // Clock del AVR: presupuesto = device_clock / fs ciclos por muestra
+
+// Cuantiza las secciones del diseño: a1, a2 en Q14 y b en Q(14 + desplazamiento_b) con el
+// mayor desplazamiento que no desborde. Retorna false (con el motivo) si el diseño es FIR,
+// tiene más de BIQUAD_Q15_SECCIONES secciones o algún coeficiente no entra en 16 bits
+bool QuantizeDesign(const FilterDesign& design, BiquadQ15& out, std::string& error);
+
+// Relación señal a error (dB) entre la cascada en double y la emulación en punto fijo,
+// con ruido pseudoaleatorio de amplitud moderada (sin saturar)
+double QuantizationSnrDb(const FilterDesign& design, const BiquadQ15& filter);
+
+// CRC de la prueba de igualdad calculado en la PC (mismo código que el dispositivo)
+uint16_t EmulateTest(const BiquadQ15& filter, uint16_t seed, uint16_t samples);
+
+// Tramas PC -> dispositivo
+std::vector<uint8_t> CoefficientsCommand(const BiquadQ15& filter);
+std::vector<uint8_t> ModeCommand(bool on_device);
+std::vector<uint8_t> TestCommand(uint16_t seed);
+std::vector<uint8_t> StatusCommand();
+
+// Últimas respuestas del dispositivo (los contadores cambian con cada respuesta nueva)
+struct DeviceStatus {
+	int acks = 0;
+	int ack_sections = 0;
+	bool ack_ok = false;
+
+	int tests = 0;
+	uint16_t test_crc = 0;
+	int test_samples = 0;
+
+	int cycle_reports = 0;
+	int cycles_average = 0, cycles_max = 0;  // Ciclos de CPU por muestra
+};
+
+class DeviceLink {
+public:
+	// Encola una trama para el próximo lote y activa el reconocimiento de respuestas
+	// (desactivado hasta entonces: firmwares anteriores usan 255 como muestra)
+	void Send(const std::vector<uint8_t>& command);
+
+	// Envía los coeficientes y los copia al emulador, con la misma regla que el
+	// dispositivo: el estado se conserva si no cambia la cantidad de secciones
+	void Upload(const BiquadQ15& filter);
+
+	// Cambia entre el procesado en la PC y el filtro del dispositivo
+	void SetOnDevice(bool on_device);
+	bool OnDevice() const { return on_device.load(std::memory_order_acquire); }
+
+	// Emula el filtro del dispositivo sobre los códigos recibidos (SerialWorker): con el
+	// filtro en el dispositivo es la señal que sale por el DAC (salvo en las muestras que
+	// ocupan las respuestas, donde la PC no ve el ADC)
+	void Emulate(const uint8_t* codes, uint32_t count, uint8_t* out);
+
+	// Copia hasta max bytes de comandos pendientes en out; retorna cuántos
+	uint32_t TakeCommandBytes(uint8_t* out, uint32_t max);
+
+	// Quita las respuestas de los bytes leídos, reemplazándolas por la última muestra
+	void Parse(uint8_t* data, uint32_t count);
+
+	DeviceStatus Status();
+
+	// Nueva sesión: descarta comandos pendientes y respuestas a medio leer
+	void Reset();
+
+private:
+	void Decode();
+
+	std::mutex mutex;
+	std::vector<uint8_t> pending;
+	std::atomic<bool> enabled = false;
+	std::atomic<bool> on_device = false;
+	BiquadQ15 emulated = {};
+	DeviceStatus status;
+
+	// Solo SerialWorker
+	uint8_t frame[6];
+	int frame_size = 0;
+	uint8_t last_sample = 128;
+};
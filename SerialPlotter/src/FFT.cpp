@@ -61,6 +61,11 @@ double magnitude(const fftw_complex complex) {
 // - Para 3840 muestras: ~30 KB entrada + ~31 KB salida = ~61 KB total
 // ════════════════════════════════════════════════════════════════════════════════════════
 
+std::mutex& FftwPlannerMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
 FFT::FFT(int sample_count) :
         samples_size(sample_count),
         amplitudes_size(sample_count / 2 + 1),  // Solo frecuencias positivas (simetría de Hermite)
@@ -72,11 +77,14 @@ FFT::FFT(int sample_count) :
     
     // Crear plan de ejecución optimizado (real → complejo, 1D)
     // FFTW_ESTIMATE: usa heurísticas rápidas sin medir rendimiento
+    std::lock_guard lock(FftwPlannerMutex());
     p = fftw_plan_dft_r2c_1d(sample_count, samples.data(), complex, FFTW_ESTIMATE);
 }
 
 FFT::~FFT()
 {
+    std::lock_guard lock(FftwPlannerMutex());
+    fftw_destroy_plan(p);
     fftw_free(complex);
 }
 
@@ -14,8 +14,13 @@
 #pragma once
 
 #include <fftw3.h>
+#include <mutex>
 #include <vector>
 
+// Crear y destruir planes de FFTW no es seguro entre hilos: todo el programa usa este mutex
+// (FFT en SerialWorker/UI y los kernels FIR en el hilo del diseñador de filtros)
+std::mutex& FftwPlannerMutex();
+
 // Estructura para almacenar información de armónicas detectadas
 struct Harmonic {
 	double frequency;   // Frecuencia en Hz
@@ -39,6 +44,10 @@ public:
 	// Constructor
 	// sample_count: n�mero de muestras a analizar (debe ser potencia de 2 para mejor rendimiento)
 	explicit FFT(int sample_count);
+
+	// El plan apunta a los buffers internos: no se puede copiar ni mover
+	FFT(const FFT&) = delete;
+	FFT& operator=(const FFT&) = delete;
 	
 	~FFT();
 
@@ -63,6 +72,7 @@ public:
 	double Frequency(double sampling_frequency) const;	
 	// Acceso al espectro completo de amplitudes
 	const std::vector<double>& GetAmplitudes() const { return amplitudes; }
+	int GetSamplesSize() const { return samples_size; }
 	int GetAmplitudesSize() const { return amplitudes_size; }
 	
 	// Detección de armónicas (múltiplos de la frecuencia fundamental)
@@ -0,0 +1,180 @@
+// FilterDesign.cpp - Diseño de filtros con iir1 o FIR y publicación desde un hilo propio
+
+#include "FilterDesign.h"
+
+#include <Iir.h>
+#include <chrono>
+#include <stdexcept>
+
+// Copia las secciones de una cascada de iir1 al diseño
+template <typename Filter>
+static void LoadSections(FilterDesign& design, const Filter& filter) {
+    design.sections = filter.getNumStages();
+    for (int i = 0; i < design.sections; i++)
+        design.coefficients[i] = ToCoefficients(filter[i]);
+}
+
+// Diseña un filtro de iir1 con orden variable (las plantillas se instancian con el orden máximo)
+template <typename Filter, typename... Args>
+static void Design(FilterDesign& design, Args... args) {
+    auto filter = std::make_unique<Filter>();
+    filter->setup(args...);
+    LoadSections(design, *filter);
+}
+
+template <template <int> class LowPass, template <int> class HighPass,
+          template <int> class BandPass, template <int> class BandStop, typename... Extra>
+static void DesignFamily(FilterDesign& design, const FilterSpec& spec, double fs, double low, double high, Extra... extra) {
+    constexpr int N = FilterDesign::max_order;
+    int order = spec.order;
+    double center = (low + high) / 2, width = high - low;
+    switch (spec.band) {
+        case FilterBand::LowPass:  Design<LowPass<N>>(design, order, fs, spec.frequency, extra...); break;
+        case FilterBand::HighPass: Design<HighPass<N>>(design, order, fs, spec.frequency, extra...); break;
+        case FilterBand::BandPass: Design<BandPass<N>>(design, order, fs, center, width, extra...); break;
+        case FilterBand::BandStop: Design<BandStop<N>>(design, order, fs, center, width, extra...); break;
+        default: break;
+    }
+}
+
+static void DesignFir(FilterDesign& design, const FilterSpec& spec, double fs, double low, double high) {
+    FirBand band = FirBand::LowPass;
+    switch (spec.band) {
+        case FilterBand::LowPass:  band = FirBand::LowPass; break;
+        case FilterBand::HighPass: band = FirBand::HighPass; break;
+        case FilterBand::BandPass: band = FirBand::BandPass; break;
+        default:                   band = FirBand::BandStop; break;
+    }
+    bool edges = band == FirBand::LowPass || band == FirBand::HighPass;
+    double f1 = edges ? spec.frequency : low, f2 = edges ? 0 : high;
+
+    std::vector<double> taps;
+    if (spec.family == FilterFamily::FirRemez)
+        taps = DesignParksMcClellan(band, spec.taps, fs, f1, f2, spec.transition);
+    // Sin solución de Parks-McClellan (bandas que no caben o rizado por debajo de la precisión)
+    // se usa el diseño por ventana con los mismos coeficientes
+    if (taps.empty()) {
+        design.window_fallback = spec.family == FilterFamily::FirRemez;
+        taps = DesignWindowedSinc(band, spec.taps, fs, f1, f2);
+    }
+    design.fir = PrepareFirKernel(std::move(taps));
+}
+
+std::shared_ptr<const FilterDesign> DesignFilter(const FilterSpec& requested, double sampling_rate) {
+    auto begin = std::chrono::steady_clock::now();
+    auto design = std::make_shared<FilterDesign>();
+    design->sampling_rate = sampling_rate;
+
+    // Ajustar los parámetros al rango válido: frecuencias dentro de (0, Nyquist)
+    FilterSpec spec = requested;
+    double nyquist = sampling_rate / 2;
+    spec.order = spec.order < 1 ? 1 : spec.order > FilterDesign::max_order ? FilterDesign::max_order : spec.order;
+    spec.frequency = spec.frequency < 0.1 ? 0.1 : spec.frequency > nyquist * 0.99 ? nyquist * 0.99 : spec.frequency;
+    spec.width = spec.width < 0.1 ? 0.1 : spec.width;
+    int max_taps = spec.family == FilterFamily::FirRemez ? FilterDesign::max_remez_taps : FilterDesign::max_taps;
+    spec.taps = (spec.taps < 3 ? 3 : spec.taps > max_taps ? max_taps : spec.taps) | 1;
+    spec.transition = spec.transition < 0.1 ? 0.1 : spec.transition;
+    double low = spec.frequency - spec.width / 2, high = spec.frequency + spec.width / 2;
+    low = low < 0.05 ? 0.05 : low;
+    high = high > nyquist * 0.99 ? nyquist * 0.99 : high;
+    design->spec = spec;
+
+    if (spec.band != FilterBand::None && spec.band != FilterBand::Notch && IsFir(spec.family)) {
+        DesignFir(*design, spec, sampling_rate, low, high);
+    }
+    else if (spec.band == FilterBand::Notch) {
+        // Notch RBJ: Q = frecuencia central / ancho de banda
+        Iir::RBJ::IIRNotch notch;
+        notch.setup(sampling_rate, spec.frequency, spec.frequency / spec.width);
+        design->sections = 1;
+        design->coefficients[0] = ToCoefficients(notch);
+    }
+    else if (spec.band != FilterBand::None) {
+        switch (spec.family) {
+            case FilterFamily::Butterworth:
+                DesignFamily<Iir::Butterworth::LowPass, Iir::Butterworth::HighPass,
+                             Iir::Butterworth::BandPass, Iir::Butterworth::BandStop>(*design, spec, sampling_rate, low, high);
+                break;
+            case FilterFamily::ChebyshevI:
+                DesignFamily<Iir::ChebyshevI::LowPass, Iir::ChebyshevI::HighPass,
+                             Iir::ChebyshevI::BandPass, Iir::ChebyshevI::BandStop>(*design, spec, sampling_rate, low, high, spec.ripple_db);
+                break;
+            case FilterFamily::ChebyshevII:
+                DesignFamily<Iir::ChebyshevII::LowPass, Iir::ChebyshevII::HighPass,
+                             Iir::ChebyshevII::BandPass, Iir::ChebyshevII::BandStop>(*design, spec, sampling_rate, low, high, spec.stopband_db);
+                break;
+            default:
+                break;
+        }
+    }
+
+    design->design_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    return design;
+}
+
+FilterDesigner::FilterDesigner() {
+    thread = std::thread(&FilterDesigner::Worker, this);
+}
+
+FilterDesigner::~FilterDesigner() {
+    {
+        std::lock_guard lock(mutex);
+        running = false;
+    }
+    cv.notify_one();
+    thread.join();
+}
+
+void FilterDesigner::Request(const FilterSpec& spec, double sampling_rate) {
+    {
+        std::lock_guard lock(mutex);
+        pending = true;
+        pending_spec = spec;
+        pending_rate = sampling_rate;
+    }
+    cv.notify_one();
+}
+
+void FilterDesigner::Publish(std::shared_ptr<const FilterDesign> design) {
+    std::lock_guard lock(mutex);
+    pending = false;
+    generation++;
+    error.clear();
+    current.store(std::move(design), std::memory_order_release);
+}
+
+std::string FilterDesigner::Error() {
+    std::lock_guard lock(mutex);
+    return error;
+}
+
+void FilterDesigner::Worker() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return pending || !running; });
+        if (!running)
+            return;
+
+        FilterSpec spec = pending_spec;
+        double rate = pending_rate;
+        uint64_t taken = generation;
+        pending = false;
+
+        // El diseño se hace sin el mutex: la UI puede seguir pidiendo diseños mientras tanto
+        lock.unlock();
+        std::shared_ptr<const FilterDesign> design;
+        std::string message;
+        try {
+            design = DesignFilter(spec, rate);
+        }
+        catch (const std::exception& e) {
+            message = e.what();
+        }
+        lock.lock();
+        if (taken != generation)
+            continue;
+        if (design)
+            current.store(design, std::memory_order_release);
+        error = message;
+    }
+}
@@ -0,0 +1,118 @@
+// FilterDesign.h - Diseño de filtros IIR y FIR en tiempo de ejecución
+//
+// Describe un filtro (familia, banda, orden y frecuencias) y lo diseña con iir1,
+// entregando los coeficientes de sus secciones de segundo orden para BiquadCascade,
+// o como FIR de fase lineal (ver Fir.h), entregando un FirKernel para FirFilter.
+//
+// Familias IIR: Butterworth, Chebyshev I y Chebyshev II (iir1 no incluye elípticos ni Bessel)
+// Familias FIR: ventana (Blackman) y Parks-McClellan (el notch es siempre RBJ)
+// Bandas: pasa bajos, pasa altos, pasa banda, rechaza banda y notch (RBJ, una sección)
+//
+// FilterDesigner diseña en un hilo propio: la UI pide un diseño con Request() y el hilo
+// de adquisición toma el último diseño publicado con Current(). Los diseños son
+// inmutables y se publican con un std::atomic<std::shared_ptr>, así SerialWorker nunca
+// ve coeficientes a medio escribir. Cada BiquadCascade que use un diseño tiene su propio
+// estado, de modo que varios filtros pueden correr a la vez.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Biquad.h"
+#include "Fir.h"
+
+enum class FilterFamily {
+	Butterworth,
+	ChebyshevI,   // Rizado en la banda de paso
+	ChebyshevII,  // Rizado en la banda de rechazo
+	FirWindow,    // FIR de fase lineal, sinc enventanado
+	FirRemez      // FIR de fase lineal, equirriple (Parks-McClellan)
+};
+
+inline bool IsFir(FilterFamily family) {
+	return family == FilterFamily::FirWindow || family == FilterFamily::FirRemez;
+}
+
+enum class FilterBand {
+	None,         // Sin filtrado
+	LowPass,
+	HighPass,
+	BandPass,
+	BandStop,
+	Notch         // RBJ, una sola sección (el orden no se usa)
+};
+
+// Parámetros de un filtro editables desde la UI
+struct FilterSpec {
+	FilterBand band = FilterBand::None;
+	FilterFamily family = FilterFamily::Butterworth;
+	int order = 8;              // 1 a max_order
+	double frequency = 20;      // Corte (pasa bajos/altos) o centro (resto) en Hz
+	double width = 10;          // Ancho de banda en Hz (pasa banda, rechaza banda, notch)
+	double ripple_db = 1;       // Chebyshev I: rizado en la banda de paso
+	double stopband_db = 40;    // Chebyshev II: atenuación en la banda de rechazo
+	int taps = 255;             // FIR: cantidad de coeficientes (impar, 3 a max_taps)
+	double transition = 20;     // Parks-McClellan: ancho de cada banda de transición en Hz
+
+	bool operator==(const FilterSpec&) const = default;
+};
+
+// Resultado inmutable de un diseño
+struct FilterDesign {
+	static constexpr int max_order = 16;
+	static constexpr int max_taps = 8191;        // Ventana
+	static constexpr int max_remez_taps = 1023;  // Parks-McClellan (más allá la interpolación pierde precisión)
+
+	FilterSpec spec;
+	double sampling_rate = 0;
+	int sections = 0;
+	BiquadCoefficients coefficients[BiquadCascade::max_sections];
+	std::shared_ptr<const FirKernel> fir;  // Solo familias FIR (sections = 0)
+	bool window_fallback = false;          // Parks-McClellan sin solución: se usó el diseño por ventana
+	double design_us = 0;       // Tiempo que tomó el diseño (incluye la medición del método FIR)
+};
+
+// Diseña el filtro con iir1 o como FIR (las frecuencias se ajustan al rango válido para la
+// frecuencia de muestreo). Lanza std::exception si iir1 rechaza los parámetros.
+std::shared_ptr<const FilterDesign> DesignFilter(const FilterSpec& spec, double sampling_rate);
+
+class FilterDesigner {
+public:
+	FilterDesigner();
+	~FilterDesigner();
+
+	// Pide un diseño nuevo (si hay uno pendiente se reemplaza: solo importa el último)
+	void Request(const FilterSpec& spec, double sampling_rate);
+
+	// Publica un diseño ya hecho (p. ej. un candidato promovido) y descarta el pedido pendiente;
+	// un diseño que el hilo esté calculando en ese momento ya no se publica
+	void Publish(std::shared_ptr<const FilterDesign> design);
+
+	// Último diseño publicado (nullptr si todavía no hay ninguno)
+	std::shared_ptr<const FilterDesign> Current() const {
+		return current.load(std::memory_order_acquire);
+	}
+
+	// Mensaje del último diseño rechazado (vacío si el último fue válido)
+	std::string Error();
+
+private:
+	void Worker();
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool running = true;
+	bool pending = false;
+	uint64_t generation = 0;    // Aumenta con cada Publish(): invalida el diseño en curso
+	FilterSpec pending_spec;
+	double pending_rate = 0;
+	std::string error;
+
+	std::atomic<std::shared_ptr<const FilterDesign>> current;
+};
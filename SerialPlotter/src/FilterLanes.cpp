@@ -0,0 +1,221 @@
+// FilterLanes.cpp - Banco de candidatos: un diseño por carril, escalar y AVX2
+
+#include "FilterLanes.h"
+
+#include <chrono>
+
+#include "Simd.h"
+
+void FilterLanes::Configure(std::shared_ptr<const Candidates> candidates) {
+    // El anillo se reserva aquí (UI) antes de publicar: SerialWorker lo ve al tomar los candidatos
+    if (candidates && traces.empty())
+        traces.assign((size_t)max_lanes * trace_capacity, 0.0);
+    pending.store(std::move(candidates), std::memory_order_release);
+}
+
+void FilterLanes::Reset() {
+    applied = nullptr;
+    lanes = sections = 0;
+    written.store(0, std::memory_order_release);
+    published_origin.store(0, std::memory_order_relaxed);
+    published_lanes.store(0, std::memory_order_relaxed);
+    ns.store(0, std::memory_order_relaxed);
+    promotion.store(-1, std::memory_order_relaxed);
+}
+
+std::shared_ptr<const FilterDesign> FilterLanes::Design(int lane) const {
+    return applied && lane >= 0 && lane < lanes ? applied->designs[lane] : nullptr;
+}
+
+void FilterLanes::State(int lane, double* state1, double* state2) const {
+    for (int k = 0; k < sections; k++) {
+        state1[k] = s1[k][lane];
+        state2[k] = s2[k][lane];
+    }
+}
+
+void FilterLanes::Apply(const std::shared_ptr<const Candidates>& next) {
+    int previous_lanes = lanes;
+    int next_lanes = next ? (next->count < max_lanes ? next->count : max_lanes) : 0;
+
+    // La cantidad de secciones del banco es la del candidato más largo
+    int next_sections = 0;
+    for (int lane = 0; lane < next_lanes; lane++) {
+        const FilterDesign* design = next->designs[lane].get();
+        if (design && !design->fir && design->sections > next_sections)
+            next_sections = design->sections;
+    }
+
+    for (int lane = 0; lane < max_lanes; lane++) {
+        const FilterDesign* before = applied && lane < previous_lanes ? applied->designs[lane].get() : nullptr;
+        const FilterDesign* after = lane < next_lanes ? next->designs[lane].get() : nullptr;
+        int count = after && !after->fir ? after->sections : 0;
+
+        // Misma estructura: conservar el estado; si no, arrancar en régimen en el próximo lote
+        bool keep = before && after && !before->fir && before->sections == count;
+        for (int k = 0; k < BiquadCascade::max_sections; k++) {
+            const BiquadCoefficients identity = { 1, 0, 0, 0, 0 };
+            const BiquadCoefficients& c = k < count ? after->coefficients[k] : identity;
+            b0[k][lane] = c.b0;
+            b1[k][lane] = c.b1;
+            b2[k][lane] = c.b2;
+            a1[k][lane] = c.a1;
+            a2[k][lane] = c.a2;
+            if (!keep)
+                s1[k][lane] = s2[k][lane] = 0;
+        }
+        prime[lane] = !keep && count > 0;
+    }
+
+    // Al activar la comparación el anillo empieza en la muestra actual
+    if (previous_lanes == 0 && next_lanes > 0)
+        published_origin.store(written.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    applied = next;
+    lanes = next_lanes;
+    sections = next_sections;
+    published_lanes.store(lanes, std::memory_order_relaxed);
+}
+
+void FilterLanes::Process(const double* in, uint32_t count, uint64_t first_index) {
+    auto next = pending.load(std::memory_order_acquire);
+    if (next != applied)
+        Apply(next);
+
+    // Sin candidatos el anillo sigue el índice de la sesión (para alinear la próxima activación)
+    if (lanes == 0 || count == 0) {
+        written.store(first_index + count, std::memory_order_release);
+        return;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+
+    // Estado de régimen para la primera muestra (igual que BiquadCascade::Prime)
+    for (int lane = 0; lane < lanes; lane++) {
+        if (!prime[lane])
+            continue;
+        double x = in[0];
+        for (int k = 0; k < sections; k++) {
+            double denom = 1 + a1[k][lane] + a2[k][lane];
+            double y = denom != 0 ? (b0[k][lane] + b1[k][lane] + b2[k][lane]) / denom * x : 0;
+            s2[k][lane] = b2[k][lane] * x - a2[k][lane] * y;
+            s1[k][lane] = b1[k][lane] * x - a1[k][lane] * y + s2[k][lane];
+            x = y;
+        }
+        prime[lane] = false;
+    }
+
+    if (work.size() < (size_t)count * max_lanes)
+        work.resize((size_t)count * max_lanes);
+    if (CpuHasAvx2())
+        ProcessAvx2(in, count);
+    else
+        ProcessScalar(in, count);
+
+    // Copiar al anillo de cada carril (el índice global decide la posición)
+    for (int lane = 0; lane < lanes; lane++) {
+        double* trace = traces.data() + (size_t)lane * trace_capacity;
+        for (uint32_t n = 0; n < count; n++)
+            trace[(first_index + n) & (trace_capacity - 1)] = work[(size_t)n * max_lanes + lane];
+    }
+    written.store(first_index + count, std::memory_order_release);
+
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / count;
+    ns.store(ns.load(std::memory_order_relaxed) * 0.99 + elapsed * 0.01, std::memory_order_relaxed);
+}
+
+void FilterLanes::ProcessScalar(const double* in, uint32_t count) {
+    for (int lane = 0; lane < lanes; lane++) {
+        for (uint32_t n = 0; n < count; n++)
+            work[(size_t)n * max_lanes + lane] = in[n];
+        for (int k = 0; k < sections; k++) {
+            const double c_b0 = b0[k][lane], c_b1 = b1[k][lane], c_b2 = b2[k][lane], c_a1 = a1[k][lane], c_a2 = a2[k][lane];
+            double z1 = s1[k][lane], z2 = s2[k][lane];
+            for (uint32_t n = 0; n < count; n++) {
+                double& value = work[(size_t)n * max_lanes + lane];
+                double x = value;
+                double y = c_b0 * x + z1;
+                z1 = c_b1 * x - c_a1 * y + z2;
+                z2 = c_b2 * x - c_a2 * y;
+                value = y;
+            }
+            s1[k][lane] = z1;
+            s2[k][lane] = z2;
+        }
+    }
+}
+
+// Una sección de cuatro carriles sobre una muestra (forma directa II transpuesta)
+SIMD_TARGET_AVX2 static inline void SectionStep(const double* b0, const double* b1, const double* b2, const double* a1,
+                                                const double* a2, __m256d& z1, __m256d& z2, double* value) {
+    __m256d x = _mm256_loadu_pd(value);
+    __m256d y = _mm256_fmadd_pd(_mm256_load_pd(b0), x, z1);
+    z1 = _mm256_fmadd_pd(_mm256_load_pd(b1), x, _mm256_fnmadd_pd(_mm256_load_pd(a1), y, z2));
+    z2 = _mm256_fnmadd_pd(_mm256_load_pd(a2), y, _mm256_mul_pd(_mm256_load_pd(b2), x));
+    _mm256_storeu_pd(value, y);
+}
+
+// Cuatro candidatos por registro. La recursión de una sección encadena ~12 ciclos por muestra,
+// así que las secciones se procesan de a cuatro en pipeline (en el paso t la sección j del
+// grupo toma la muestra t - j): hay cuatro cadenas independientes en vuelo, como en
+// BiquadCascade::ProcessGroupAvx2. Las secciones que sobran hasta múltiplo de 4 son identidad.
+SIMD_TARGET_AVX2 void FilterLanes::ProcessAvx2(const double* in, uint32_t count) {
+    for (int group = 0; group < lanes; group += 4) {
+        double* out = work.data() + group;
+        for (uint32_t n = 0; n < count; n++)
+            _mm256_storeu_pd(out + (size_t)n * max_lanes, _mm256_set1_pd(in[n]));
+
+        for (int k = 0; k < sections; k += 4) {
+            __m256d z1_0 = _mm256_load_pd(&s1[k][group]), z2_0 = _mm256_load_pd(&s2[k][group]);
+            __m256d z1_1 = _mm256_load_pd(&s1[k + 1][group]), z2_1 = _mm256_load_pd(&s2[k + 1][group]);
+            __m256d z1_2 = _mm256_load_pd(&s1[k + 2][group]), z2_2 = _mm256_load_pd(&s2[k + 2][group]);
+            __m256d z1_3 = _mm256_load_pd(&s1[k + 3][group]), z2_3 = _mm256_load_pd(&s2[k + 3][group]);
+
+            for (uint32_t t = 0; t < count + 3; t++) {
+                if (t < count)
+                    SectionStep(b0[k] + group, b1[k] + group, b2[k] + group, a1[k] + group,
+                                a2[k] + group, z1_0, z2_0, out + (size_t)t * max_lanes);
+                if (t >= 1 && t - 1 < count)
+                    SectionStep(b0[k + 1] + group, b1[k + 1] + group, b2[k + 1] + group, a1[k + 1] + group,
+                                a2[k + 1] + group, z1_1, z2_1, out + (size_t)(t - 1) * max_lanes);
+                if (t >= 2 && t - 2 < count)
+                    SectionStep(b0[k + 2] + group, b1[k + 2] + group, b2[k + 2] + group, a1[k + 2] + group,
+                                a2[k + 2] + group, z1_2, z2_2, out + (size_t)(t - 2) * max_lanes);
+                if (t >= 3)
+                    SectionStep(b0[k + 3] + group, b1[k + 3] + group, b2[k + 3] + group, a1[k + 3] + group,
+                                a2[k + 3] + group, z1_3, z2_3, out + (size_t)(t - 3) * max_lanes);
+            }
+
+            _mm256_store_pd(&s1[k][group], z1_0);
+            _mm256_store_pd(&s2[k][group], z2_0);
+            _mm256_store_pd(&s1[k + 1][group], z1_1);
+            _mm256_store_pd(&s2[k + 1][group], z2_1);
+            _mm256_store_pd(&s1[k + 2][group], z1_2);
+            _mm256_store_pd(&s2[k + 2][group], z2_2);
+            _mm256_store_pd(&s1[k + 3][group], z1_3);
+            _mm256_store_pd(&s2[k + 3][group], z2_3);
+        }
+    }
+}
+
+uint32_t FilterLanes::Read(int lane, uint32_t count, double* out, uint64_t& first_index) const {
+    if (lane < 0 || lane >= Lanes() || traces.empty())
+        return 0;
+
+    // Solo la mitad del anillo: los lotes (hasta trace_capacity / 2) no alcanzan el tramo copiado
+    uint64_t end = written.load(std::memory_order_acquire);
+    uint64_t first = published_origin.load(std::memory_order_relaxed);
+    if (end > first + trace_capacity / 2)
+        first = end - trace_capacity / 2;
+    if (end - first > count)
+        first = end - count;
+
+    const double* trace = traces.data() + (size_t)lane * trace_capacity;
+    for (uint64_t i = first; i < end; i++)
+        out[i - first] = trace[i & (trace_capacity - 1)];
+
+    if (written.load(std::memory_order_acquire) - first > trace_capacity / 2)
+        return 0;
+    first_index = first;
+    return (uint32_t)(end - first);
+}
@@ -0,0 +1,95 @@
+// FilterLanes.h - Filtros candidatos en paralelo sobre la misma entrada (un carril SIMD cada uno)
+//
+// Para elegir un corte o un orden se corren hasta max_lanes diseños IIR a la vez sobre la
+// entrada de la etapa Filtro. Cada candidato ocupa un carril de un registro AVX2: una
+// sección de los cuatro candidatos de un grupo cuesta lo mismo que una sección escalar.
+// Los candidatos con menos secciones se completan con secciones identidad.
+//
+// Características:
+// - Al cambiar un candidato con la misma cantidad de secciones se conserva su estado; si
+//   cambia la estructura arranca en régimen con la primera muestra del lote (como LiveFilter)
+// - Las salidas recientes de cada carril quedan en un anillo de trace_capacity muestras,
+//   indexadas por el número de muestra desde el inicio de la sesión
+// - Un carril puede promoverse al filtro vivo con su estado (ver LiveFilter::Adopt): la
+//   salida sigue sin transitorio
+//
+// Thread-safety: la UI publica candidatos con Configure() y pide promociones con Promote();
+// SerialWorker procesa. Read() copia del anillo sin bloquear y detecta si la escritura
+// alcanzó el tramo copiado (mismo criterio que ViewPublisher).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Biquad.h"
+#include "FilterDesign.h"
+
+class FilterLanes {
+public:
+	static constexpr int max_lanes = 8;
+	static constexpr uint32_t trace_capacity = 1 << 17;  // Muestras por carril (potencia de 2)
+
+	// Conjunto inmutable de candidatos (solo IIR; los nulos quedan como carriles sin filtro)
+	struct Candidates {
+		std::shared_ptr<const FilterDesign> designs[max_lanes];
+		int count = 0;
+	};
+
+	// UI: publica los candidatos (nullptr desactiva la comparación)
+	void Configure(std::shared_ptr<const Candidates> candidates);
+
+	// UI: pide promover un carril al filtro vivo en el próximo lote
+	void Promote(int lane) { promotion.store(lane, std::memory_order_release); }
+
+	// SerialWorker: descarta el estado y las salidas (inicio de sesión)
+	void Reset();
+
+	// SerialWorker: filtra el lote con todos los candidatos; first_index es el número de la
+	// primera muestra desde el inicio de la sesión
+	void Process(const double* in, uint32_t count, uint64_t first_index);
+
+	bool Active() const { return lanes > 0; }
+
+	// SerialWorker: carril pedido para promover (-1 si no hay) y su diseño y estado
+	int TakePromotion() { return promotion.exchange(-1, std::memory_order_acq_rel); }
+	std::shared_ptr<const FilterDesign> Design(int lane) const;
+	void State(int lane, double* s1, double* s2) const;
+
+	// UI: copia las últimas 'count' salidas del carril; first_index recibe el número de la
+	// primera. Retorna la cantidad copiada (0 si no hay datos o la escritura alcanzó la copia)
+	uint32_t Read(int lane, uint32_t count, double* out, uint64_t& first_index) const;
+
+	// UI: candidatos aplicados y costo del banco completo (ns por muestra, promedio exponencial)
+	int Lanes() const { return published_lanes.load(std::memory_order_relaxed); }
+	double Ns() const { return ns.load(std::memory_order_relaxed); }
+
+private:
+	void Apply(const std::shared_ptr<const Candidates>& next);
+	void ProcessScalar(const double* in, uint32_t count);
+	void ProcessAvx2(const double* in, uint32_t count);
+
+	std::atomic<std::shared_ptr<const Candidates>> pending;
+	std::atomic<int> promotion = -1;
+
+	// Solo SerialWorker
+	std::shared_ptr<const Candidates> applied;
+	int lanes = 0, sections = 0;
+	bool prime[max_lanes] = {};
+
+	// Coeficientes y estado por sección y carril: una fila de max_lanes por sección
+	alignas(32) double b0[BiquadCascade::max_sections][max_lanes], b1[BiquadCascade::max_sections][max_lanes];
+	alignas(32) double b2[BiquadCascade::max_sections][max_lanes], a1[BiquadCascade::max_sections][max_lanes];
+	alignas(32) double a2[BiquadCascade::max_sections][max_lanes];
+	alignas(32) double s1[BiquadCascade::max_sections][max_lanes] = {}, s2[BiquadCascade::max_sections][max_lanes] = {};
+	std::vector<double> work;    // Salidas del lote intercaladas: [muestra][carril]
+
+	// Anillo de salidas por carril: [carril][trace_capacity]
+	std::vector<double> traces;  // Reservado por la UI en el primer Configure()
+	std::atomic<uint64_t> written = 0;  // Muestras escritas en el anillo (índice global de la próxima)
+	std::atomic<uint64_t> published_origin = 0;  // Índice global de la primera muestra del anillo
+	std::atomic<int> published_lanes = 0;
+	std::atomic<double> ns = 0;
+};
@@ -0,0 +1,187 @@
+// FilterResponse.cpp - Evaluación de la respuesta en frecuencia (escalar y AVX2)
+
+#include "FilterResponse.h"
+
+#include <chrono>
+#include <cmath>
+#include <numbers>
+
+#include "Simd.h"
+
+using std::numbers::pi;
+
+// Evita dividir por cero en los ceros exactos sobre la circunferencia (notch, Nyquist)
+static constexpr double tiny = 1e-300;
+
+void FilterResponse::SetGrid(double sampling_rate) {
+    rate = sampling_rate;
+    frequency.resize(points);
+    cos1.resize(points);
+    sin1.resize(points);
+    cos2.resize(points);
+    sin2.resize(points);
+    real.resize(points);
+    imag.resize(points);
+    delay.resize(points);
+    magnitude_db.resize(points);
+    phase_deg.resize(points);
+    delay_ms.resize(points);
+
+    double low = 0.1, high = sampling_rate / 2;
+    if (low >= high)
+        low = high / 1000;
+    double ratio = std::log(high / low) / (points - 1);
+    for (int i = 0; i < points; i++) {
+        frequency[i] = low * std::exp(ratio * i);
+        double w = 2 * pi * frequency[i] / sampling_rate;
+        cos1[i] = std::cos(w);
+        sin1[i] = std::sin(w);
+        cos2[i] = std::cos(2 * w);
+        sin2[i] = std::sin(2 * w);
+    }
+}
+
+void FilterResponse::Compute(const BiquadCoefficients* sections, int count, const std::vector<double>* fir,
+                             double gain, double sampling_rate) {
+    auto begin = std::chrono::steady_clock::now();
+    if (sampling_rate != rate)
+        SetGrid(sampling_rate);
+
+    if (CpuHasAvx2())
+        ComputeAvx2(sections, count, fir);
+    else
+        ComputeScalar(sections, count, fir);
+    Finish(gain);
+    compute_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void FilterResponse::ComputeScalar(const BiquadCoefficients* sections, int count, const std::vector<double>* fir) {
+    for (int i = 0; i < points; i++) {
+        double c1 = cos1[i], s1 = sin1[i], c2 = cos2[i], s2 = sin2[i];
+        double hr = 1, hi = 0, tau = 0;
+
+        for (int k = 0; k < count; k++) {
+            const BiquadCoefficients& c = sections[k];
+            // N = b0 + b1 z^-1 + b2 z^-2, D = 1 + a1 z^-1 + a2 z^-2, con z^-1 = cos w - j sin w
+            double nr = c.b0 + c.b1 * c1 + c.b2 * c2, ni = -(c.b1 * s1 + c.b2 * s2);
+            double dr = 1 + c.a1 * c1 + c.a2 * c2, di = -(c.a1 * s1 + c.a2 * s2);
+            double qnr = c.b1 * c1 + 2 * c.b2 * c2, qni = -(c.b1 * s1 + 2 * c.b2 * s2);
+            double qdr = c.a1 * c1 + 2 * c.a2 * c2, qdi = -(c.a1 * s1 + 2 * c.a2 * s2);
+            double nn = nr * nr + ni * ni + tiny, dd = dr * dr + di * di + tiny;
+            tau += (qnr * nr + qni * ni) / nn - (qdr * dr + qdi * di) / dd;
+
+            // H *= N / D = N conj(D) / |D|^2
+            double tr = hr * nr - hi * ni, ti = hr * ni + hi * nr;
+            hr = (tr * dr + ti * di) / dd;
+            hi = (ti * dr - tr * di) / dd;
+        }
+
+        if (fir && !fir->empty()) {
+            // Horner sobre z^-1 = (c1, -s1): P = sum h_k z^-k y dP para Q = sum k h_k z^-k
+            const std::vector<double>& h = *fir;
+            double pr = h.back(), pi_ = 0, dpr = 0, dpi = 0;
+            for (size_t k = h.size() - 1; k-- > 0;) {
+                double ndr = dpr * c1 + dpi * s1 + pr, ndi = dpi * c1 - dpr * s1 + pi_;
+                dpr = ndr;
+                dpi = ndi;
+                double npr = pr * c1 + pi_ * s1 + h[k], npi = pi_ * c1 - pr * s1;
+                pr = npr;
+                pi_ = npi;
+            }
+            // Q = z^-1 dP
+            double qr = dpr * c1 + dpi * s1, qi = dpi * c1 - dpr * s1;
+            tau += (qr * pr + qi * pi_) / (pr * pr + pi_ * pi_ + tiny);
+            double tr = hr * pr - hi * pi_, ti = hr * pi_ + hi * pr;
+            hr = tr;
+            hi = ti;
+        }
+
+        real[i] = hr;
+        imag[i] = hi;
+        delay[i] = tau;
+    }
+}
+
+SIMD_TARGET_AVX2 void FilterResponse::ComputeAvx2(const BiquadCoefficients* sections, int count, const std::vector<double>* fir) {
+    const __m256d one = _mm256_set1_pd(1), two = _mm256_set1_pd(2), v_tiny = _mm256_set1_pd(tiny);
+    const __m256d zero = _mm256_setzero_pd();
+
+    for (int i = 0; i < points; i += 4) {
+        __m256d c1 = _mm256_loadu_pd(&cos1[i]), s1 = _mm256_loadu_pd(&sin1[i]);
+        __m256d c2 = _mm256_loadu_pd(&cos2[i]), s2 = _mm256_loadu_pd(&sin2[i]);
+        __m256d hr = one, hi = zero, tau = zero;
+
+        for (int k = 0; k < count; k++) {
+            const BiquadCoefficients& c = sections[k];
+            __m256d b0 = _mm256_set1_pd(c.b0), b1 = _mm256_set1_pd(c.b1), b2 = _mm256_set1_pd(c.b2);
+            __m256d a1 = _mm256_set1_pd(c.a1), a2 = _mm256_set1_pd(c.a2);
+            __m256d b2x2 = _mm256_mul_pd(two, b2), a2x2 = _mm256_mul_pd(two, a2);
+
+            __m256d nr = _mm256_fmadd_pd(b2, c2, _mm256_fmadd_pd(b1, c1, b0));
+            __m256d ni = _mm256_sub_pd(zero, _mm256_fmadd_pd(b2, s2, _mm256_mul_pd(b1, s1)));
+            __m256d dr = _mm256_fmadd_pd(a2, c2, _mm256_fmadd_pd(a1, c1, one));
+            __m256d di = _mm256_sub_pd(zero, _mm256_fmadd_pd(a2, s2, _mm256_mul_pd(a1, s1)));
+            __m256d qnr = _mm256_fmadd_pd(b2x2, c2, _mm256_mul_pd(b1, c1));
+            __m256d qni = _mm256_sub_pd(zero, _mm256_fmadd_pd(b2x2, s2, _mm256_mul_pd(b1, s1)));
+            __m256d qdr = _mm256_fmadd_pd(a2x2, c2, _mm256_mul_pd(a1, c1));
+            __m256d qdi = _mm256_sub_pd(zero, _mm256_fmadd_pd(a2x2, s2, _mm256_mul_pd(a1, s1)));
+
+            __m256d nn = _mm256_add_pd(_mm256_fmadd_pd(nr, nr, _mm256_mul_pd(ni, ni)), v_tiny);
+            __m256d dd = _mm256_add_pd(_mm256_fmadd_pd(dr, dr, _mm256_mul_pd(di, di)), v_tiny);
+            __m256d tn = _mm256_div_pd(_mm256_fmadd_pd(qnr, nr, _mm256_mul_pd(qni, ni)), nn);
+            __m256d td = _mm256_div_pd(_mm256_fmadd_pd(qdr, dr, _mm256_mul_pd(qdi, di)), dd);
+            tau = _mm256_add_pd(tau, _mm256_sub_pd(tn, td));
+
+            __m256d tr = _mm256_fmsub_pd(hr, nr, _mm256_mul_pd(hi, ni));
+            __m256d ti = _mm256_fmadd_pd(hr, ni, _mm256_mul_pd(hi, nr));
+            __m256d inv = _mm256_div_pd(one, dd);
+            hr = _mm256_mul_pd(_mm256_fmadd_pd(tr, dr, _mm256_mul_pd(ti, di)), inv);
+            hi = _mm256_mul_pd(_mm256_fmsub_pd(ti, dr, _mm256_mul_pd(tr, di)), inv);
+        }
+
+        if (fir && !fir->empty()) {
+            const std::vector<double>& h = *fir;
+            __m256d pr = _mm256_set1_pd(h.back()), pi_ = zero, dpr = zero, dpi = zero;
+            for (size_t k = h.size() - 1; k-- > 0;) {
+                __m256d ndr = _mm256_add_pd(_mm256_fmadd_pd(dpr, c1, _mm256_mul_pd(dpi, s1)), pr);
+                __m256d ndi = _mm256_add_pd(_mm256_fmsub_pd(dpi, c1, _mm256_mul_pd(dpr, s1)), pi_);
+                dpr = ndr;
+                dpi = ndi;
+                __m256d npr = _mm256_add_pd(_mm256_fmadd_pd(pr, c1, _mm256_mul_pd(pi_, s1)), _mm256_set1_pd(h[k]));
+                __m256d npi = _mm256_fmsub_pd(pi_, c1, _mm256_mul_pd(pr, s1));
+                pr = npr;
+                pi_ = npi;
+            }
+            __m256d qr = _mm256_fmadd_pd(dpr, c1, _mm256_mul_pd(dpi, s1));
+            __m256d qi = _mm256_fmsub_pd(dpi, c1, _mm256_mul_pd(dpr, s1));
+            __m256d pp = _mm256_add_pd(_mm256_fmadd_pd(pr, pr, _mm256_mul_pd(pi_, pi_)), v_tiny);
+            tau = _mm256_add_pd(tau, _mm256_div_pd(_mm256_fmadd_pd(qr, pr, _mm256_mul_pd(qi, pi_)), pp));
+            __m256d tr = _mm256_fmsub_pd(hr, pr, _mm256_mul_pd(hi, pi_));
+            __m256d ti = _mm256_fmadd_pd(hr, pi_, _mm256_mul_pd(hi, pr));
+            hr = tr;
+            hi = ti;
+        }
+
+        _mm256_storeu_pd(&real[i], hr);
+        _mm256_storeu_pd(&imag[i], hi);
+        _mm256_storeu_pd(&delay[i], tau);
+    }
+}
+
+void FilterResponse::Finish(double gain) {
+    double previous = 0, offset = 0;
+    for (int i = 0; i < points; i++) {
+        double power = (real[i] * real[i] + imag[i] * imag[i]) * gain * gain;
+        magnitude_db[i] = 10 * std::log10(power + tiny);
+
+        // Fase desenvuelta a lo largo de la grilla (el signo de la ganancia suma 180°)
+        double phase = std::atan2(imag[i], real[i]) + (gain < 0 ? pi : 0);
+        if (i > 0) {
+            double step = phase + offset - previous;
+            offset -= 2 * pi * std::round(step / (2 * pi));
+        }
+        previous = phase + offset;
+        phase_deg[i] = previous * 180 / pi;
+        delay_ms[i] = delay[i] / rate * 1000;
+    }
+}
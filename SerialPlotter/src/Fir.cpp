@@ -0,0 +1,626 @@
+// Fir.cpp - Diseño (ventana y Parks-McClellan) y ejecución (directa y overlap-save) de FIR
+
+#include "Fir.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+#include "FFT.h"
+#include "Simd.h"
+
+using std::numbers::pi;
+
+// ════════════════════════════════════════════════════════════════════════════════════════
+// DISEÑO
+// ════════════════════════════════════════════════════════════════════════════════════════
+
+// Pasa bajos ideal de frecuencia de corte 'fc' (ciclos/muestra) centrado en 'middle'
+static double IdealLowPass(int n, int middle, double fc) {
+    int m = n - middle;
+    return m == 0 ? 2 * fc : std::sin(2 * pi * fc * m) / (pi * m);
+}
+
+std::vector<double> DesignWindowedSinc(FirBand band, int taps, double fs, double f1, double f2) {
+    taps |= 1;  // Longitud impar: tipo I, válido también para pasa altos y rechaza banda
+    int middle = taps / 2;
+    double c1 = f1 / fs, c2 = f2 / fs;
+
+    std::vector<double> h(taps);
+    for (int n = 0; n < taps; n++) {
+        double delta = n == middle ? 1 : 0;
+        switch (band) {
+            case FirBand::LowPass:  h[n] = IdealLowPass(n, middle, c1); break;
+            case FirBand::HighPass: h[n] = delta - IdealLowPass(n, middle, c1); break;
+            case FirBand::BandPass: h[n] = IdealLowPass(n, middle, c2) - IdealLowPass(n, middle, c1); break;
+            case FirBand::BandStop: h[n] = delta - IdealLowPass(n, middle, c2) + IdealLowPass(n, middle, c1); break;
+        }
+
+        // Ventana de Blackman: lóbulos laterales a -58 dB
+        double w = taps > 1 ? 2 * pi * n / (taps - 1) : 0;
+        h[n] *= 0.42 - 0.5 * std::cos(w) + 0.08 * std::cos(2 * w);
+    }
+    return h;
+}
+
+// ─── Parks-McClellan ─────────────────────────────────────────────────────────────────────
+//
+// Aproxima la respuesta deseada D(f) por bandas con A(f) = sum a_k cos(2 pi k f), minimizando
+// el error máximo ponderado. En cada iteración:
+// 1. Con r + 1 frecuencias extremas calcula el error de alternancia delta (fórmula baricéntrica)
+// 2. Evalúa el error E(f) = W(f) (D(f) - A(f)) en una grilla densa
+// 3. Toma como nuevas extremas los máximos locales de |E| con signos alternados
+// Termina cuando los máximos de |E| son iguales (equirriple).
+//
+// La referencia inicial sale de resolver primero el problema con la mitad de funciones base y
+// estirar sus extremas (escalado de referencia): el reparto uniforme sobre la grilla puede dar
+// un delta inicial muy por debajo del redondeo (1e-29 para un rechaza banda de 503
+// coeficientes) y en double el intercambio ya no avanza.
+
+namespace {
+
+// Diferencia absoluta aceptable entre extremos del error (-120 dB, muy por debajo de los 8 bits
+// del conversor)
+constexpr double remez_tolerance = 1e-6;
+
+// Funciones base por debajo de las cuales se parte del reparto uniforme
+constexpr int remez_min_scaled = 16;
+
+struct RemezBand {
+    double low, high;   // Ciclos/muestra (0 a 0.5)
+    double desired;
+};
+
+// Grilla densa: 16 puntos por función base repartidos según el ancho de cada banda
+struct RemezGrid {
+    std::vector<double> f, desired;
+    std::vector<int> band_end;  // Índice siguiente al último punto de cada banda
+
+    RemezGrid(const std::vector<RemezBand>& bands, int r) {
+        double total = 0;
+        for (const RemezBand& b : bands)
+            total += b.high - b.low;
+        double spacing = total / (16.0 * r);
+        for (const RemezBand& b : bands) {
+            int points = (int)std::ceil((b.high - b.low) / spacing) + 1;
+            for (int i = 0; i < points; i++) {
+                f.push_back(b.low + (b.high - b.low) * i / (points - 1));
+                desired.push_back(b.desired);
+            }
+            band_end.push_back((int)f.size());
+        }
+    }
+
+    int Size() const { return (int)f.size(); }
+};
+
+struct RemezInterpolator {
+    std::vector<double> s, c, ad, y;  // Nodos (sin y cos de pi f), pesos baricéntricos y valores
+    size_t size = 0;                  // Nodos usados por Evaluate()
+
+    // cos(2 pi f) - cos(2 pi f_i) = -2 sin(pi (f + f_i)) sin(pi (f - f_i)): como producto no se
+    // cancela cerca de f = 0 y f = 0.5, donde los cosenos de nodos vecinos casi coinciden
+    double Difference(double sf, double cf, size_t i) const {
+        return -2 * (sf * c[i] + cf * s[i]) * (sf * c[i] - cf * s[i]);
+    }
+
+    // Error de alternancia delta para las extremas dadas (índices de la grilla); A(f) queda
+    // definida por los valores D -+ delta en ellas
+    double Solve(const RemezGrid& grid, const std::vector<int>& extremal) {
+        size_t r = extremal.size() - 1;
+        s.resize(r + 1);
+        c.resize(r + 1);
+        ad.resize(r + 1);
+        y.resize(r + 1);
+        for (size_t i = 0; i <= r; i++) {
+            s[i] = std::sin(pi * grid.f[extremal[i]]);
+            c[i] = std::cos(pi * grid.f[extremal[i]]);
+        }
+
+        // Pesos baricéntricos: los productos se intercalan (paso 'stride') para no desbordar
+        size_t stride = r / 15 + 1;
+        for (size_t i = 0; i <= r; i++) {
+            double denom = 1;
+            for (size_t j = 0; j < stride; j++)
+                for (size_t k = j; k <= r; k += stride)
+                    if (k != i)
+                        denom *= 2 * Difference(s[i], c[i], k);
+            if (std::fabs(denom) < 1e-300)
+                denom = 1e-300;
+            ad[i] = 1 / denom;
+        }
+
+        double numer = 0, denom = 0, sign = 1;
+        for (size_t i = 0; i <= r; i++) {
+            numer += ad[i] * grid.desired[extremal[i]];
+            denom += sign * ad[i];
+            sign = -sign;
+        }
+        double delta = numer / denom;
+        sign = 1;
+        for (size_t i = 0; i <= r; i++) {
+            y[i] = grid.desired[extremal[i]] - sign * delta;
+            sign = -sign;
+        }
+
+        // A(f) tiene grado r - 1: se interpola por las primeras r extremas (pesos sin el
+        // factor de la última). Con las r + 1 el redondeo de delta agrega un término de grado r
+        // que domina entre nodos cuando delta es chico
+        for (size_t i = 0; i < r; i++)
+            ad[i] *= 2 * Difference(s[i], c[i], r);
+        size = r;
+        return delta;
+    }
+
+    double Evaluate(double f) const {
+        double sf = std::sin(pi * f), cf = std::cos(pi * f);
+        double numer = 0, denom = 0;
+        for (size_t i = 0; i < size; i++) {
+            double c = Difference(sf, cf, i);
+            if (std::fabs(c) < 1e-300)
+                return y[i];
+            c = ad[i] / c;
+            denom += c;
+            numer += c * y[i];
+        }
+        return numer / denom;
+    }
+};
+
+// Máximos locales del error dentro de cada banda con signos alternados, reducidos a 'count':
+// se conservan los de mayor magnitud sin romper la alternancia. Puede devolver menos si el
+// error no alterna lo suficiente
+std::vector<int> FindExtrema(const std::vector<double>& error, const std::vector<int>& band_end, int count) {
+    // Los bordes de banda se comparan solo con su vecino en la misma banda: del otro lado
+    // está la transición
+    std::vector<int> found;
+    for (int b = 0, begin = 0; b < (int)band_end.size(); begin = band_end[b++]) {
+        for (int i = begin; i < band_end[b]; i++) {
+            double e = error[i];
+            double previous = i > begin ? error[i - 1] : -e;
+            double next = i + 1 < band_end[b] ? error[i + 1] : -e;
+            if ((e > 0 && e >= previous && e >= next) || (e < 0 && e <= previous && e <= next)) {
+                if (found.empty() || found.back() != i - 1 || i == begin || (error[found.back()] > 0) != (e > 0))
+                    found.push_back(i);
+                else if (std::fabs(e) > std::fabs(error[found.back()]))
+                    found.back() = i;
+            }
+        }
+    }
+
+    // Forzar alternancia: de dos vecinos con el mismo signo queda el mayor
+    for (size_t j = 1; j < found.size();) {
+        if ((error[found[j]] > 0) == (error[found[j - 1]] > 0)) {
+            size_t smaller = std::fabs(error[found[j]]) < std::fabs(error[found[j - 1]]) ? j : j - 1;
+            found.erase(found.begin() + smaller);
+            j = j > 1 ? j - 1 : 1;
+        }
+        else {
+            j++;
+        }
+    }
+
+    // Sobrantes: descartar el menor extremo; si es interior se descarta junto con su vecino
+    // menor para no romper la alternancia, si sobra uno solo va el menor de las dos puntas
+    while ((int)found.size() > count) {
+        size_t smallest = 0;
+        for (size_t j = 1; j < found.size(); j++) {
+            if (std::fabs(error[found[j]]) < std::fabs(error[found[smallest]]))
+                smallest = j;
+        }
+        if (smallest == 0 || smallest == found.size() - 1 || (int)found.size() == count + 1) {
+            if (std::fabs(error[found.front()]) < std::fabs(error[found.back()]))
+                found.erase(found.begin());
+            else
+                found.pop_back();
+        }
+        else {
+            size_t neighbor = std::fabs(error[found[smallest - 1]]) < std::fabs(error[found[smallest + 1]])
+                ? smallest - 1 : smallest + 1;
+            found.erase(found.begin() + std::max(smallest, neighbor));
+            found.erase(found.begin() + std::min(smallest, neighbor));
+        }
+    }
+    return found;
+}
+
+// Intercambio de Remez con r funciones base. 'reference' entra con la referencia inicial y sale
+// con las extremas finales, como posiciones 0 a 1 sobre la grilla (las bandas concatenadas, sin
+// las transiciones: así la misma referencia sirve para grillas de otro tamaño). Si está vacía
+// se parte del reparto uniforme. Devuelve false si no converge
+bool Remez(const RemezGrid& grid, int r, std::vector<double>& reference,
+           RemezInterpolator& interpolator, double& max_error) {
+    int size = grid.Size();
+    if (size < r + 1)
+        return false;
+
+    // Estirar la referencia a r + 1 extremas interpolando sus posiciones. Sin referencia se
+    // reparten uniformemente según el ancho de cada banda, con al menos una por banda (una
+    // banda angosta sin extremas deja delta en cero y el intercambio no puede arrancar)
+    std::vector<int> extremal(r + 1);
+    int m = (int)reference.size() - 1;
+    if (m >= 1) {
+        for (int i = 0; i <= r; i++) {
+            double u = (double)i * m / r;
+            int j = u < m ? (int)u : m - 1;
+            double position = reference[j] + (u - j) * (reference[j + 1] - reference[j]);
+            extremal[i] = (int)std::lround(position * (size - 1));
+        }
+    }
+    else {
+        int bands = (int)grid.band_end.size(), assigned = 0;
+        for (int b = 0, begin = 0; b < bands; begin = grid.band_end[b++]) {
+            int count = b + 1 < bands ? std::max(1, (int)std::lround((double)(r + 1) * grid.band_end[b] / size) - assigned)
+                                      : r + 1 - assigned;
+            count = std::min(count, r + 1 - assigned - (bands - 1 - b));
+            for (int i = 0; i < count; i++) {
+                double position = count > 1 ? (double)i / (count - 1) : 0.5;
+                extremal[assigned + i] = begin + (int)std::lround(position * (grid.band_end[b] - 1 - begin));
+            }
+            assigned += count;
+        }
+    }
+    // Índices estrictamente crecientes dentro de la grilla
+    for (int i = 1; i <= r; i++)
+        extremal[i] = std::max(extremal[i], extremal[i - 1] + 1);
+    for (int i = r; i >= 0; i--)
+        extremal[i] = std::min(extremal[i], i < r ? extremal[i + 1] - 1 : size - 1);
+
+    std::vector<double> error(size);
+    bool converged = false;
+    for (int iteration = 0; iteration < 60 && !converged; iteration++) {
+        double delta = interpolator.Solve(grid, extremal);
+        for (int i = 0; i < size; i++)
+            error[i] = grid.desired[i] - interpolator.Evaluate(grid.f[i]);
+        // En las extremas el error vale +-delta por construcción; asignarlo directamente
+        // conserva el signo cuando delta es menor que el redondeo de D - A
+        double sign = 1;
+        for (int i = 0; i <= r; i++) {
+            error[extremal[i]] = sign * delta;
+            sign = -sign;
+        }
+
+        std::vector<int> found = FindExtrema(error, grid.band_end, r + 1);
+        if ((int)found.size() < r + 1)
+            break;
+
+        // Convergencia: todos los extremos con la misma magnitud, en relación al error máximo o
+        // en valor absoluto (con transiciones anchas y muchos coeficientes el rizado óptimo
+        // queda cerca del redondeo). El máximo se toma sobre toda la grilla
+        double min_error = INFINITY;
+        max_error = 0;
+        for (double e : error)
+            max_error = std::fmax(max_error, std::fabs(e));
+        for (int i : found)
+            min_error = std::fmin(min_error, std::fabs(error[i]));
+        double spread = max_error - min_error;
+        converged = max_error > 0 && (spread / max_error < 1e-3 || spread < remez_tolerance);
+        extremal = found;
+    }
+    if (!converged)
+        return false;
+
+    reference.resize(r + 1);
+    for (int i = 0; i <= r; i++)
+        reference[i] = (double)extremal[i] / (size - 1);
+    return true;
+}
+
+// Respuesta de fase cero de un FIR tipo I: h[m] + 2 sum h[m + k] cos(2 pi k f) (Clenshaw)
+double ZeroPhaseResponse(const std::vector<double>& h, double f) {
+    int middle = (int)h.size() / 2;
+    double x = std::cos(2 * pi * f), b1 = 0, b2 = 0;
+    for (int k = middle; k >= 1; k--) {
+        double b0 = 2 * h[middle + k] + 2 * x * b1 - b2;
+        b2 = b1;
+        b1 = b0;
+    }
+    return h[middle] + x * b1 - b2;
+}
+
+}
+
+std::vector<double> DesignParksMcClellan(FirBand band, int taps, double fs, double f1, double f2, double transition) {
+    taps |= 1;
+    int r = taps / 2 + 1;  // Cantidad de funciones base (cosenos)
+    double c1 = f1 / fs, c2 = f2 / fs, t = transition / fs / 2;
+
+    // Bandas de paso y rechazo separadas por las transiciones (en ciclos/muestra)
+    std::vector<RemezBand> bands;
+    switch (band) {
+        case FirBand::LowPass:  bands = { { 0, c1 - t, 1 }, { c1 + t, 0.5, 0 } }; break;
+        case FirBand::HighPass: bands = { { 0, c1 - t, 0 }, { c1 + t, 0.5, 1 } }; break;
+        case FirBand::BandPass: bands = { { 0, c1 - t, 0 }, { c1 + t, c2 - t, 1 }, { c2 + t, 0.5, 0 } }; break;
+        case FirBand::BandStop: bands = { { 0, c1 - t, 1 }, { c1 + t, c2 - t, 0 }, { c2 + t, 0.5, 1 } }; break;
+    }
+    for (const RemezBand& b : bands) {
+        if (b.low < 0 || b.high > 0.5 || b.high <= b.low)
+            return {};
+    }
+
+    // Escalado de referencia: r0 < r0 * 2 < ... < r; si un nivel no converge el siguiente
+    // parte del reparto uniforme
+    std::vector<int> levels = { r };
+    while (levels.back() / 2 >= remez_min_scaled)
+        levels.push_back(levels.back() / 2);
+    std::vector<double> reference;
+    RemezInterpolator interpolator;
+    double max_error = 0;
+    bool converged = false;
+    for (size_t level = levels.size(); level-- > 0;) {
+        converged = Remez(RemezGrid(bands, levels[level]), levels[level], reference, interpolator, max_error);
+        if (!converged)
+            reference.clear();
+    }
+    if (!converged)
+        return {};
+
+    // Coeficientes: muestrear A(f) en taps frecuencias equiespaciadas y antitransformar
+    int middle = taps / 2;
+    std::vector<double> response(middle + 1);
+    for (int k = 0; k <= middle; k++)
+        response[k] = interpolator.Evaluate((double)k / taps);
+
+    std::vector<double> h(taps);
+    for (int m = 0; m <= middle; m++) {
+        double sum = response[0];
+        for (int k = 1; k <= middle; k++)
+            sum += 2 * response[k] * std::cos(2 * pi * k * m / taps);
+        h[middle + m] = h[middle - m] = sum / taps;
+    }
+
+    // Verificar la respuesta de los coeficientes: cerca del límite de precisión A(f) crece
+    // tanto en las transiciones que la antitransformada pierde el detalle de las bandas
+    RemezGrid grid(bands, r);
+    double worst = 0;
+    for (int i = 0; i < grid.Size(); i++)
+        worst = std::fmax(worst, std::fabs(grid.desired[i] - ZeroPhaseResponse(h, grid.f[i])));
+    if (!(worst <= 1.1 * max_error + remez_tolerance))
+        return {};
+    return h;
+}
+
+// ════════════════════════════════════════════════════════════════════════════════════════
+// KERNEL
+// ════════════════════════════════════════════════════════════════════════════════════════
+
+FirKernel::~FirKernel() {
+    std::lock_guard lock(FftwPlannerMutex());
+    if (forward)
+        fftw_destroy_plan(forward);
+    if (inverse)
+        fftw_destroy_plan(inverse);
+    fftw_free(spectra);
+}
+
+std::shared_ptr<const FirKernel> PrepareFirKernel(std::vector<double> taps) {
+    constexpr uint32_t B = FirKernel::fft_block;
+    auto kernel = std::make_shared<FirKernel>();
+    kernel->reversed.assign(taps.rbegin(), taps.rend());
+    kernel->partitions = ((uint32_t)taps.size() + B - 1) / B;
+
+    // Transformada de cada partición de B coeficientes, rellenada con ceros hasta 2B
+    double* time = fftw_alloc_real(2 * B);
+    kernel->spectra = fftw_alloc_complex((size_t)kernel->partitions * (B + 1));
+    {
+        std::lock_guard lock(FftwPlannerMutex());
+        kernel->forward = fftw_plan_dft_r2c_1d(2 * B, time, kernel->spectra, FFTW_ESTIMATE);
+        kernel->inverse = fftw_plan_dft_c2r_1d(2 * B, kernel->spectra, time, FFTW_ESTIMATE);
+    }
+    for (uint32_t p = 0; p < kernel->partitions; p++) {
+        std::fill(time, time + 2 * B, 0.0);
+        for (uint32_t i = 0; i < B && p * B + i < taps.size(); i++)
+            time[i] = taps[p * B + i];
+        fftw_execute_dft_r2c(kernel->forward, time, kernel->spectra + (size_t)p * (B + 1));
+    }
+    fftw_free(time);
+    kernel->taps = std::move(taps);
+
+    // Medir ambos métodos con lotes del tamaño de SerialWorker y quedarse con el más rápido
+    std::vector<double> signal(16384);
+    for (size_t i = 0; i < signal.size(); i++)
+        signal[i] = std::sin(0.01 * i) + ((i * 7919) % 13) * 0.01;
+    auto measure = [&](FirMethod method) {
+        FirFilter filter;
+        filter.SetKernel(kernel, method);
+        std::vector<double> data = signal;
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < data.size(); i += 128)
+            filter.Process(&data[i], 128);
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / data.size();
+    };
+    kernel->direct_ns = measure(FirMethod::Direct);
+    kernel->fft_ns = measure(FirMethod::Fft);
+    kernel->method = kernel->fft_ns < kernel->direct_ns ? FirMethod::Fft : FirMethod::Direct;
+    return kernel;
+}
+
+// ════════════════════════════════════════════════════════════════════════════════════════
+// EJECUCIÓN
+// ════════════════════════════════════════════════════════════════════════════════════════
+
+FirFilter::~FirFilter() {
+    Release();
+}
+
+void FirFilter::Release() {
+    fftw_free(time_buffer);
+    fftw_free(output_buffer);
+    fftw_free(delay_line);
+    fftw_free(accumulator);
+    time_buffer = output_buffer = nullptr;
+    delay_line = accumulator = nullptr;
+}
+
+void FirFilter::SetKernel(std::shared_ptr<const FirKernel> new_kernel) {
+    FirMethod chosen = new_kernel ? new_kernel->method : FirMethod::Direct;
+    SetKernel(std::move(new_kernel), chosen);
+}
+
+void FirFilter::SetKernel(std::shared_ptr<const FirKernel> new_kernel, FirMethod new_method) {
+    constexpr uint32_t B = FirKernel::fft_block;
+    Release();
+    kernel = std::move(new_kernel);
+    method = new_method;
+    line.clear();
+    if (kernel && method == FirMethod::Fft) {
+        time_buffer = fftw_alloc_real(2 * B);
+        output_buffer = fftw_alloc_real(2 * B);
+        delay_line = fftw_alloc_complex((size_t)kernel->partitions * (B + 1));
+        accumulator = fftw_alloc_complex(B + 1);
+    }
+    Reset();
+}
+
+void FirFilter::Reset() {
+    constexpr uint32_t B = FirKernel::fft_block;
+    if (!kernel)
+        return;
+
+    line.assign(kernel->taps.size() - 1, 0.0);
+    if (method == FirMethod::Fft) {
+        std::fill(time_buffer, time_buffer + 2 * B, 0.0);
+        std::memset(delay_line, 0, sizeof(fftw_complex) * kernel->partitions * (B + 1));
+        std::fill(std::begin(output_block), std::end(output_block), 0.0);
+        fill = 0;
+        newest = 0;
+    }
+}
+
+bool FirFilter::SwapKernel(std::shared_ptr<const FirKernel> new_kernel) {
+    if (!kernel || !new_kernel || new_kernel->method != method)
+        return false;
+    if (method == FirMethod::Fft && new_kernel->partitions != kernel->partitions)
+        return false;
+
+    if (method == FirMethod::Direct) {
+        // Conservar las muestras más recientes; si la historia crece se repite la más antigua
+        size_t history = new_kernel->taps.size() - 1;
+        if (line.size() > history)
+            line.erase(line.begin(), line.begin() + (line.size() - history));
+        else
+            line.insert(line.begin(), history - line.size(), line.empty() ? 0.0 : line.front());
+    }
+    kernel = std::move(new_kernel);
+    return true;
+}
+
+void FirFilter::Prime(double x) {
+    constexpr uint32_t B = FirKernel::fft_block;
+    if (!kernel)
+        return;
+
+    std::fill(line.begin(), line.end(), x);
+    if (method == FirMethod::Fft) {
+        // Todas las particiones ven el mismo bloque constante: una sola transformada
+        std::fill(time_buffer, time_buffer + 2 * B, x);
+        fftw_execute_dft_r2c(kernel->forward, time_buffer, delay_line);
+        for (uint32_t p = 1; p < kernel->partitions; p++)
+            std::memcpy(delay_line + (size_t)p * (B + 1), delay_line, sizeof(fftw_complex) * (B + 1));
+
+        double gain = 0;
+        for (double h : kernel->taps)
+            gain += h;
+        std::fill(std::begin(output_block), std::end(output_block), gain * x);
+        fill = 0;
+        newest = 0;
+    }
+}
+
+uint32_t FirFilter::Latency() const {
+    if (!kernel)
+        return 0;
+    uint32_t group = (uint32_t)kernel->taps.size() / 2;
+    return method == FirMethod::Fft ? group + FirKernel::fft_block : group;
+}
+
+void FirFilter::Process(double* data, uint32_t count) {
+    if (!kernel)
+        return;
+    if (method == FirMethod::Fft)
+        ProcessFft(data, count);
+    else
+        ProcessDirect(data, count);
+}
+
+static double Dot(const double* a, const double* b, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+SIMD_TARGET_AVX2 static double DotAvx2(const double* a, const double* b, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
+    }
+    __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+void FirFilter::ProcessDirect(double* data, uint32_t count) {
+    // line = [historia (taps - 1) | lote]: cada salida es un producto punto contiguo
+    size_t history = kernel->taps.size() - 1;
+    line.resize(history + count);
+    std::copy(data, data + count, line.begin() + history);
+
+    const double* h = kernel->reversed.data();
+    size_t taps = kernel->taps.size();
+    bool avx2 = CpuHasAvx2();
+    for (uint32_t n = 0; n < count; n++)
+        data[n] = avx2 ? DotAvx2(h, &line[n], taps) : Dot(h, &line[n], taps);
+
+    std::copy(line.end() - history, line.end(), line.begin());
+    line.resize(history);
+}
+
+void FirFilter::ProcessFft(double* data, uint32_t count) {
+    constexpr uint32_t B = FirKernel::fft_block;
+    for (uint32_t n = 0; n < count; n++) {
+        // La salida se entrega con B muestras de retardo (el bloque anterior ya procesado)
+        time_buffer[B + fill] = data[n];
+        data[n] = output_block[fill];
+        if (++fill == B) {
+            RunFftBlock();
+            fill = 0;
+        }
+    }
+}
+
+// Overlap-save particionado: X = FFT([bloque anterior | bloque actual]) entra en la línea de
+// retardo; Y = sum_p X[-p] * H[p]; la mitad final de la FFT inversa es la salida del bloque
+void FirFilter::RunFftBlock() {
+    constexpr uint32_t B = FirKernel::fft_block;
+    constexpr uint32_t bins = B + 1;
+    uint32_t partitions = kernel->partitions;
+
+    newest = (newest + 1) % partitions;
+    fftw_execute_dft_r2c(kernel->forward, time_buffer, delay_line + (size_t)newest * bins);
+    std::copy(time_buffer + B, time_buffer + 2 * B, time_buffer);
+
+    std::memset(accumulator, 0, sizeof(fftw_complex) * bins);
+    for (uint32_t p = 0; p < partitions; p++) {
+        const fftw_complex* x = delay_line + (size_t)((newest + partitions - p) % partitions) * bins;
+        const fftw_complex* h = kernel->spectra + (size_t)p * bins;
+        for (uint32_t k = 0; k < bins; k++) {
+            accumulator[k][0] += x[k][0] * h[k][0] - x[k][1] * h[k][1];
+            accumulator[k][1] += x[k][0] * h[k][1] + x[k][1] * h[k][0];
+        }
+    }
+
+    fftw_execute_dft_c2r(kernel->inverse, accumulator, output_buffer);
+    for (uint32_t i = 0; i < B; i++)
+        output_block[i] = output_buffer[B + i] / (2 * B);
+}
@@ -0,0 +1,109 @@
+// Fir.h - Filtros FIR de fase lineal: diseño y convolución directa o por FFT
+//
+// Diseño:
+// - Ventana (sinc enventanado con Blackman)
+// - Parks-McClellan (algoritmo de intercambio de Remez, equirriple)
+// Ambos generan filtros simétricos de longitud impar (tipo I): retardo constante de
+// (taps - 1) / 2 muestras para todas las frecuencias, sin distorsionar ondas cuadradas.
+//
+// Ejecución:
+// - Directa: producto punto por muestra (AVX2 si está disponible), O(taps) por muestra
+// - FFT: overlap-save particionado uniforme (bloques de fft_block muestras) con FFTW,
+//   O(log) por muestra pero con fft_block muestras de latencia adicional
+// El método se elige al preparar el kernel midiendo ambos sobre una señal de prueba.
+//
+// FirKernel es inmutable y se comparte entre instancias; cada FirFilter tiene su estado.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <fftw3.h>
+
+enum class FirBand { LowPass, HighPass, BandPass, BandStop };
+
+enum class FirMethod { Direct, Fft };
+
+// Sinc enventanado (Blackman). Frecuencias en Hz; f2 solo para pasa/rechaza banda
+std::vector<double> DesignWindowedSinc(FirBand band, int taps, double fs, double f1, double f2);
+
+// Parks-McClellan: transition es el ancho de cada banda de transición en Hz
+// Retorna un vector vacío si las bandas no caben o si el rizado óptimo queda por debajo de lo
+// que se puede resolver en double (~1e-8: transiciones anchas con muchos coeficientes)
+std::vector<double> DesignParksMcClellan(FirBand band, int taps, double fs, double f1, double f2, double transition);
+
+// Kernel preparado para ambos métodos de ejecución (particiones transformadas y planes de FFTW)
+struct FirKernel {
+	static constexpr uint32_t fft_block = 256;  // Muestras por partición (latencia del método FFT)
+
+	std::vector<double> taps;
+	std::vector<double> reversed;               // Coeficientes invertidos para el producto punto
+	FirMethod method = FirMethod::Direct;
+	double direct_ns = 0, fft_ns = 0;           // Costo medido por muestra de cada método
+
+	uint32_t partitions = 0;
+	fftw_complex* spectra = nullptr;            // partitions * (fft_block + 1) bins
+	fftw_plan forward = nullptr, inverse = nullptr;
+
+	FirKernel() = default;
+	FirKernel(const FirKernel&) = delete;
+	FirKernel& operator=(const FirKernel&) = delete;
+	~FirKernel();
+};
+
+// Prepara el kernel (transformadas de las particiones y planes) y elige el método más rápido
+std::shared_ptr<const FirKernel> PrepareFirKernel(std::vector<double> taps);
+
+class FirFilter {
+public:
+	FirFilter() = default;
+	FirFilter(const FirFilter&) = delete;
+	FirFilter& operator=(const FirFilter&) = delete;
+	~FirFilter();
+
+	// Asigna el kernel (nullptr desactiva el filtro) y limpia el estado
+	// method: fuerza un método (para medir); por defecto el elegido en el kernel
+	void SetKernel(std::shared_ptr<const FirKernel> kernel);
+	void SetKernel(std::shared_ptr<const FirKernel> kernel, FirMethod method);
+
+	void Reset();
+
+	// Cambia el kernel conservando la historia de entrada (el estado de un FIR no depende de
+	// los coeficientes). Requiere el mismo método y, con FFT, la misma cantidad de particiones;
+	// retorna false sin cambiar nada si no es compatible
+	bool SwapKernel(std::shared_ptr<const FirKernel> kernel);
+
+	// Llena la historia con una entrada constante x (sin transitorio al activar el filtro)
+	void Prime(double x);
+
+	// Filtra 'count' muestras en el lugar
+	void Process(double* data, uint32_t count);
+
+	bool Active() const { return kernel != nullptr; }
+
+	// Retardo total en muestras: grupo del FIR más el bloque del método FFT
+	uint32_t Latency() const;
+
+private:
+	void ProcessDirect(double* data, uint32_t count);
+	void ProcessFft(double* data, uint32_t count);
+	void RunFftBlock();
+	void Release();
+
+	std::shared_ptr<const FirKernel> kernel;
+	FirMethod method = FirMethod::Direct;
+
+	// Directo: [historia (taps - 1) | lote]
+	std::vector<double> line;
+
+	// FFT: bloque de entrada en curso, bloque de salida listo y línea de retardo en frecuencia
+	double* time_buffer = nullptr;              // 2 * fft_block: [bloque anterior | bloque actual]
+	double* output_buffer = nullptr;            // 2 * fft_block (salida de la FFT inversa)
+	fftw_complex* delay_line = nullptr;         // partitions * (fft_block + 1)
+	fftw_complex* accumulator = nullptr;        // fft_block + 1
+	double output_block[FirKernel::fft_block] = {};
+	uint32_t fill = 0;
+	uint32_t newest = 0;                        // Partición más reciente en delay_line
+};
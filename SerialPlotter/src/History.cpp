@@ -0,0 +1,322 @@
+// History.cpp - Implementación del historial respaldado en disco
+//
+// Formato del archivo: bloques consecutivos de chunk_samples muestras, cada uno con
+// [entrada (float) | salida (float)]. El archivo se divide en segmentos de
+// chunks_per_segment bloques; cada segmento tiene su propio mapeo y vista, así el
+// archivo crece sin invalidar las vistas ya mapeadas.
+
+#define NOMINMAX
+#include "History.h"
+#include "Serial.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+using namespace std::chrono_literals;
+using history_clock = std::chrono::high_resolution_clock;
+
+static constexpr uint64_t chunk_bytes = 2ull * HistoryStore::chunk_samples * sizeof(float);
+static constexpr uint64_t segment_bytes = HistoryStore::chunks_per_segment * chunk_bytes;
+static constexpr uint32_t blocks_per_chunk = HistoryStore::chunk_samples / HistoryStore::block_samples;
+
+// Resumen vacío: cualquier bloque lo reemplaza al combinarse
+static constexpr HistoryBlock empty_block = {
+    std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+    std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()
+};
+
+HistoryStore::~HistoryStore() {
+    Close();
+}
+
+bool HistoryStore::Open() {
+    Close();
+
+    // Archivo temporal que Windows borra automáticamente al cerrarlo
+    char dir[MAX_PATH], name[MAX_PATH];
+    if (!GetTempPathA(MAX_PATH, dir) || !GetTempFileNameA(dir, "spl", 0, name))
+        return false;
+
+    file = CreateFileA(name, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                       FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        printErrorMessage();
+        file = nullptr;
+        return false;
+    }
+
+    hot.assign(hot_chunks * 2 * chunk_samples, 0.0f);
+    total.store(0);
+    spilled.store(0);
+    blocks.clear();
+    lost.clear();
+    spill_seconds.store(0);
+    read_ms.store(0);
+    lost_chunks.store(0);
+
+    open = true;
+    do_spill_work = true;
+    spill_thread = std::thread(&HistoryStore::SpillWorker, this);
+    return true;
+}
+
+void HistoryStore::Close() {
+    if (!open)
+        return;
+
+    {
+        std::lock_guard lock(spill_mutex);
+        do_spill_work = false;
+    }
+    spill_cv.notify_one();
+    if (spill_thread.joinable())
+        spill_thread.join();
+
+    for (char* view : segments)
+        UnmapViewOfFile(view);
+    for (void* mapping : mappings)
+        CloseHandle(mapping);
+    segments.clear();
+    mappings.clear();
+
+    CloseHandle(file);
+    file = nullptr;
+    hot.clear();
+    hot.shrink_to_fit();
+    open = false;
+}
+
+void HistoryStore::SpillWorker() {
+    while (true) {
+        {
+            // Esperar a que haya un bloque completo (con timeout por si se pierde la notificación)
+            std::unique_lock lock(spill_mutex);
+            spill_cv.wait_for(lock, 50ms, [&] {
+                return !do_spill_work || Size() / chunk_samples > spilled.load();
+            });
+            if (!do_spill_work)
+                break;
+        }
+
+        while (spilled.load() < Size() / chunk_samples)
+            Spill(spilled.load());
+    }
+}
+
+bool HistoryStore::Spill(uint64_t chunk) {
+    auto start = history_clock::now();
+    uint64_t segment = chunk / chunks_per_segment;
+
+    // Crear el segmento si todavía no existe (el mapeo extiende el archivo)
+    bool ok = true;
+    if (segments.size() <= segment) {
+        uint64_t size = (segment + 1) * segment_bytes;
+        uint64_t offset = segment * segment_bytes;
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, nullptr);
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, (DWORD)(offset >> 32), (DWORD)offset, segment_bytes) : nullptr;
+        if (view) {
+            std::lock_guard lock(mutex);
+            mappings.push_back(mapping);
+            segments.push_back((char*)view);
+        }
+        else {
+            printErrorMessage();
+            if (mapping)
+                CloseHandle(mapping);
+            ok = false;
+        }
+    }
+
+    ok = ok && !Overtaken(chunk);
+
+    HistoryBlock summary[blocks_per_chunk];
+    if (ok) {
+        const float* data = HotChunk(chunk);
+        float* target = (float*)(segments[segment] + (chunk % chunks_per_segment) * chunk_bytes);
+        std::copy(data, data + 2 * chunk_samples, target);
+
+        // Resúmenes min/max del bloque (se calculan sobre la copia ya volcada)
+        for (uint32_t b = 0; b < blocks_per_chunk; b++) {
+            const float* in = target + b * block_samples;
+            const float* out = target + chunk_samples + b * block_samples;
+            auto [min_in, max_in] = std::minmax_element(in, in + block_samples);
+            auto [min_out, max_out] = std::minmax_element(out, out + block_samples);
+            summary[b] = { *min_in, *max_in, *min_out, *max_out };
+        }
+
+        // Si el productor alcanzó el bloque durante la copia, los datos pueden estar mezclados
+        ok = !Overtaken(chunk);
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        if (ok)
+            blocks.insert(blocks.end(), summary, summary + blocks_per_chunk);
+        else
+            blocks.resize(blocks.size() + blocks_per_chunk, empty_block);
+        lost.push_back(!ok);
+        spilled.store(chunk + 1, std::memory_order_release);
+    }
+
+    if (!ok)
+        lost_chunks++;
+
+    spill_seconds += std::chrono::duration<double>(history_clock::now() - start).count();
+    return ok;
+}
+
+const float* HistoryStore::ChunkData(uint64_t chunk) {
+    if (chunk < spilled.load(std::memory_order_acquire)) {
+        if (lost[chunk])
+            return nullptr;
+        return (const float*)(segments[chunk / chunks_per_segment] + (chunk % chunks_per_segment) * chunk_bytes);
+    }
+
+    // Bloque todavía en el anillo caliente (si no fue sobrescrito). El productor puede
+    // alcanzarlo mientras se lee: quien copie del anillo debe volver a llamar a Overtaken()
+    if (Overtaken(chunk))
+        return nullptr;
+    return HotChunk(chunk);
+}
+
+HistoryBlock HistoryStore::BlockAt(uint64_t block) {
+    if (block < blocks.size())
+        return blocks[block];
+
+    // Bloque no volcado todavía: calcular el resumen desde el anillo caliente
+    uint64_t chunk = block / blocks_per_chunk;
+    const float* data = ChunkData(chunk);
+    if (!data)
+        return empty_block;
+
+    uint32_t offset = (block % blocks_per_chunk) * block_samples;
+    uint32_t count = (uint32_t)std::min<uint64_t>(block_samples, Size() - block * block_samples);
+    const float* in = data + offset;
+    const float* out = data + chunk_samples + offset;
+    auto [min_in, max_in] = std::minmax_element(in, in + count);
+    auto [min_out, max_out] = std::minmax_element(out, out + count);
+    HistoryBlock summary = { *min_in, *max_in, *min_out, *max_out };
+
+    // Si el productor alcanzó el bloque durante la lectura, el resumen puede estar mezclado
+    return Overtaken(chunk) ? empty_block : summary;
+}
+
+uint32_t HistoryStore::Read(uint64_t first, uint32_t count, double* in, double* out) {
+    if (!open)
+        return 0;
+
+    auto start = history_clock::now();
+    uint64_t available = Size();
+    if (first >= available)
+        return 0;
+    count = (uint32_t)std::min<uint64_t>(count, available - first);
+
+    std::lock_guard lock(mutex);
+    uint32_t done = 0;
+    while (done < count) {
+        uint64_t n = first + done;
+        uint64_t chunk = n / chunk_samples;
+        uint32_t i = n % chunk_samples;
+        uint32_t length = std::min(count - done, chunk_samples - i);
+
+        // Las páginas del archivo se cargan bajo demanda al copiar
+        const float* data = ChunkData(chunk);
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        for (uint32_t k = 0; k < length; k++) {
+            if (in)
+                in[done + k] = data ? data[i + k] : nan;
+            if (out)
+                out[done + k] = data ? data[chunk_samples + i + k] : nan;
+        }
+
+        // Copia desde el anillo caliente (spilled no avanza con 'mutex' tomado): si el productor
+        // alcanzó el bloque durante la copia, los datos pueden estar mezclados y se descartan
+        if (data && chunk >= spilled.load(std::memory_order_acquire) && Overtaken(chunk)) {
+            if (in)
+                std::fill(in + done, in + done + length, nan);
+            if (out)
+                std::fill(out + done, out + done + length, nan);
+        }
+        done += length;
+    }
+
+    read_ms = std::chrono::duration<double, std::milli>(history_clock::now() - start).count();
+    return count;
+}
+
+void HistoryStore::Envelope(uint64_t first, uint64_t last, int pixels, double period,
+                            std::vector<double>& xs, std::vector<double>& in, std::vector<double>& out) {
+    xs.clear();
+    in.clear();
+    out.clear();
+
+    last = std::min(last, Size());
+    if (!open || first >= last || pixels <= 0)
+        return;
+
+    uint64_t count = last - first;
+    double per_pixel = (double)count / pixels;
+
+    // Pocas muestras por píxel: leer el rango completo (como máximo block_samples * pixels)
+    if (per_pixel < block_samples) {
+        std::vector<double> raw_in(count), raw_out(count);
+        Read(first, (uint32_t)count, raw_in.data(), raw_out.data());
+
+        if (per_pixel < 2) {
+            for (uint64_t i = 0; i < count; i++) {
+                xs.push_back((first + i) * period);
+                in.push_back(raw_in[i]);
+                out.push_back(raw_out[i]);
+            }
+            return;
+        }
+
+        for (int p = 0; p < pixels; p++) {
+            uint64_t a = (uint64_t)(p * per_pixel), b = std::min<uint64_t>(count, (uint64_t)((p + 1) * per_pixel));
+            if (a >= b || std::isnan(raw_in[a]))
+                continue;
+            auto [min_in, max_in] = std::minmax_element(raw_in.begin() + a, raw_in.begin() + b);
+            auto [min_out, max_out] = std::minmax_element(raw_out.begin() + a, raw_out.begin() + b);
+            double x = (first + a) * period;
+            xs.insert(xs.end(), { x, x });
+            in.insert(in.end(), { *min_in, *max_in });
+            out.insert(out.end(), { *min_out, *max_out });
+        }
+        return;
+    }
+
+    // Muchas muestras por píxel: combinar los resúmenes del índice (sin tocar el archivo)
+    std::lock_guard lock(mutex);
+    for (int p = 0; p < pixels; p++) {
+        uint64_t a = first + (uint64_t)(p * per_pixel);
+        uint64_t b = std::min(last, first + (uint64_t)((p + 1) * per_pixel));
+        HistoryBlock merged = empty_block;
+        for (uint64_t block = a / block_samples; block * block_samples < b; block++) {
+            HistoryBlock summary = BlockAt(block);
+            merged.min_in = std::min(merged.min_in, summary.min_in);
+            merged.max_in = std::max(merged.max_in, summary.max_in);
+            merged.min_out = std::min(merged.min_out, summary.min_out);
+            merged.max_out = std::max(merged.max_out, summary.max_out);
+        }
+        if (merged.min_in > merged.max_in)
+            continue;
+
+        double x = a * period;
+        xs.insert(xs.end(), { x, x });
+        in.insert(in.end(), { merged.min_in, merged.max_in });
+        out.insert(out.end(), { merged.min_out, merged.max_out });
+    }
+}
+
+HistoryStats HistoryStore::Stats() const {
+    HistoryStats stats;
+    stats.spilled_chunks = spilled.load();
+    stats.lost_chunks = lost_chunks.load();
+    double seconds = spill_seconds.load();
+    if (seconds > 0)
+        stats.spill_mb_per_s = stats.spilled_chunks * chunk_bytes / seconds / 1e6;
+    stats.read_ms = read_ms.load();
+    return stats;
+}
@@ -0,0 +1,118 @@
+// History.h - Historial de larga duración respaldado en disco (archivo mapeado en memoria)
+//
+// Los ScrollBuffer conservan como máximo max_time segundos en RAM. HistoryStore guarda
+// toda la sesión en dos niveles:
+// - Anillo caliente en RAM (hot_chunks bloques) donde SerialWorker agrega cada muestra
+// - Bloques fríos volcados por un hilo propio a un archivo temporal mapeado en memoria
+//
+// El índice de bloques (resumen min/max cada block_samples muestras) queda en RAM, así
+// que cualquier rango de tiempo se puede graficar, analizar o exportar leyendo del
+// archivo solo las páginas necesarias (el sistema operativo las carga bajo demanda).
+//
+// Thread-safety:
+// - Un único productor (SerialWorker) llama a Append() sin tomar locks
+// - El hilo de volcado y los lectores comparten el índice protegido por un mutex
+//   (los lectores solo lo toman al leer rangos, nunca el productor)
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Resumen min/max de un bloque de muestras (entrada y salida filtrada)
+struct HistoryBlock {
+	float min_in, max_in;
+	float min_out, max_out;
+};
+
+// Métricas de rendimiento del historial
+struct HistoryStats {
+	double spill_mb_per_s = 0;   // Velocidad sostenida de volcado a disco
+	double read_ms = 0;          // Latencia de la última lectura de un rango frío
+	uint64_t spilled_chunks = 0; // Bloques ya volcados al archivo
+	uint64_t lost_chunks = 0;    // Bloques perdidos porque el volcado no alcanzó al productor
+};
+
+class HistoryStore {
+public:
+	static constexpr uint32_t chunk_samples = 65536;     // Muestras por bloque (por canal)
+	static constexpr uint32_t block_samples = 256;       // Muestras por resumen min/max
+	static constexpr uint32_t hot_chunks = 8;            // Bloques del anillo caliente en RAM
+	static constexpr uint32_t chunks_per_segment = 128;  // Bloques por vista mapeada (64 MB)
+
+	~HistoryStore();
+
+	// Crea el archivo temporal e inicia el hilo de volcado
+	bool Open();
+
+	// Detiene el volcado y borra el archivo temporal
+	void Close();
+
+	bool IsOpen() const { return open; }
+
+	// Productor: agrega una muestra de entrada y su salida filtrada
+	void Append(double in, double out) {
+		if (!open)
+			return;
+
+		uint64_t n = total.load(std::memory_order_relaxed);
+		float* chunk = HotChunk(n / chunk_samples);
+		uint32_t i = n % chunk_samples;
+		chunk[i] = (float)in;
+		chunk[chunk_samples + i] = (float)out;
+		total.store(n + 1, std::memory_order_release);
+
+		// Bloque completo: despertar al hilo de volcado
+		if (i == chunk_samples - 1)
+			spill_cv.notify_one();
+	}
+
+	// Cantidad total de muestras agregadas
+	uint64_t Size() const { return total.load(std::memory_order_acquire); }
+
+	// Copia las muestras [first, first + count) en 'in' y/o 'out' (pueden ser nullptr)
+	// Retorna la cantidad de muestras copiadas
+	uint32_t Read(uint64_t first, uint32_t count, double* in, double* out);
+
+	// Genera la envolvente min/max del rango [first, last) para 'pixels' píxeles
+	// xs/in/out reciben dos puntos (mínimo y máximo) por píxel
+	void Envelope(uint64_t first, uint64_t last, int pixels, double period,
+	              std::vector<double>& xs, std::vector<double>& in, std::vector<double>& out);
+
+	HistoryStats Stats() const;
+
+private:
+	float* HotChunk(uint64_t chunk) { return hot.data() + (chunk % hot_chunks) * 2 * chunk_samples; }
+	// El productor sobrescribe el bloque del anillo caliente cuando avanza hot_chunks bloques más
+	bool Overtaken(uint64_t chunk) const { return Size() / chunk_samples >= chunk + hot_chunks; }
+	const float* ChunkData(uint64_t chunk);  // Con 'mutex' tomado
+	HistoryBlock BlockAt(uint64_t block);     // Con 'mutex' tomado
+	void SpillWorker();
+	bool Spill(uint64_t chunk);
+
+	bool open = false;
+	void* file = nullptr;                 // HANDLE del archivo temporal
+	std::vector<void*> mappings;          // HANDLE de mapeo de cada segmento
+	std::vector<char*> segments;          // Vista mapeada de cada segmento
+
+	std::vector<float> hot;               // Anillo caliente: [entrada | salida] por bloque
+	std::atomic_uint64_t total = 0;       // Muestras agregadas por el productor
+	std::atomic_uint64_t spilled = 0;     // Bloques ya volcados al archivo
+
+	std::vector<HistoryBlock> blocks;     // Resúmenes de los bloques volcados
+	std::vector<bool> lost;               // Bloques que no se pudieron volcar a tiempo
+	std::mutex mutex;                     // Protege segments, blocks y lost
+
+	std::thread spill_thread;
+	std::mutex spill_mutex;
+	std::condition_variable spill_cv;
+	bool do_spill_work = false;
+
+	std::atomic<double> spill_seconds = 0; // Tiempo dedicado a volcar (para la velocidad)
+	std::atomic<double> read_ms = 0;
+	std::atomic_uint64_t lost_chunks = 0;
+};
@@ -0,0 +1,109 @@
+// LiveFilter.cpp - Cambio de diseño en el borde de lote: estado conservado o fundido cruzado
+
+#include "LiveFilter.h"
+
+// Cambia los coeficientes sin tocar el estado si la estructura es la misma
+bool LiveFilter::Slot::Morph(const std::shared_ptr<const FilterDesign>& next) {
+    if (!design || !next)
+        return false;
+
+    if (design->fir || next->fir) {
+        if (!design->fir || !next->fir || !fir.SwapKernel(next->fir))
+            return false;
+    }
+    else {
+        if (design->sections != next->sections)
+            return false;
+        biquads.SetCoefficients(next->coefficients, next->sections);
+    }
+    design = next;
+    return true;
+}
+
+void LiveFilter::Slot::Load(const std::shared_ptr<const FilterDesign>& next) {
+    design = next;
+    bool fir_design = next && next->fir;
+    biquads.SetCoefficients(next ? next->coefficients : nullptr, next && !fir_design ? next->sections : 0);
+    biquads.Reset();
+    fir.SetKernel(fir_design ? next->fir : nullptr);
+}
+
+void LiveFilter::Slot::Process(double* data, uint32_t count) {
+    if (fir.Active())
+        fir.Process(data, count);
+    else if (biquads.Sections() > 0)
+        biquads.Process(data, count);
+}
+
+void LiveFilter::Reset() {
+    for (Slot& slot : slots)
+        slot.Load(nullptr);
+    pending = nullptr;
+    has_pending = false;
+    fade_remaining = 0;
+}
+
+void LiveFilter::Update(std::shared_ptr<const FilterDesign> design) {
+    Slot& active = slots[current];
+    if (design == active.design || (has_pending && design == pending))
+        return;
+
+    if (active.Morph(design)) {
+        has_pending = false;
+        morphs.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (fade_remaining == 0) {
+        pending = std::move(design);
+        has_pending = true;
+    }
+}
+
+void LiveFilter::Adopt(std::shared_ptr<const FilterDesign> design, const double* state1, const double* state2) {
+    // Un fundido en curso se abandona: el estado adoptado ya es el de régimen
+    slots[current ^ 1].Load(nullptr);
+    slots[current].Load(design);
+    slots[current].biquads.SetState(state1, state2);
+    pending = nullptr;
+    has_pending = false;
+    fade_remaining = 0;
+    adoptions.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LiveFilter::Process(double* data, uint32_t count) {
+    if (count == 0)
+        return;
+
+    // Estructura nueva: cargar el otro juego en régimen con la primera muestra del lote
+    if (has_pending) {
+        current ^= 1;
+        slots[current].Load(pending);
+        slots[current].biquads.Prime(data[0]);
+        slots[current].fir.Prime(data[0]);
+        pending = nullptr;
+        has_pending = false;
+        fade_remaining = crossfade_samples;
+        crossfades.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (fade_remaining == 0) {
+        slots[current].Process(data, count);
+        return;
+    }
+
+    // Fundido cruzado: el juego anterior filtra una copia de la entrada
+    Slot& previous = slots[current ^ 1];
+    fade_buffer.assign(data, data + count);
+    previous.Process(fade_buffer.data(), count);
+    slots[current].Process(data, count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        double weight = fade_remaining > 0 ? 1.0 - (double)fade_remaining / crossfade_samples : 1.0;
+        data[i] = fade_buffer[i] + weight * (data[i] - fade_buffer[i]);
+        if (fade_remaining > 0)
+            fade_remaining--;
+    }
+
+    // Liberar el juego anterior al terminar (los kernels FIR grandes ocupan memoria)
+    if (fade_remaining == 0)
+        previous.Load(nullptr);
+}
@@ -0,0 +1,72 @@
+// LiveFilter.h - Filtro aplicado en SerialWorker con cambio de diseño sin cortes
+//
+// Cada diseño nuevo publicado por FilterDesigner se aplica en el borde de un lote:
+// - Misma estructura (igual cantidad de secciones, o FIR con el mismo método): se cambian
+//   los coeficientes conservando el estado, sin transitorio ni costo adicional
+// - Estructura distinta (IIR <-> FIR, otro orden, activar o desactivar): el diseño nuevo se
+//   carga en el segundo juego, se inicializa en régimen con la entrada actual y se hace un
+//   fundido cruzado de crossfade_samples muestras entre la salida anterior y la nueva.
+//   Solo durante el fundido corren los dos filtros.
+//
+// Thread-safety: una instancia pertenece a un único hilo (SerialWorker)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Biquad.h"
+#include "Fir.h"
+#include "FilterDesign.h"
+
+class LiveFilter {
+public:
+	static constexpr uint32_t crossfade_samples = 512;
+
+	// Desactiva el filtro y descarta el estado (inicio de sesión)
+	void Reset();
+
+	// Toma el último diseño (nullptr = sin filtro); se aplica en el próximo Process.
+	// Durante un fundido los diseños incompatibles esperan a que termine
+	void Update(std::shared_ptr<const FilterDesign> design);
+
+	// Reemplaza el filtro por un diseño IIR que ya venía corriendo en otro lado (un carril
+	// de FilterLanes) con su estado: la salida continúa sin transitorio ni fundido
+	void Adopt(std::shared_ptr<const FilterDesign> design, const double* state1, const double* state2);
+
+	// Filtra 'count' muestras en el lugar
+	void Process(double* data, uint32_t count);
+
+	// true si hay algún filtro corriendo o un diseño esperando a cargarse en el próximo Process
+	// (el primer diseño tras Reset() queda pendiente: sin esto nunca se llamaría a Process)
+	bool Active() const { return slots[current].Active() || fade_remaining > 0 || has_pending; }
+
+	bool Fading() const { return fade_remaining > 0; }
+
+	// Cambios aplicados conservando el estado y con fundido (leídos desde la UI)
+	uint64_t Morphs() const { return morphs.load(std::memory_order_relaxed); }
+	uint64_t Crossfades() const { return crossfades.load(std::memory_order_relaxed); }
+	uint64_t Adoptions() const { return adoptions.load(std::memory_order_relaxed); }
+
+private:
+	struct Slot {
+		std::shared_ptr<const FilterDesign> design;
+		BiquadCascade biquads;
+		FirFilter fir;
+
+		bool Active() const { return biquads.Sections() > 0 || fir.Active(); }
+		bool Morph(const std::shared_ptr<const FilterDesign>& next);
+		void Load(const std::shared_ptr<const FilterDesign>& next);
+		void Process(double* data, uint32_t count);
+	};
+
+	Slot slots[2];
+	int current = 0;
+	std::shared_ptr<const FilterDesign> pending;  // Diseño a cargar con fundido en el próximo Process
+	bool has_pending = false;
+	uint32_t fade_remaining = 0;
+	std::vector<double> fade_buffer;              // Entrada copiada para el filtro saliente
+	std::atomic<uint64_t> morphs = 0, crossfades = 0, adoptions = 0;
+};
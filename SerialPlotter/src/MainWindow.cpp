@@ -4,34 +4,41 @@
 // - Panel lateral izquierdo (240px): Controles de puerto, configuración y conexión
 // - Área de gráficos derecha: 3 gráficos apilados verticalmente
 //   1. Entrada: señal cruda recibida por serial
-//   2. Salida: señal filtrada (pasa bajos, pasa altos o ninguno)
+//   2. Salida: señal filtrada (pasa bajos, pasa altos, pasa banda, rechaza banda, notch o ninguno)
 //   3. Espectro: análisis FFT de la señal
 //
 // Modo Congelar:
 // - Permite "pausar" la visualización sin detener la adquisición de datos
-// - Guarda un snapshot (copia completa) de los datos actuales en frozen_dataX/Y/Y_filtered
+// - Fija la ventana actual como captura (SnapshotStore) sin copiar muestras; la copia
+//   solo ocurre si SerialWorker está por sobrescribir el rango fijado
+// - Se conservan varias capturas para compararlas superpuestas
 // - Permite hacer zoom independiente del modo en vivo
 // - La adquisición continúa en segundo plano y se puede reanudar sin pérdida
 //
 // Thread-safety:
 // - SerialWorker (serial_thread): lee datos del puerto serial y actualiza scrollX, scrollY y filter_scrollY
-//   * Protegido por data_mutex para evitar condiciones de carrera durante freeze/unfreeze
+//   * Publica la ventana visible tras cada lote y copia las capturas que va a sobrescribir
 // - AnalysisWorker (analysis_thread): calcula FFT periódicamente cuando está en modo en vivo
 //   * Pausado automáticamente en modo congelado para no procesar datos nuevos
 // - Draw (UI thread): visualiza datos congelados (snapshot) o en vivo (buffers circulares)
-//   * Lee buffers de forma thread-safe usando data_mutex solo durante la copia del snapshot
+//   * En vivo usa la ventana publicada por SerialWorker (published_view) sin bloquear
+//   * Congelado lee las capturas con SnapshotStore::Lock() tomado
 
 #include <imgui.h>
 #include <imgui_internal.h>
 
 #include <implot.h>
 #include <Iir.h>
+#include <fstream>
+#include <numbers>
+#include <random>
 #include <thread>
 
 #include "MainWindow.h"
 
 #include "Buffers.h"
 #include "Settings.h"
+#include "Simd.h"
 
 // Velocidades de comunicación serial estándar (bits por segundo)
 // Arduino Mega 2560 soporta baudrates más altos que Uno
@@ -45,9 +52,6 @@ const int frecuencias[] = { 120, 240, 480, 960, 1440, 1920, 3840, 5760, 7680, 11
 
 using namespace std::chrono_literals;
 
-Iir::Butterworth::LowPass<8> lowpass_filter;
-Iir::Butterworth::HighPass<8> highpass_filter;
-
 // Declaraciones de funciones de Settings.cpp
 void ComboFrecuenciaMuestreo(int& selected);
 void ComboBaudRate(int& selected);
@@ -129,6 +133,12 @@ int MetricFormatter(double value, char* buff, int size, void* data) {
 MainWindow::MainWindow(int width, int height, Settings& config, SettingsWindow& ventanaConfig) :
     settings(&config), settingsWindow(&ventanaConfig), width(width), height(height)
 {
+    // Cadena por defecto: solo el filtro diseñado en la sección Filtro
+    chain_config.stages.push_back({ StageType::Filter });
+    processing_chain.Configure(chain_config);
+
+    UpdateSampleMapping();
+    plugins.Scan(PluginRegistry::DefaultDirectory());
     CreateBuffers();
 }
 
@@ -140,42 +150,106 @@ MainWindow::~MainWindow()
 
 void MainWindow::CreateBuffers() {
     int speed = settings->sampling_rate;
-    int max_size = speed * max_time;  // Buffer para max_time segundos de datos
-    size = 0;
     int view_size = 30 * speed;  // Vista inicial de 30 segundos
     next_time = 0;
 
+    // Capacidad derivada del presupuesto de memoria: tres canales en double (tiempo, entrada, salida)
+    // más los resúmenes por bloque de entrada y salida (uno cada block_size muestras)
+    // El espacio se reserva completo pero las páginas se comprometen a medida que llegan datos
+    constexpr uint64_t channels = 3;
+    constexpr uint64_t block_size = BlockSummaries<>::block_size;
+    uint64_t budget_samples = (uint64_t)settings->memory_budget_mb * 1024 * 1024 * block_size /
+                              (channels * sizeof(double) * block_size + 2 * sizeof(BlockSummary));
+    if (budget_samples > UINT32_MAX / 2)
+        budget_samples = UINT32_MAX / 2;
+    int max_size = (int)budget_samples;
+
+    // Draw usa la ventana tomada al inicio del frame durante todo el frame sin validarla: una
+    // ventana publicada hasta 'frame' muestras antes de una compactación debe seguir intacta
+    // hasta 'frame' muestras después. La compactación copia a [0, view) y las muestras nuevas
+    // siguen desde ahí, así que hace falta capacity >= 2 * (view + frame) (ver ViewPublisher).
+    // frame cubre un frame de 250 ms (4 FPS) más un lote de lectura
+    int frame = speed / 4 + (int)read_buffer_size;
+    if (max_size < 2 * (view_size + frame))
+        view_size = max_size / 2 - frame;
+    max_time = max_size / speed;
+
     DestroyBuffers();
+
+    // Diezmado por potencias de 2 hasta una frecuencia de salida de al menos 400 Hz
+    input_decimator.Configure(speed, 400);
+    output_decimator.Configure(speed, 400);
     
     // Aumentar tamaño de buffers para reducir overhead de lecturas pequeñas
     // Arduino Mega tiene más RAM, podemos usar buffers más grandes
-    read_buffer.resize(512);   // Era 128, ahora 512 (4x más)
-    write_buffer.resize(512);  // Era 128, ahora 512 (4x más)
-
-    // Crear buffers circulares para datos en tiempo real
-    fft = new FFT(settings->sampling_rate);
-    scrollX = new ScrollBuffer<double>(max_size, view_size);
-    scrollY = new ScrollBuffer<double>(max_size, view_size);
-    filter_scrollY = new ScrollBuffer<double>(max_size, view_size);
+    read_buffer.resize(read_buffer_size);
+    write_buffer.resize(read_buffer_size);
+
+    // Buffers circulares y FFT de la sesión: se reutilizan si la configuración no cambió
+    session = session_pool.Acquire(settings->sampling_rate, max_size, view_size, input_decimator.Factor());
+    fft = session->fft.get();
+    scrollX = session->x.get();
+    scrollY = session->y.get();
+    filter_scrollY = session->filtered.get();
+    input_blocks = session->input_blocks.get();
+    output_blocks = session->output_blocks.get();
+    decimated_fft = session->decimated_fft.get();
+    for (int lane = 0; lane < FilterLanes::max_lanes; lane++)
+        candidate_fft[lane] = session->candidate_fft[lane].get();
+    decimated_x = session->decimated_x.get();
+    decimated_y = session->decimated_y.get();
+    decimated_filtered = session->decimated_filtered.get();
+    decimated_rate = input_decimator.OutputRate();
+    decimated_next_time = -input_decimator.Delay();  // Alinea la salida diezmada con la entrada
+
+    published_view.reset();
+    live_view = {};
+    decimated_view.reset();
+    decimated_live_view = {};
+
+    // Las pirámides cubren la ventana visible en vivo con un margen
+    input_lod.Reset(view_size + view_size / 4);
+    output_lod.Reset(view_size + view_size / 4);
+
+    // Nuevo historial (en disco o comprimido en RAM) para la sesión (el anterior se descarta)
+    history.Close();
+    history_x.clear();
+    history_pixels = 0;
+    if (settings->disk_history)
+        history.Open();
+    code_history.Close();
+    if (settings->compressed_history && !settings->disk_history)
+        code_history.Open();
+    snapshots.Attach(scrollX->storage(), scrollY->storage(), filter_scrollY->storage());
 }
 
 void MainWindow::DestroyBuffers() {
-    delete scrollX;
-    delete scrollY;
-    delete filter_scrollY;
+    // Las capturas que aún apuntan a los buffers vivos se copian antes de liberarlos
+    snapshots.MaterializeAll();
+    snapshots.Attach(nullptr, nullptr, nullptr);
+
+    fft = nullptr;
+    scrollX = nullptr;
+    scrollY = nullptr;
+    filter_scrollY = nullptr;
+    input_blocks = nullptr;
+    output_blocks = nullptr;
+    decimated_fft = nullptr;
+    for (FFT*& spectrum : candidate_fft)
+        spectrum = nullptr;
+    decimated_x = nullptr;
+    decimated_y = nullptr;
+    decimated_filtered = nullptr;
+    session_pool.Release(std::move(session));
 }
 
-double MainWindow::TransformSample(uint8_t v) {
-    return (v - settings->minimum) * settings->map_factor - 6;
-}
-
-uint8_t MainWindow::InverseTransformSample(double v) {
-    double result = round((v + 6) * (settings->maximum - settings->minimum) / 12.0 + settings->minimum);
-    if (result < 0)
-        return 0;
-    if (result > 255)
-        return 255;
-    return (int)result;
+void MainWindow::UpdateSampleMapping() {
+    // Máximo y Mínimo se editan aquí y en la ventana de configuración: comparar una vez por frame
+    // y reconstruir la tabla solo si el mapeo cambió
+    auto current = sample_mapping.load();
+    if (current && current->Minimum() == settings->minimum && current->Maximum() == settings->maximum)
+        return;
+    sample_mapping.store(std::make_shared<const SampleMapping>(settings->minimum, settings->maximum));
 }
 
 
@@ -185,7 +259,8 @@ void MainWindow::ToggleConnection()
         if (settings->port.empty())
             return;
 
-        Start();
+        if (!Start())
+            return;
     }
     else {
         Stop();
@@ -204,32 +279,73 @@ void MainWindow::ToggleFreeze()
         frozen_down_limit = down_limit;
         frozen_up_limit = up_limit;
         
-        // Copiar snapshot de datos actuales de forma thread-safe
-        // El mutex protege contra escrituras del SerialWorker mientras copiamos
-        std::lock_guard<std::mutex> lock(data_mutex);
-        
-        if (scrollX && scrollY && filter_scrollY) {
-            frozen_size = scrollX->count();
-            
-            if (frozen_size > 0) {
-                frozen_dataX.resize(frozen_size);
-                frozen_dataY.resize(frozen_size);
-                frozen_dataY_filtered.resize(frozen_size);
-                
-                // Copiar elemento por elemento (el operador [] maneja el offset del buffer circular)
-                for (int i = 0; i < frozen_size; i++) {
-                    frozen_dataX[i] = (*scrollX)[i];
-                    frozen_dataY[i] = (*scrollY)[i];
-                    frozen_dataY_filtered[i] = (*filter_scrollY)[i];
-                }
-            }
+        // Fijar la ventana publicada como captura: O(1), no bloquea a SerialWorker. Si hubo una
+        // compactación antes de registrarla (la copia diferida aún no la protegía), se toma de nuevo
+        while (true) {
+            BufferView view = published_view.acquire();
+            active_snapshot = snapshots.Freeze(view);
+            if (!active_snapshot || published_view.validate(view))
+                break;
+            snapshots.Release(active_snapshot);
         }
     }
     else {
-        // Liberar memoria del snapshot al reanudar modo en vivo
-        frozen_dataX.clear();
-        frozen_dataY.clear();
-        frozen_dataY_filtered.clear();
+        // La captura se conserva en la lista para compararla más tarde
+        active_snapshot = 0;
+    }
+}
+
+void MainWindow::DrawSnapshots()
+{
+    int view_id = 0, release_id = 0;
+
+    {
+        auto lock = snapshots.Lock();
+        if (snapshots.List().empty())
+            return;
+
+        ImGui::Spacing();
+        ImGui::Text("Capturas:");
+        for (auto& snapshot : snapshots.List()) {
+            ImGui::PushID(snapshot->id);
+
+            bool visible = frozen && snapshot->id == active_snapshot;
+            if (ImGui::RadioButton("##ver", visible))
+                view_id = snapshot->id;
+            ImGui::SetItemTooltip("Ver esta captura");
+
+            ImGui::SameLine();
+            ImGui::Checkbox("##comparar", &snapshot->compare);
+            ImGui::SetItemTooltip("Superponer al ver otra captura");
+
+            ImGui::SameLine();
+            ImGui::Text("#%d  %.1f - %.1f s%s", snapshot->id, snapshot->first_time, snapshot->last_time,
+                        snapshot->materialized ? " (copia)" : "");
+
+            ImGui::SameLine();
+            if (ImGui::Button("X"))
+                release_id = snapshot->id;
+
+            ImGui::PopID();
+        }
+    }
+
+    // Aplicar acciones fuera del lock (Release lo toma de nuevo)
+    if (view_id != 0) {
+        if (!frozen) {
+            // Entrar en modo congelado mostrando la captura elegida (sin tomar una nueva)
+            frozen = true;
+            frozen_left_limit = left_limit;
+            frozen_right_limit = right_limit;
+            frozen_down_limit = down_limit;
+            frozen_up_limit = up_limit;
+        }
+        active_snapshot = view_id;
+    }
+    if (release_id != 0) {
+        snapshots.Release(release_id);
+        if (release_id == active_snapshot)
+            ToggleFreeze();
     }
 }
 
@@ -335,18 +451,48 @@ void MainWindow::DrawSidebar()
     if (ImGui::IsItemHovered()) {
         ImGui::SetTooltip("Tiempo por division (16 divisiones totales)\nLas divisiones siempre ocupan todo el ancho del grafico");
     }
+
+    if (ImGui::Button("Ajustar eje Y", ImVec2(-1, 0)))
+        FitVerticalAxis();
+    ImGui::SetItemTooltip("Ajusta el eje vertical a la entrada y salida visibles");
     
-    // Stride: dibuja 1 de cada 2^n muestras para mejorar rendimiento
+    // Stride: dibuja 1 de cada 2^n muestras de las capturas congeladas
+    // (en vivo se usa la pirámide min/max, que no pierde picos)
     if (ImGui::SliderInt("Stride", &stride_exp, 0, 10)) {
         settings->stride = (int)exp2(stride_exp);
         settings->byte_stride = sizeof(double) * settings->stride;
     }
     if (ImGui::IsItemHovered()) {
-        ImGui::SetTooltip("Optimizacion de rendimiento:\nStride = %d -> Dibuja 1 de cada %d muestras\n\nMayor = Mejor FPS, Menor detalle", 
+        ImGui::SetTooltip("Optimizacion de rendimiento en modo congelado:\nStride = %d -> Dibuja 1 de cada %d muestras\n\nMayor = Mejor FPS, Menor detalle\nEn vivo se dibuja min/max por pixel", 
                          settings->stride, settings->stride);
     }
     
     ImGui::Checkbox("Mostrar FPS", &settings->show_frame_time);
+    if (decimated_x) {
+        ImGui::Checkbox("Vista diezmada", &decimated_display);
+        ImGui::SetItemTooltip("Con muchas muestras por pixel dibuja la senal diezmada x%d (%.0f Hz)\n"
+                              "sin aliasing, en lugar de min/max por pixel", input_decimator.Factor(), decimated_rate);
+    }
+    ImGui::SliderInt("Memoria (MB)", &settings->memory_budget_mb, 16, 2048);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Presupuesto para los buffers de adquisicion (se aplica al conectar)\n"
+                         "Capacidad actual: %d s a %d Hz", max_time, settings->sampling_rate);
+    }
+    ImGui::Checkbox("Historial en disco", &settings->disk_history);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Guarda toda la sesion en un archivo temporal para navegar\n"
+                         "mas alla de %d s en modo congelado (se aplica al conectar)", max_time);
+    }
+    if (!settings->disk_history) {
+        ImGui::Checkbox("Historial comprimido", &settings->compressed_history);
+        ImGui::SetItemTooltip("Guarda los codigos de 8 bits comprimidos en RAM\n"
+                              "(delta + empaquetado de bits, se aplica al conectar)");
+    }
+    bool low_latency = low_latency_echo.load(std::memory_order_relaxed);
+    if (ImGui::Checkbox("Eco de baja latencia", &low_latency))
+        low_latency_echo.store(low_latency, std::memory_order_relaxed);
+    ImGui::SetItemTooltip("Convierte, filtra, cuantiza y envia cada lote antes de guardarlo\n"
+                          "en los buffers, las piramides y el historial");
     ImGui::Spacing();
 
     // === SECCIÓN CONEXIÓN ===
@@ -363,6 +509,14 @@ void MainWindow::DrawSidebar()
     if (settings->port.empty()) {
         ImGui::SetItemTooltip("Selecciona un dispositivo primero");
     }
+
+    // SerialWorker se detuvo porque no pudo comprometer memoria: desconectar ordenadamente
+    if (memory_error.load()) {
+        if (started)
+            ToggleConnection();
+        ImGui::TextColored(ImVec4(0.9f, 0.1f, 0.1f, 1.0f), "Sin memoria para los buffers");
+        ImGui::SetItemTooltip("La adquisicion se detuvo: reduce Memoria (MB) y vuelve a conectar");
+    }
     ImGui::Spacing();
 
     // Botón Congelar/Reanudar (solo visible cuando hay conexión activa)
@@ -383,11 +537,23 @@ void MainWindow::DrawSidebar()
         ImGui::SetItemTooltip("Congela la visualización para analizar sin detener la adquisición");
     }
 
+    DrawSnapshots();
+
+    // Exportar el rango visible desde el historial (las páginas del archivo se cargan bajo demanda)
+    if (frozen && HistoryAvailable()) {
+        ImGui::Spacing();
+        if (ImGui::Button("Exportar rango visible", ImVec2(-1, 0)))
+            ExportHistory(frozen_left_limit, frozen_right_limit);
+        ImGui::SetItemTooltip("Guarda tiempo, entrada y salida del rango visible en un CSV");
+    }
+
     // === SECCIÓN INFORMACIÓN (siempre en la parte inferior del sidebar) ===
-    float info_start_y = ImGui::GetWindowHeight() - 80;
+    // Se usa el alto medido en el frame anterior porque la cantidad de líneas varía
+    float info_start_y = ImGui::GetWindowHeight() - info_height;
     if (ImGui::GetCursorPosY() < info_start_y) {
         ImGui::SetCursorPosY(info_start_y);
     }
+    info_start_y = ImGui::GetCursorPosY();
     
     ImGui::Separator();
     ImGui::Spacing();
@@ -401,11 +567,13 @@ void MainWindow::DrawSidebar()
     // Tiempo transcurrido (del snapshot congelado o de datos en vivo)
     double elapsed = 0.0;
     if (started) {
-        if (frozen && !frozen_dataX.empty()) {
-            elapsed = frozen_dataX.back();
+        if (frozen && active_snapshot != 0) {
+            auto lock = snapshots.Lock();
+            if (auto snapshot = snapshots.Find(active_snapshot))
+                elapsed = snapshot->last_time;
         }
-        else if (!frozen && scrollX && scrollX->count() > 0) {
-            elapsed = scrollX->back();
+        else if (!frozen && scrollX && live_view.count > 0) {
+            elapsed = scrollX->storage()[live_view.start + live_view.count - 1];
         }
     }
     ImGui::Text("Tiempo: %.1fs", elapsed);
@@ -415,25 +583,92 @@ void MainWindow::DrawSidebar()
         ImGui::TextColored(ImVec4(0.110f, 0.784f, 0.035f, 1.0f), "[CONGELADO]");
     }
     
+    // Historial en disco: duración, velocidad de volcado y latencia de lectura en frío
+    if (history.IsOpen()) {
+        HistoryStats stats = history.Stats();
+        ImGui::Text("Historial: %.0fs", history.Size() / (double)settings->sampling_rate);
+        ImGui::Text("Volcado: %.0f MB/s  Lectura: %.2f ms", stats.spill_mb_per_s, stats.read_ms);
+        if (stats.lost_chunks > 0)
+            ImGui::TextColored(ImVec4(0.9f, 0.1f, 0.1f, 1.0f), "Bloques perdidos: %llu", stats.lost_chunks);
+    }
+    else if (code_history.IsOpen()) {
+        CompressionStats stats = code_history.Stats();
+        ImGui::Text("Historial: %.0fs (%.1f MB)", stats.samples / (double)settings->sampling_rate, stats.bytes / 1048576.0);
+        ImGui::Text("Compresion: x%.1f (x%.0f vs double)", stats.ratio_codes, stats.ratio_doubles);
+        ImGui::SetItemTooltip("Codificacion: %.0f Msps  Decodificacion: %.0f Msps",
+                              stats.encode_msps, stats.decode_msps);
+    }
+
+    // Memoria: residente del proceso y comprometida por los buffers de adquisición
+    if (scrollX) {
+        size_t buffers = scrollX->committed_bytes() + scrollY->committed_bytes() + filter_scrollY->committed_bytes();
+        size_t reserved = scrollX->reserved_bytes() + scrollY->reserved_bytes() + filter_scrollY->reserved_bytes();
+        ImGui::Text("Memoria: %.0f MB", ReservedMemory::ResidentBytes() / 1048576.0);
+        ImGui::SetItemTooltip("Memoria residente (working set) del proceso\nComprometida: %.0f MB",
+                              ReservedMemory::CommittedBytes() / 1048576.0);
+        ImGui::Text("Buffers: %.1f / %.0f MB", buffers / 1048576.0, reserved / 1048576.0);
+        ImGui::SetItemTooltip("Memoria comprometida / reservada para %d s de datos", max_time);
+    }
+    // RMS de los últimos 10 s a partir de los resúmenes por bloque
+    if (input_blocks && elapsed > 0) {
+        double rms_in = SummarizeRange(*input_blocks, scrollY, elapsed - 10, elapsed).rms();
+        double rms_out = SummarizeRange(*output_blocks, filter_scrollY, elapsed - 10, elapsed).rms();
+        ImGui::Text("RMS 10s: %.3f / %.3f V", rms_in, rms_out);
+        ImGui::SetItemTooltip("Valor eficaz de la entrada / salida en los ultimos 10 segundos");
+    }
+
+    if (started) {
+        ImGui::Text("Inicio: %.1f ms", start_latency_ms);
+        ImGui::SetItemTooltip("Buffers reutilizados: %llu / creados: %llu",
+                              session_pool.Reused(), session_pool.Created());
+
+        // Latencia del eco en la PC: desde que llega el lote hasta que se escribe la respuesta
+        const EchoLatency& current = echo_latency[low_latency_echo.load(std::memory_order_relaxed) ? 1 : 0];
+        ImGui::Text("Eco: %.0f us (pico %.0f us)", current.sent_us.load(std::memory_order_relaxed),
+                    current.peak_us.load(std::memory_order_relaxed));
+        ImGui::SetItemTooltip("Lote leido -> respuesta escrita (promedio, pico)\n"
+                              "Normal: %.1f us hasta escribir, %.1f us total, pico %.1f us\n"
+                              "Baja latencia: %.1f us hasta escribir, %.1f us total, pico %.1f us",
+                              echo_latency[0].ready_us.load(std::memory_order_relaxed), echo_latency[0].sent_us.load(std::memory_order_relaxed),
+                              echo_latency[0].peak_us.load(std::memory_order_relaxed),
+                              echo_latency[1].ready_us.load(std::memory_order_relaxed), echo_latency[1].sent_us.load(std::memory_order_relaxed),
+                              echo_latency[1].peak_us.load(std::memory_order_relaxed));
+    }
+
     // FPS (si está habilitado en configuración)
     if (settings->show_frame_time) {
         ImGuiIO& io = ImGui::GetIO();
         ImGui::Text("FPS: %.1f", io.Framerate);
     }
 
+    info_height = ImGui::GetCursorPosY() - info_start_y + ImGui::GetStyle().WindowPadding.y;
+
     ImGui::End();
 }
 
-void MainWindow::Start() {
+bool MainWindow::Start() {
+    auto start_begin = clock::now();
     CreateBuffers();
+    UpdateSampleMapping();
+
+    // Sin memoria para el primer lote no se inicia la adquisición (se informa en el sidebar)
+    memory_error = !PrepareBuffers(read_buffer_size);
+    if (memory_error)
+        return false;
 
     // Inicializar límites con la escala temporal actual
     left_limit = 0;
     right_limit = max_time_visible;
 
     // Configurar parámetros de filtros según frecuencia de muestreo
+    processing_chain.Reset();
+    device_link.Reset();
+    for (EchoLatency& stats : echo_latency) {
+        stats.ready_us.store(0, std::memory_order_relaxed);
+        stats.sent_us.store(0, std::memory_order_relaxed);
+        stats.peak_us.store(0, std::memory_order_relaxed);
+    }
     SetupFilter();
-    ResetFilters();
 
     // Iniciar hilos de trabajo en paralelo
     do_serial_work = true;
@@ -444,6 +679,8 @@ void MainWindow::Start() {
     serial.open(settings->port, settings->baud_rate);
     serial_thread = std::thread(&MainWindow::SerialWorker, this);
     start_time = clock::now();
+    start_latency_ms = std::chrono::duration<double, std::milli>(start_time - start_begin).count();
+    return true;
 }
 
 void MainWindow::Stop() {
@@ -462,44 +699,832 @@ void MainWindow::Stop() {
     serial.close();
 }
 
-void MainWindow::SelectFilter(Filter filter) {
-    selected_filter = filter;
-    
-    // Ajustar rango de frecuencia de corte según el tipo de filtro
-    switch (selected_filter)
+bool MainWindow::PrepareBuffers(uint32_t count) {
+    if (!scrollX->prepare(count) || !scrollY->prepare(count) || !filter_scrollY->prepare(count))
+        return false;
+    // Las señales diezmadas reciben menos muestras por lote: 'count' las cubre de sobra
+    return !decimated_x || (decimated_x->prepare(count) && decimated_y->prepare(count) && decimated_filtered->prepare(count));
+}
+
+void MainWindow::SetupFilter() {
+    filter_designer.Request(filter_spec, settings->sampling_rate);
+}
+
+void MainWindow::DrawFilterDesigner() {
+    // Botones de selección de banda
+    const char* bandas[] = { "Ninguno", "Pasa bajos", "Pasa altos", "Pasa banda", "Rechaza banda", "Notch" };
+    for (int i = 0; i < std::size(bandas); i++)
     {
-        case Filter::LowPass:
-            // Pasa bajos: frecuencia de corte entre 1 Hz y Nyquist/2
-            min_cutoff_frequency = 1;
-            max_cutoff_frequency = settings->sampling_rate / 4;
-            break;
-        case Filter::HighPass:
-            // Pasa altos: frecuencia de corte entre Nyquist/2 y casi Nyquist
-            min_cutoff_frequency = settings->sampling_rate / 4;
-            max_cutoff_frequency = settings->sampling_rate / 2 - 1;
-            break;
-        case Filter::None:
-            break;
+        if (i > 0)
+            ImGui::SameLine();
+
+        if (i == (int)filter_spec.band) {
+            ImGui::PushStyleColor(ImGuiCol_Button, ImGui::GetStyle().Colors[ImGuiCol_ButtonActive]);
+            ImGui::Button(bandas[i]);
+            ImGui::PopStyleColor();
+        }
+        else if (ImGui::Button(bandas[i])) {
+            filter_spec.band = (FilterBand)i;
+            SetupFilter();
+        }
     }
+
+    if (filter_spec.band == FilterBand::None)
+        return;
+
+    bool changed = false;
+    double nyquist = settings->sampling_rate / 2.0;
+
+    // Familia y orden (el notch RBJ es siempre una sección); los FIR se ajustan por coeficientes
+    bool fir = filter_spec.band != FilterBand::Notch && IsFir(filter_spec.family);
+    if (filter_spec.band != FilterBand::Notch) {
+        const char* familias[] = { "Butterworth", "Chebyshev I", "Chebyshev II", "FIR ventana", "FIR Parks-McClellan" };
+        int family = (int)filter_spec.family;
+        if (ImGui::Combo("Familia", &family, familias, (int)std::size(familias))) {
+            filter_spec.family = (FilterFamily)family;
+            changed = true;
+        }
+        if (fir) {
+            int max_taps = filter_spec.family == FilterFamily::FirRemez ? FilterDesign::max_remez_taps : FilterDesign::max_taps;
+            changed |= ImGui::SliderInt("Coeficientes", &filter_spec.taps, 3, max_taps, "%d", ImGuiSliderFlags_Logarithmic);
+        }
+        else {
+            changed |= ImGui::SliderInt("Orden", &filter_spec.order, 1, FilterDesign::max_order);
+        }
+    }
+
+    // Frecuencias (escala logarítmica: el rango va de 0.1 Hz a Nyquist)
+    double min_frequency = 0.1;
+    bool band = filter_spec.band != FilterBand::LowPass && filter_spec.band != FilterBand::HighPass;
+    changed |= ImGui::SliderScalar(band ? "Frecuencia central" : "Frecuencia de corte", ImGuiDataType_Double,
+                                   &filter_spec.frequency, &min_frequency, &nyquist, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+    if (band)
+        changed |= ImGui::SliderScalar("Ancho de banda", ImGuiDataType_Double,
+                                       &filter_spec.width, &min_frequency, &nyquist, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+
+    if (filter_spec.band != FilterBand::Notch && filter_spec.family == FilterFamily::ChebyshevI) {
+        double min_ripple = 0.1, max_ripple = 6;
+        changed |= ImGui::SliderScalar("Rizado", ImGuiDataType_Double, &filter_spec.ripple_db, &min_ripple, &max_ripple, "%.1f dB");
+    }
+    if (filter_spec.band != FilterBand::Notch && filter_spec.family == FilterFamily::ChebyshevII) {
+        double min_attenuation = 10, max_attenuation = 100;
+        changed |= ImGui::SliderScalar("Atenuacion", ImGuiDataType_Double, &filter_spec.stopband_db, &min_attenuation, &max_attenuation, "%.0f dB");
+    }
+
+    if (filter_spec.band != FilterBand::Notch && filter_spec.family == FilterFamily::FirRemez)
+        changed |= ImGui::SliderScalar("Transicion", ImGuiDataType_Double,
+                                       &filter_spec.transition, &min_frequency, &nyquist, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+
+    if (changed)
+        SetupFilter();
+
+    // Costo del diseño activo (el diseño corre en su propio hilo, el filtrado en SerialWorker)
+    double filter_ns = 0;
+    for (size_t i = 0; i < chain_config.stages.size(); i++) {
+        if (chain_config.stages[i].type == StageType::Filter)
+            filter_ns = processing_chain.StageNs((int)i);
+    }
+    if (auto design = filter_designer.Current(); design && design->fir) {
+        // FIR: método elegido por medición (directo frente a overlap-save) y retardo resultante
+        const FirKernel& kernel = *design->fir;
+        bool fft = kernel.method == FirMethod::Fft;
+        uint32_t latency = (uint32_t)kernel.taps.size() / 2 + (fft ? FirKernel::fft_block : 0);
+        ImGui::TextDisabled("Diseno: %.0f us  Coeficientes: %d  Filtrado: %.1f ns/muestra",
+                            design->design_us, (int)kernel.taps.size(), filter_ns);
+        ImGui::TextDisabled("Metodo: %s (directo %.1f ns, FFT %.1f ns)", fft ? "FFT" : "directo", kernel.direct_ns, kernel.fft_ns);
+        if (design->window_fallback) {
+            ImGui::TextDisabled("Parks-McClellan sin solucion: diseno por ventana");
+            ImGui::SetItemTooltip("Las bandas no caben con esta transicion o el rizado optimo queda por debajo\n"
+                                  "de la precision numerica (transicion ancha con muchos coeficientes)");
+        }
+        ImGui::TextDisabled("Retardo: %u muestras (%.1f ms)", latency, 1000.0 * latency / design->sampling_rate);
+    }
+    else if (design) {
+        ImGui::TextDisabled("Diseno: %.0f us  Secciones: %d  Filtrado: %.1f ns/muestra",
+                            design->design_us, design->sections, filter_ns);
+    }
+    const LiveFilter& live_filter = processing_chain.Filter();
+    if (live_filter.Morphs() + live_filter.Crossfades() + live_filter.Adoptions() > 0) {
+        ImGui::TextDisabled("Cambios: %llu sin reinicio, %llu con fundido, %llu promovidos",
+                            (unsigned long long)live_filter.Morphs(), (unsigned long long)live_filter.Crossfades(),
+                            (unsigned long long)live_filter.Adoptions());
+    }
+
+    // Fase cero sobre la captura congelada (solo IIR: los FIR ya tienen fase lineal)
+    if (auto design = filter_designer.Current(); design && design->sections > 0) {
+        ImGui::Checkbox("Fase cero en capturas", &zero_phase_enabled);
+        ImGui::SetItemTooltip("En modo congelado, Salida muestra el filtro aplicado hacia adelante y hacia atras "
+                              "sobre la entrada: sin retardo y con la magnitud al cuadrado");
+        if (zero_phase_enabled && frozen) {
+            auto result = zero_phase.Current();
+            if (result && result->snapshot_id == active_snapshot)
+                ImGui::TextDisabled("Fase cero: %.0f ms, %d tramos, margen %u muestras%s", result->elapsed_ms,
+                                    result->segments, result->warmup, result->design != design ? " (recalculando)" : "");
+            else
+                ImGui::TextDisabled("Fase cero: calculando...");
+        }
+    }
+
+    std::string error = filter_designer.Error();
+    if (!error.empty())
+        ImGui::TextColored(ImVec4(0.9f, 0.1f, 0.1f, 1.0f), "Diseno rechazado: %s", error.c_str());
 }
 
-void MainWindow::SetupFilter() {
-    switch (selected_filter)
+// Colores de los candidatos en Salida, Espectro y la lista
+static const ImVec4 candidate_colors[FilterLanes::max_lanes] = {
+    { 0.95f, 0.35f, 0.35f, 0.9f }, { 0.35f, 0.65f, 1.00f, 0.9f }, { 1.00f, 0.80f, 0.20f, 0.9f }, { 0.80f, 0.45f, 1.00f, 0.9f },
+    { 0.30f, 0.90f, 0.85f, 0.9f }, { 1.00f, 0.55f, 0.15f, 0.9f }, { 0.95f, 0.50f, 0.80f, 0.9f }, { 0.70f, 0.70f, 0.70f, 0.9f },
+};
+
+void MainWindow::UpdateCandidates() {
+    FilterLanes& lanes = processing_chain.Lanes();
+
+    // Solo IIR: los carriles son cascadas de biquads
+    bool iir = filter_spec.band != FilterBand::None && (filter_spec.band == FilterBand::Notch || !IsFir(filter_spec.family));
+    if (!candidates_enabled || !iir) {
+        if (candidates) {
+            candidates = nullptr;
+            lanes.Configure(nullptr);
+        }
+        return;
+    }
+
+    // Mismo filtro con la frecuencia (escala logarítmica) o el orden repartidos en el rango
+    FilterSpec specs[FilterLanes::max_lanes];
+    bool order = candidates_parameter == 1 && filter_spec.band != FilterBand::Notch;
+    for (int lane = 0; lane < candidates_count; lane++) {
+        double t = candidates_count > 1 ? (double)lane / (candidates_count - 1) : 0;
+        specs[lane] = filter_spec;
+        if (order)
+            specs[lane].order = (int)std::lround(candidates_order_from + t * (candidates_order_to - candidates_order_from));
+        else
+            specs[lane].frequency = candidates_from * std::pow(candidates_to / candidates_from, t);
+    }
+
+    bool same = candidates && candidates->count == candidates_count && candidates_rate == settings->sampling_rate;
+    for (int lane = 0; same && lane < candidates_count; lane++)
+        same = specs[lane] == candidate_specs[lane];
+    if (same)
+        return;
+
+    // Diseños IIR: unos microsegundos cada uno, se hacen en la UI sin pasar por FilterDesigner
+    auto next = std::make_shared<FilterLanes::Candidates>();
+    next->count = candidates_count;
+    for (int lane = 0; lane < candidates_count; lane++) {
+        candidate_specs[lane] = specs[lane];
+        try {
+            next->designs[lane] = DesignFilter(specs[lane], settings->sampling_rate);
+        }
+        catch (const std::exception&) {
+            next->designs[lane] = nullptr;  // Carril sin filtro (se indica en la lista)
+        }
+    }
+    candidates = next;
+    candidates_rate = settings->sampling_rate;
+    lanes.Configure(candidates);
+}
+
+void MainWindow::DrawCandidates() {
+    UpdateCandidates();
+    if (!ImGui::TreeNode("Comparar candidatos"))
+        return;
+
+    ImGui::Checkbox("Activar", &candidates_enabled);
+    ImGui::SetItemTooltip("Filtra la entrada de la etapa Filtro con varios candidatos a la vez y los superpone en Salida y Espectro");
+    ImGui::SameLine();
+    if (ImGui::RadioButton("4", candidates_count == 4))
+        candidates_count = 4;
+    ImGui::SameLine();
+    if (ImGui::RadioButton("8", candidates_count == 8))
+        candidates_count = 8;
+
+    if (filter_spec.band == FilterBand::None || (filter_spec.band != FilterBand::Notch && IsFir(filter_spec.family))) {
+        ImGui::TextDisabled("Elegir un filtro IIR en la seccion Filtro");
+        ImGui::TreePop();
+        return;
+    }
+
+    const char* parametros[] = { "Frecuencia", "Orden" };
+    if (filter_spec.band != FilterBand::Notch)
+        ImGui::Combo("Variar", &candidates_parameter, parametros, (int)std::size(parametros));
+    if (candidates_parameter == 1 && filter_spec.band != FilterBand::Notch) {
+        ImGui::SliderInt("Desde", &candidates_order_from, 1, FilterDesign::max_order);
+        ImGui::SliderInt("Hasta", &candidates_order_to, 1, FilterDesign::max_order);
+    }
+    else {
+        double min_frequency = 0.1, nyquist = settings->sampling_rate / 2.0;
+        ImGui::SliderScalar("Desde", ImGuiDataType_Double, &candidates_from, &min_frequency, &nyquist, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderScalar("Hasta", ImGuiDataType_Double, &candidates_to, &min_frequency, &nyquist, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+    }
+
+    // Lista con el color de cada candidato; "Usar" lo promueve al filtro vivo sin transitorio
+    if (candidates) {
+        for (int lane = 0; lane < candidates->count; lane++) {
+            ImGui::PushID(lane);
+            const FilterSpec& spec = candidate_specs[lane];
+            if (candidates_parameter == 1 && filter_spec.band != FilterBand::Notch)
+                ImGui::TextColored(candidate_colors[lane], "%d: orden %d", lane + 1, spec.order);
+            else
+                ImGui::TextColored(candidate_colors[lane], "%d: %.1f Hz", lane + 1, spec.frequency);
+            ImGui::SameLine();
+            if (!candidates->designs[lane]) {
+                ImGui::TextDisabled("(rechazado)");
+            }
+            else if (ImGui::Button("Usar")) {
+                // Primero la promoción (SerialWorker adopta el estado del carril) y después el
+                // diseño publicado, que la etapa Filtro ya tiene cargado
+                filter_spec = spec;
+                processing_chain.Lanes().Promote(lane);
+                filter_designer.Publish(candidates->designs[lane]);
+            }
+            ImGui::PopID();
+        }
+
+        double filter_ns = 0;
+        for (size_t i = 0; i < chain_config.stages.size(); i++) {
+            if (chain_config.stages[i].type == StageType::Filter)
+                filter_ns = processing_chain.StageNs((int)i);
+        }
+        ImGui::TextDisabled("%d candidatos: %.1f ns/muestra (filtro vivo %.1f ns)",
+                            processing_chain.Lanes().Lanes(), processing_chain.Lanes().Ns(), filter_ns);
+    }
+    ImGui::TreePop();
+}
+
+void MainWindow::DrawProcessingChain() {
+    if (!ImGui::TreeNode("Cadena de procesamiento"))
+        return;
+
+    bool changed = false;
+    double nyquist = settings->sampling_rate / 2.0;
+    auto& stages = chain_config.stages;
+
+    // La derivación elige qué señal se grafica en Salida (al dispositivo va siempre la salida final)
+    if (ImGui::RadioButton("Entrada", chain_config.tap == -1)) {
+        chain_config.tap = -1;
+        changed = true;
+    }
+
+    int move_from = -1, move_to = -1, remove = -1;
+    for (int i = 0; i < (int)stages.size(); i++) {
+        StageConfig& stage = stages[i];
+        ImGui::PushID(i);
+
+        if (ImGui::RadioButton(StageName(stage.type), chain_config.tap == i)) {
+            chain_config.tap = i;
+            changed = true;
+        }
+        ImGui::SameLine();
+        // Más del 10 % del período de muestreo en una sola etapa: se marca en rojo
+        double stage_ns = processing_chain.StageNs(i);
+        if (stage_ns > 1e8 / settings->sampling_rate)
+            ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "%.1f ns", stage_ns);
+        else
+            ImGui::TextDisabled("%.1f ns", stage_ns);
+        ImGui::SameLine();
+        if (ImGui::Button("^") && i > 0) {
+            move_from = i;
+            move_to = i - 1;
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("v") && i + 1 < (int)stages.size()) {
+            move_from = i;
+            move_to = i + 1;
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("x"))
+            remove = i;
+
+        switch (stage.type) {
+            case StageType::DcBlock: {
+                double min_cutoff = 0.01, max_cutoff = 10;
+                changed |= ImGui::SliderScalar("Corte", ImGuiDataType_Double, &stage.cutoff, &min_cutoff, &max_cutoff, "%.2f Hz", ImGuiSliderFlags_Logarithmic);
+                break;
+            }
+            case StageType::Gain: {
+                double min_gain = -40, max_gain = 40;
+                changed |= ImGui::SliderScalar("Ganancia", ImGuiDataType_Double, &stage.gain_db, &min_gain, &max_gain, "%.1f dB");
+                break;
+            }
+            case StageType::Notch: {
+                double min_frequency = 0.1;
+                changed |= ImGui::SliderScalar("Frecuencia", ImGuiDataType_Double, &stage.frequency, &min_frequency, &nyquist, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+                changed |= ImGui::SliderScalar("Ancho", ImGuiDataType_Double, &stage.width, &min_frequency, &nyquist, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+                break;
+            }
+            case StageType::Filter:
+                ImGui::TextDisabled("Diseno de la seccion Filtro");
+                break;
+            case StageType::Decimate:
+                changed |= ImGui::SliderInt("Factor", &stage.factor, 1, 64);
+                break;
+            case StageType::MainsCancel: {
+                if (ImGui::RadioButton("50 Hz", stage.frequency == 50)) {
+                    stage.frequency = 50;
+                    changed = true;
+                }
+                ImGui::SameLine();
+                if (ImGui::RadioButton("60 Hz", stage.frequency == 60)) {
+                    stage.frequency = 60;
+                    changed = true;
+                }
+                changed |= ImGui::SliderInt("Armonicos", &stage.harmonics, 1, MainsCanceller::max_harmonics);
+                double min_step = 0.001, max_step = 1;
+                changed |= ImGui::SliderScalar("Adaptacion", ImGuiDataType_Double, &stage.step, &min_step, &max_step, "%.3f", ImGuiSliderFlags_Logarithmic);
+
+                // Estado publicado por SerialWorker: frecuencia enganchada, amplitud y atenuación
+                ProcessingChain::MainsStatus mains = processing_chain.Mains(i);
+                ImGui::TextDisabled("Red %.3f Hz, %.3f V", mains.frequency, mains.amplitude);
+                ImGui::TextDisabled("Atenuacion %.1f dB", mains.attenuation_db);
+                break;
+            }
+            case StageType::MovingAverage:
+            case StageType::Cic: {
+                changed |= ImGui::SliderInt("Longitud", &stage.length, 1, CicFilter::max_length, "%d", ImGuiSliderFlags_Logarithmic);
+                if (stage.type == StageType::Cic)
+                    changed |= ImGui::SliderInt("Etapas", &stage.order, 1, CicFilter::max_stages);
+                changed |= ImGui::Checkbox("Compensar caida", &stage.compensate);
+
+                // Costo constante: solo cambian el retardo y el primer cero de la respuesta
+                int order = stage.type == StageType::Cic ? stage.order : 1;
+                double delay = order * (stage.length - 1) / 2.0 + (stage.compensate ? stage.length : 0);
+                ImGui::TextDisabled("Retardo %.2f ms, primer cero %.1f Hz", delay * 1000 / settings->sampling_rate,
+                    (double)settings->sampling_rate / stage.length);
+                break;
+            }
+            case StageType::Median:
+            case StageType::Hampel: {
+                changed |= ImGui::SliderInt("Ventana", &stage.length, 3, RunningMedian::max_window, "%d", ImGuiSliderFlags_Logarithmic);
+                if (stage.type == StageType::Hampel) {
+                    double min_threshold = 1, max_threshold = 10;
+                    changed |= ImGui::SliderScalar("Umbral", ImGuiDataType_Double, &stage.threshold, &min_threshold, &max_threshold, "%.1f MAD");
+                    ImGui::TextDisabled("Reemplazadas: %llu", (unsigned long long)processing_chain.Replaced(i));
+                }
+                ImGui::TextDisabled("Retardo %.2f ms", (stage.length | 1) / 2 * 1000.0 / settings->sampling_rate);
+                break;
+            }
+            case StageType::Plugin: {
+                if (!stage.plugin)
+                    break;
+                ImGui::TextDisabled("%s (%s)", stage.plugin->name.c_str(), stage.plugin->path.filename().string().c_str());
+                for (size_t p = 0; p < stage.plugin->params.size(); p++) {
+                    const StagePlugin::Param& param = stage.plugin->params[p];
+                    changed |= ImGui::SliderScalar(param.name.c_str(), ImGuiDataType_Double, &stage.plugin_params[p], &param.min, &param.max, "%.3f");
+                }
+                ImGui::TextDisabled("Pico %.1f ns/muestra", processing_chain.StagePeakNs(i));
+                ImGui::SameLine();
+                if (ImGui::Button("Reiniciar"))
+                    processing_chain.ResetStage(i);
+                break;
+            }
+        }
+        ImGui::PopID();
+    }
+
+    if (move_from >= 0) {
+        std::swap(stages[move_from], stages[move_to]);
+        if (chain_config.tap == move_from)
+            chain_config.tap = move_to;
+        else if (chain_config.tap == move_to)
+            chain_config.tap = move_from;
+        changed = true;
+    }
+    if (remove >= 0) {
+        stages.erase(stages.begin() + remove);
+        if (chain_config.tap >= (int)stages.size() || chain_config.tap > remove)
+            chain_config.tap--;
+        changed = true;
+    }
+
+    // Agregar etapa al final (el filtro diseñado solo puede aparecer una vez)
+    bool has_filter = false;
+    for (const StageConfig& stage : stages)
+        has_filter |= stage.type == StageType::Filter;
+    if ((int)stages.size() < ProcessingChain::max_stages && ImGui::BeginCombo("Agregar", "Etapa...")) {
+        for (StageType type : { StageType::DcBlock, StageType::Gain, StageType::Notch, StageType::MainsCancel, StageType::MovingAverage, StageType::Cic, StageType::Median, StageType::Hampel, StageType::Filter, StageType::Decimate }) {
+            if (type == StageType::Filter && has_filter)
+                continue;
+            if (ImGui::Selectable(StageName(type))) {
+                stages.push_back({ type });
+                chain_config.tap = (int)stages.size() - 1;
+                changed = true;
+            }
+        }
+        // Plugins cargados: los parámetros empiezan en el valor inicial que declara cada uno
+        for (const auto& plugin : plugins.Loaded()) {
+            ImGui::PushID(plugin.get());
+            if (ImGui::Selectable(std::format("{} (plugin)", plugin->name).c_str())) {
+                StageConfig stage{ StageType::Plugin };
+                stage.plugin = plugin;
+                for (size_t p = 0; p < plugin->params.size(); p++)
+                    stage.plugin_params[p] = plugin->params[p].initial;
+                stages.push_back(stage);
+                chain_config.tap = (int)stages.size() - 1;
+                changed = true;
+            }
+            ImGui::PopID();
+        }
+        ImGui::EndCombo();
+    }
+
+    // Etapas nativas de la carpeta plugins (ver stage_plugin.h); se cargan las nuevas sin reiniciar
+    if (ImGui::Button("Buscar plugins"))
+        plugins.Scan(PluginRegistry::DefaultDirectory());
+    ImGui::SameLine();
+    ImGui::TextDisabled("%d cargados", (int)plugins.Loaded().size());
+    for (const std::string& error : plugins.Errors())
+        ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "%s", error.c_str());
+
+    if (changed)
+        processing_chain.Configure(chain_config);
+    ImGui::TreePop();
+}
+
+void MainWindow::UpdateResponse() {
+    auto design = filter_designer.Current();
+    if (design && design->sampling_rate != settings->sampling_rate)
+        design = nullptr;
+
+    double rate = settings->sampling_rate;
+    if (!response.Empty() && design == response_design && rate == response_rate && response_of_chain == response_key_chain &&
+        (!response_of_chain || chain_config == response_chain))
+        return;
+    response_design = design;
+    response_rate = rate;
+    response_key_chain = response_of_chain;
+    response_chain = chain_config;
+
+    LinearChain chain;
+    if (response_of_chain) {
+        chain = LinearizeChain(chain_config, chain_config.tap, rate, design.get());
+    }
+    else if (design) {
+        chain.sections.assign(design->coefficients, design->coefficients + design->sections);
+        chain.fir = design->fir;
+    }
+    response.Compute(chain.sections.data(), (int)chain.sections.size(), chain.fir ? &chain.fir->taps : nullptr, chain.gain, rate);
+}
+
+void MainWindow::DrawResponse() {
+    if (!ImGui::TreeNode("Respuesta en frecuencia"))
+        return;
+
+    if (ImGui::RadioButton("Filtro", !response_of_chain))
+        response_of_chain = false;
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Cadena hasta la derivacion", response_of_chain))
+        response_of_chain = true;
+    const char* vistas[] = { "Magnitud", "Fase", "Retardo de grupo" };
+    ImGui::Combo("Vista", &response_view, vistas, (int)std::size(vistas));
+
+    UpdateResponse();
+    if (ImPlot::BeginPlot("##respuesta", { -1, 200 }, ImPlotFlags_NoLegend)) {
+        ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+        ImPlot::SetupAxisFormat(ImAxis_X1, MetricFormatter, (void*)"Hz");
+        ImPlot::SetupAxis(ImAxis_X1, nullptr, ImPlotAxisFlags_AutoFit);
+
+        const double* values = response.MagnitudeDb();
+        if (response_view == 0) {
+            // La magnitud en la banda de rechazo puede caer cientos de dB: rango fijo ajustable
+            ImPlot::SetupAxisFormat(ImAxis_Y1, "%.0f dB");
+            ImPlot::SetupAxisLimits(ImAxis_Y1, -120, 10, ImGuiCond_FirstUseEver);
+        }
+        else {
+            values = response_view == 1 ? response.PhaseDeg() : response.DelayMs();
+            ImPlot::SetupAxisFormat(ImAxis_Y1, response_view == 1 ? "%.0f deg" : "%.1f ms");
+            ImPlot::SetupAxis(ImAxis_Y1, nullptr, ImPlotAxisFlags_AutoFit);
+        }
+
+        ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(1.0f, 0.6f, 0.1f, 1.0f));
+        ImPlot::PlotLine("", response.Frequency(), values, FilterResponse::points);
+        ImPlot::PopStyleColor();
+        ImPlot::EndPlot();
+    }
+    ImGui::TextDisabled("%d puntos en %.0f us", FilterResponse::points, response.ComputeUs());
+    ImGui::TreePop();
+}
+
+void MainWindow::DrawDeviceFilter() {
+    if (!ImGui::TreeNode("Filtro en el dispositivo"))
+        return;
+
+    ImGui::BeginDisabled(!started);
+    auto design = filter_designer.Current();
+    if (ImGui::Button("Cuantizar y enviar")) {
+        device_filter_error = "No hay un diseno activo";
+        device_filter_valid = design && QuantizeDesign(*design, device_filter, device_filter_error);
+        if (device_filter_valid) {
+            device_snr_db = QuantizationSnrDb(*design, device_filter);
+            device_link.Upload(device_filter);
+        }
+    }
+    ImGui::SetItemTooltip("Cuantiza el diseno actual (IIR, hasta orden 8) a Q15/Q14 y lo envia al AVR");
+
+    ImGui::BeginDisabled(!device_filter_valid);
+    bool on_device = device_link.OnDevice();
+    if (ImGui::Checkbox("Filtrar en el dispositivo", &on_device))
+        device_link.SetOnDevice(on_device);
+    ImGui::SetItemTooltip("El AVR aplica el filtro; Salida muestra la emulacion exacta en la PC");
+
+    // Prueba de igualdad: el dispositivo y la PC filtran la misma secuencia y comparan el CRC
+    if (ImGui::Button("Verificar")) {
+        device_test_seed = (uint16_t)(device_test_seed * 75 + 74);  // Semilla distinta en cada prueba
+        device_expected_crc = EmulateTest(device_filter, device_test_seed, device_test_samples);
+        device_tests_requested = device_link.Status().tests + 1;
+        device_link.Send(TestCommand(device_test_seed));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Leer ciclos"))
+        device_link.Send(StatusCommand());
+    ImGui::EndDisabled();
+    ImGui::EndDisabled();
+
+    DeviceStatus status = device_link.Status();
+    if (device_filter_valid) {
+        ImGui::TextDisabled("Secciones: %d  SNR de cuantizacion: %.1f dB", device_filter.secciones, device_snr_db);
+        if (status.acks > 0)
+            ImGui::TextDisabled("Coeficientes: %s", status.ack_ok ? "recibidos" : "error de suma, reenviar");
+    }
+    else if (!device_filter_error.empty()) {
+        ImGui::TextColored(ImVec4(0.9f, 0.1f, 0.1f, 1.0f), "%s", device_filter_error.c_str());
+    }
+
+    if (device_tests_requested > 0) {
+        if (status.tests < device_tests_requested)
+            ImGui::TextDisabled("Verificando %d muestras...", device_test_samples);
+        else if (status.test_crc == device_expected_crc)
+            ImGui::TextColored(ImVec4(0.1f, 0.8f, 0.1f, 1.0f), "Identico bit a bit (CRC %04X)", status.test_crc);
+        else
+            ImGui::TextColored(ImVec4(0.9f, 0.1f, 0.1f, 1.0f), "Distinto: CRC %04X, esperado %04X", status.test_crc, device_expected_crc);
+    }
+
+    // Presupuesto: ciclos de CPU entre dos muestras (el filtro corre en el loop, no en la ISR)
+    if (status.cycle_reports > 0) {
+        double budget = device_clock / settings->sampling_rate;
+        ImGui::TextDisabled("Ciclos por muestra: %d prom, %d max de %.0f (%.0f%%)",
+                            status.cycles_average, status.cycles_max, budget, 100.0 * status.cycles_max / budget);
+    }
+    ImGui::TreePop();
+}
+
+void MainWindow::RunFilterBenchmark() {
+    filter_benchmark.clear();
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> noise(-6, 6);
+
+    for (int rate : frecuencias) {
+        // Un segundo de señal (al menos 64k muestras para que la medición sea estable)
+        uint32_t count = rate < 65536 ? 65536 : rate;
+        std::vector<double> input(count), output(count);
+        for (double& v : input)
+            v = noise(random);
+
+        Iir::Butterworth::LowPass<8> reference;
+        reference.setup(rate, rate / 8.0);
+        BiquadCascade cascade;
+        cascade.LoadFrom(reference);
+
+        // Mismo tamaño de lote que SerialWorker
+        auto in_batches = [&](auto&& process) {
+            for (uint32_t i = 0; i < count; i += 128)
+                process(&output[i], count - i < 128 ? count - i : 128);
+        };
+        auto measure = [&](auto&& run) {
+            output = input;
+            auto begin = clock::now();
+            run();
+            return std::chrono::duration<double, std::nano>(clock::now() - begin).count() / count / cascade.Sections();
+        };
+
+        FilterBenchmark result{ rate };
+        result.iir_ns = measure([&] {
+            for (uint32_t i = 0; i < count; i++)
+                output[i] = reference.filter(output[i]);
+        });
+        result.scalar_ns = measure([&] {
+            in_batches([&](double* data, uint32_t n) { cascade.ProcessScalar(data, n); });
+        });
+        result.unrolled_ns = measure([&] {
+            in_batches([&](double* data, uint32_t n) { cascade.ProcessUnrolled(data, n); });
+        });
+        result.avx2_ns = !CpuHasAvx2() ? NAN : measure([&] {
+            in_batches([&](double* data, uint32_t n) { cascade.ProcessAvx2(data, n); });
+        });
+        filter_benchmark.push_back(result);
+    }
+
+    // Órdenes 1 a max_order (Butterworth pasa bajos) a la frecuencia actual: la cantidad de
+    // secciones cambia en tiempo de ejecución y el kernel se elige una vez por diseño
+    order_benchmark.clear();
     {
-        case Filter::LowPass:
-            lowpass_filter.setup(settings->sampling_rate, cutoff_frequency[1]);
-            break;
-        case Filter::HighPass:
-            highpass_filter.setup(settings->sampling_rate, cutoff_frequency[2]);
-            break;
-        case Filter::None:
-            break;
+        uint32_t count = 65536;
+        std::vector<double> input(count), output(count);
+        for (double& v : input)
+            v = noise(random);
+        FilterSpec spec;
+        spec.band = FilterBand::LowPass;
+        spec.frequency = settings->sampling_rate / 8.0;
+        for (int order = 1; order <= FilterDesign::max_order; order++) {
+            spec.order = order;
+            auto design = DesignFilter(spec, settings->sampling_rate);
+            BiquadCascade cascade;
+            cascade.SetCoefficients(design->coefficients, design->sections);
+            auto measure = [&](bool table) {
+                output = input;
+                auto begin = clock::now();
+                for (uint32_t i = 0; i < count; i += 128) {
+                    if (table)
+                        cascade.Process(&output[i], 128);
+                    else
+                        cascade.ProcessScalar(&output[i], 128);
+                }
+                return std::chrono::duration<double, std::nano>(clock::now() - begin).count() / count;
+            };
+            order_benchmark.push_back({ order, design->sections, measure(false), measure(true) });
+        }
     }
+
+    // Conversión ADC ↔ voltaje a la frecuencia máxima (un segundo de códigos, lotes de 128 como en
+    // SerialWorker): fórmula muestra a muestra frente a la tabla y al cuantizador por lotes
+    {
+        uint32_t count = frecuencias[std::size(frecuencias) - 1];
+        std::vector<uint8_t> codes(count), quantized(count);
+        std::vector<double> voltages(count);
+        for (uint8_t& code : codes)
+            code = (uint8_t)(random() % 255);
+        SampleMapping mapping(settings->minimum, settings->maximum);
+        int minimum = settings->minimum, maximum = settings->maximum;
+        double factor = 12.0 / (maximum - minimum);
+        auto measure = [&](auto&& process) {
+            auto begin = clock::now();
+            for (uint32_t i = 0; i < count; i += 128)
+                process(i, count - i < 128 ? count - i : 128);
+            return std::chrono::duration<double, std::nano>(clock::now() - begin).count() / count;
+        };
+        convert_formula_ns = measure([&](uint32_t first, uint32_t n) {
+            for (uint32_t i = first; i < first + n; i++)
+                voltages[i] = (codes[i] - minimum) * factor - 6;
+        });
+        convert_table_ns = measure([&](uint32_t first, uint32_t n) {
+            mapping.ToVoltage(&codes[first], n, &voltages[first]);
+        });
+        quantize_formula_ns = measure([&](uint32_t first, uint32_t n) {
+            for (uint32_t i = first; i < first + n; i++) {
+                double result = round((voltages[i] + 6) * (maximum - minimum) / 12.0 + minimum);
+                quantized[i] = result < 0 ? 0 : result > 254 ? 254 : (uint8_t)result;
+            }
+        });
+        quantize_batch_ns = measure([&](uint32_t first, uint32_t n) {
+            mapping.ToCode(&voltages[first], n, &quantized[first]);
+        });
+    }
+
+    // Diezmado a la frecuencia actual: costo por muestra de entrada y rechazo de alias medido con
+    // tonos que se pliegan sobre el borde de la banda útil (m fs_salida ± banda útil)
+    Decimator decimator;
+    decimator.Configure(settings->sampling_rate, 400);
+    if (decimator.Stages() == 0)
+        return;
+    double fs = settings->sampling_rate, fo = decimator.OutputRate();
+    uint32_t count = 65536;
+    std::vector<double> input(count), output(count);
+    for (double& v : input)
+        v = noise(random);
+    auto begin = clock::now();
+    for (uint32_t i = 0; i < count; i += 128)
+        decimator.Process(&input[i], 128, output.data());
+    decimator_ns = std::chrono::duration<double, std::nano>(clock::now() - begin).count() / count;
+
+    double worst = 0;
+    for (int m = 1; m <= 8; m++) {
+        for (double f : { m * fo - Decimator::passband * fo, m * fo + Decimator::passband * fo }) {
+            if (f <= 0 || f >= fs / 2)
+                continue;
+            decimator.Reset();
+            uint32_t produced = 0;
+            for (uint32_t i = 0; i < count; i += 128) {
+                double block[128];
+                for (uint32_t k = 0; k < 128; k++)
+                    block[k] = std::sin(2 * std::numbers::pi * f * (i + k) / fs);
+                produced += decimator.Process(block, 128, &output[produced]);
+            }
+            // Amplitud de la salida descartando el transitorio inicial
+            double power = 0;
+            for (uint32_t i = produced / 2; i < produced; i++)
+                power += output[i] * output[i];
+            double amplitude = std::sqrt(2 * power / (produced - produced / 2));
+            worst = amplitude > worst ? amplitude : worst;
+        }
+    }
+    decimator_alias_db = 20 * std::log10(worst > 1e-12 ? worst : 1e-12);
+}
+
+void MainWindow::UpdateHistoryEnvelope(double left, double right, int pixels) {
+    // La envolvente solo se recalcula cuando cambia el rango visible o el ancho del gráfico
+    if (left == history_left && right == history_right && pixels == history_pixels)
+        return;
+
+    history_left = left;
+    history_right = right;
+    history_pixels = pixels;
+
+    double fs = settings->sampling_rate;
+    uint64_t first = (uint64_t)(left > 0 ? left * fs : 0);
+    uint64_t last = (uint64_t)(right > 0 ? std::ceil(right * fs) : 0);
+    if (history.IsOpen()) {
+        history.Envelope(first, last, pixels, 1.0 / fs, history_x, history_in, history_out);
+        return;
+    }
+
+    // El historial comprimido guarda códigos: convertirlos a voltaje con el mapeo actual
+    code_history.Envelope(first, last, pixels, 1.0 / fs, history_x, history_in, history_out);
+    auto mapping = sample_mapping.load();
+    for (double& v : history_in)
+        v = mapping->ToVoltage((uint8_t)v);
+    for (double& v : history_out)
+        v = mapping->ToVoltage((uint8_t)v);
+}
+
+BlockSummary MainWindow::SummarizeRange(const BlockSummaries<>& blocks, const ScrollBuffer<double>* values,
+                                        double from, double to) {
+    // Los bloques de los bordes se completan con las muestras de la ventana del frame
+    // (live_view); si el tramo ya no está en la ventana o el productor compactó mientras
+    // se leía, Summarize usa el resumen del bloque completo
+    auto edge = [&](double first, double last, BlockSummary& result) {
+        BufferView view = live_view;
+        if (!scrollX || !values || view.count == 0)
+            return false;
+        const double* x = scrollX->storage() + view.start;
+        const double* v = values->storage() + view.start;
+        if (first < x[0] || last > x[view.count - 1])
+            return false;
+
+        // Los tiempos son uniformes: ubicar el primer índice y avanzar hasta 'last'
+        double period = 1.0 / settings->sampling_rate;
+        double position = std::floor((first - x[0]) / period) - 1;
+        uint32_t i = position > 0 ? (uint32_t)position : 0;
+        BlockSummary part;
+        for (; i < view.count && x[i] <= last; i++) {
+            if (x[i] >= first)
+                part.add(v[i], x[i]);
+        }
+        if (!published_view.validate(view))
+            return false;
+        result.merge(part);
+        return true;
+    };
+    return blocks.Summarize(from, to, edge);
 }
 
-void MainWindow::ResetFilters() {
-    lowpass_filter.reset();
-    highpass_filter.reset();
+void MainWindow::FitVerticalAxis() {
+    if (!input_blocks)
+        return;
+
+    // Combina los resúmenes de los bloques del rango visible: O(bloques), no O(muestras)
+    double left = frozen ? frozen_left_limit : left_limit;
+    double right = frozen ? frozen_right_limit : right_limit;
+    BlockSummary summary = SummarizeRange(*input_blocks, scrollY, left, right);
+    summary.merge(SummarizeRange(*output_blocks, filter_scrollY, left, right));
+    if (summary.count == 0)
+        return;
+
+    double margin = (summary.max - summary.min) * 0.05 + 0.01;
+    double& down = frozen ? frozen_down_limit : down_limit;
+    double& up = frozen ? frozen_up_limit : up_limit;
+    down = summary.min - margin;
+    up = summary.max + margin;
+}
+
+void MainWindow::ExportHistory(double left, double right) {
+    double fs = settings->sampling_rate;
+    uint64_t first = (uint64_t)(left > 0 ? left * fs : 0);
+    uint64_t last = (uint64_t)(right > 0 ? std::ceil(right * fs) : 0);
+
+    std::ofstream csv(std::format("historial_{:.3f}-{:.3f}s.csv", left, right));
+    csv << "tiempo,entrada,salida\n";
+
+    // Leer por bloques para no cargar todo el rango en memoria
+    std::vector<double> in(HistoryStore::chunk_samples), out(HistoryStore::chunk_samples);
+    std::vector<uint8_t> in_codes, out_codes;
+    auto mapping = sample_mapping.load();
+    while (first < last) {
+        uint32_t count = (uint32_t)(last - first < in.size() ? last - first : in.size());
+        if (history.IsOpen()) {
+            count = history.Read(first, count, in.data(), out.data());
+        }
+        else {
+            in_codes.resize(count);
+            out_codes.resize(count);
+            count = code_history.Read(first, count, in_codes.data(), out_codes.data());
+            mapping->ToVoltage(in_codes.data(), count, in.data());
+            mapping->ToVoltage(out_codes.data(), count, out.data());
+        }
+        if (count == 0)
+            break;
+        for (uint32_t i = 0; i < count; i++)
+            csv << (first + i) / fs << ',' << in[i] << ',' << out[i] << '\n';
+        first += count;
+    }
 }
 
 // ════════════════════════════════════════════════════════════════════════════════════════
@@ -514,13 +1539,21 @@ void MainWindow::ResetFilters() {
 // 1. Arduino → Serial → Leer buffer (128 bytes/bloque)
 // 2. Transformar ADC (0-255) → Voltaje real (-6V a +6V)
 // 3. Almacenar señal original en scrollY
-// 4. Aplicar filtro digital seleccionado (IIR orden 8)
-// 5. Almacenar señal filtrada en filter_scrollY
-// 6. Transformar Voltaje → DAC (0-255)
+// 4. Pasar el lote completo por la cadena de etapas (ver ProcessingChain.h)
+// 5. Almacenar la salida de la etapa derivada en filter_scrollY
+// 6. Transformar la salida final Voltaje → DAC (0-255)
 // 7. Serial → Arduino → DAC PWM
 //
+// ECO DE BAJA LATENCIA (low_latency_echo):
+// Los pasos 2, 4, 6 y 7 corren primero y la respuesta se escribe enseguida; el registro
+// (pasos 3 y 5, pirámides, historial, resúmenes por bloque y diezmado) ocurre después,
+// mientras el dispositivo recibe los bytes. La latencia en la PC se mide en ambos modos.
+//
 // ARQUITECTURA THREAD-SAFE:
-// - data_mutex protege escritura en buffers durante freeze/unfreeze
+// - Antes de escribir, las capturas congeladas que pisa el lote se copian (SnapshotStore)
+// - Al final de cada lote se publica la ventana visible en published_view; Draw y
+//   AnalysisWorker leen esa ventana sin bloquear. Si el lote va a compactar
+//   los buffers, se abre la publicación antes (begin_write) para cambiar la generación
 // - Lectura por bloques (128 bytes) reduce overhead vs byte a byte
 // - Procesamiento en lote mejora caché locality
 //
@@ -539,52 +1572,164 @@ void MainWindow::ResetFilters() {
 // - CPU usage: <2%
 // ════════════════════════════════════════════════════════════════════════════════════════
 
+void MainWindow::RecordEchoLatency(bool low_latency, time_point arrival, time_point ready, time_point sent) {
+    // Promedio exponencial (~100 lotes) y pico con decaimiento lento, separados por modo
+    int mode = low_latency ? 1 : 0;
+    double ready_us = std::chrono::duration<double, std::micro>(ready - arrival).count();
+    double sent_us = std::chrono::duration<double, std::micro>(sent - arrival).count();
+    EchoLatency& stats = echo_latency[mode];
+    double average = stats.ready_us.load(std::memory_order_relaxed);
+    stats.ready_us.store(average == 0 ? ready_us : average * 0.99 + ready_us * 0.01, std::memory_order_relaxed);
+    average = stats.sent_us.load(std::memory_order_relaxed);
+    stats.sent_us.store(average == 0 ? sent_us : average * 0.99 + sent_us * 0.01, std::memory_order_relaxed);
+    double peak = stats.peak_us.load(std::memory_order_relaxed) * 0.999;
+    stats.peak_us.store(sent_us > peak ? sent_us : peak, std::memory_order_relaxed);
+}
+
 void MainWindow::SerialWorker() {
     while (do_serial_work) {
         // Leer en bloques grandes para reducir overhead de syscalls
         int read = serial.read(read_buffer.data(), 128);
+        auto batch_arrival = clock::now();
 
         if (read > 0) {
-            // Proteger buffers contra acceso concurrente (freeze/unfreeze)
-            std::lock_guard<std::mutex> lock(data_mutex);
-            
-            // Procesar bloque completo
-            for (size_t i = 0; i < read; i++)
-            {
-                // Paso 1: Transformar ADC (0-255) → Voltaje (-6V a +6V)
-                double transformado = TransformSample(read_buffer[i]);
-
-                // Paso 2: Almacenar señal original
-                scrollY->push(transformado);
-                scrollX->push(next_time);
-
-                double resultado = transformado;
-
-                // Paso 3: Aplicar filtro digital IIR Butterworth orden 8
-                switch (selected_filter)
-                {
-                    case Filter::LowPass:
-                        resultado = lowpass_filter.filter(transformado);
-                        break;
-                    case Filter::HighPass:
-                        resultado = highpass_filter.filter(transformado);
-                        break;
-                    case Filter::None:
-                        break;  // Bypass: salida = entrada
+            // Páginas de todos los buffers para el lote antes de escribir nada: si el sistema no
+            // puede comprometerlas se detiene la adquisición (DrawSidebar informa y desconecta)
+            if (!PrepareBuffers((uint32_t)read)) {
+                memory_error = true;
+                break;
+            }
+
+            // Quitar las respuestas del dispositivo (se reemplazan por la muestra anterior)
+            device_link.Parse(read_buffer.data(), (uint32_t)read);
+
+            // Lote completo en arreglos locales: el filtro procesa el bloque entero
+            double batch_time[128], batch_in[128], batch_out[128], batch_tap[128];
+            uint8_t batch_codes[128];
+
+            // Mapeo vigente para todo el lote (la UI publica uno nuevo al mover Máximo o Mínimo)
+            auto mapping = sample_mapping.load();
+
+            // Paso 1-2: Transformar ADC (0-255) → Voltaje (-6V a +6V) por tabla
+            mapping->ToVoltage(read_buffer.data(), (uint32_t)read, batch_in);
+            for (int i = 0; i < read; i++) {
+                batch_time[i] = next_time;
+                batch_out[i] = batch_in[i];
+                next_time += 1.0 / settings->sampling_rate;
+            }
+
+            // Modo de eco leído una vez por lote (la UI lo cambia en cualquier momento)
+            bool low_latency = low_latency_echo.load(std::memory_order_relaxed);
+
+            // Almacenar la señal original (antes de filtrar, o después de enviar en modo de baja latencia)
+            auto store_input = [&] {
+                // Si el lote va a compactar los buffers, los datos publicados se mueven:
+                // los lectores que usen la ventana anterior lo detectan con validate()
+                if (scrollX->will_wrap(read))
+                    published_view.begin_write();
+
+                // Copiar las capturas congeladas que este lote (o los próximos read_margin segundos)
+                // va a sobrescribir (copy-on-write): la UI puede estar graficando desde ellas sin lock
+                uint32_t margin = (uint32_t)(settings->sampling_rate * SnapshotStore::read_margin);
+                scrollX->for_each_write_range(read + margin, [&](uint32_t first, uint32_t last) {
+                    snapshots.BeforeWrite(first, last);
+                });
+                for (int i = 0; i < read; i++) {
+                    scrollY->push(batch_in[i]);
+                    scrollX->push(batch_time[i]);
                 }
+            };
+
+            // Paso 6: Enviar el bloque procesado de vuelta por serial; los comandos pendientes para
+            // el dispositivo ocupan el lugar de las primeras muestras (un byte por muestra).
+            // Se mide la latencia desde que llegó el lote hasta que se escribió la respuesta
+            auto transmit = [&] {
+                auto ready = clock::now();
+                std::copy(batch_codes, batch_codes + read, write_buffer.data());
+                device_link.TakeCommandBytes(write_buffer.data(), (uint32_t)read);
+                serial.write(write_buffer.data(), read);
+                RecordEchoLatency(low_latency, batch_arrival, ready, clock::now());
+            };
+
+            if (!low_latency)
+                store_input();
+
+            // Paso 3: Pasar el lote por la cadena de etapas (ver ProcessingChain.h). La etapa Filtro
+            // toma el último diseño publicado (cascada de biquads o FIR); el cambio de diseño se hace
+            // en el borde del lote sin reiniciar el estado (ver LiveFilter.h). Un diseño para otra
+            // frecuencia de muestreo todavía no es válido: mientras tanto la etapa no modifica la señal
+            // batch_out queda con la salida final (se envía al dispositivo) y batch_tap con la
+            // salida de la etapa derivada (se grafica y se guarda en el historial)
+            auto design = filter_designer.Current();
+            if (design && design->sampling_rate != settings->sampling_rate)
+                design = nullptr;
+            processing_chain.Process(batch_out, batch_tap, (uint32_t)read, settings->sampling_rate, std::move(design));
+
+            // Con el filtro en el dispositivo la salida es su emulación exacta (el dispositivo
+            // ignora las muestras que envía la PC)
+            if (device_link.OnDevice()) {
+                uint8_t device_out[128];
+                device_link.Emulate(read_buffer.data(), (uint32_t)read, device_out);
+                mapping->ToVoltage(device_out, (uint32_t)read, batch_out);
+                for (int i = 0; i < read; i++)
+                    batch_tap[i] = batch_out[i];
+            }
+
+            // Paso 5: Transformar Voltaje → DAC para enviar de vuelta (salida final de la cadena,
+            // cuantizada por lotes: 8 muestras por iteración con AVX2)
+            mapping->ToCode(batch_out, (uint32_t)read, batch_codes);
+
+            // Baja latencia: la respuesta sale antes de todo el registro (buffers, pirámides,
+            // historial, diezmado), que pasa a ocurrir mientras el dispositivo recibe los bytes
+            if (low_latency) {
+                transmit();
+                store_input();
+            }
+
+            for (int i = 0; i < read; i++)
+            {
+                double transformado = batch_in[i];
+                double resultado = batch_tap[i];
 
                 // Paso 4: Almacenar señal filtrada
                 filter_scrollY->push(resultado);
-                next_time += 1.0 / settings->sampling_rate;
 
-                // Paso 5: Transformar Voltaje → DAC para enviar de vuelta
-                write_buffer[i] = InverseTransformSample(resultado);
+                // Actualizar las pirámides min/max (O(1) amortizado)
+                input_lod.Push(transformado);
+                output_lod.Push(resultado);
+
+                // Agregar al historial en disco (sin bloqueo: el volcado ocurre en otro hilo)
+                history.Append(transformado, resultado);
+
+                // Historial comprimido: código recibido y código devuelto (1 byte cada uno)
+                code_history.Append(read_buffer[i], batch_codes[i]);
             }
 
-            size = scrollX->count();
-            
-            // Paso 6: Enviar bloque procesado de vuelta por serial
-            serial.write(write_buffer.data(), read);
+            // Publicar la ventana resultante (los tres buffers avanzan en paralelo)
+            published_view.publish(scrollX->start(), scrollX->count());
+            input_blocks->write(batch_in, batch_time, read);
+            output_blocks->write(batch_tap, batch_time, read);
+
+            // Señales diezmadas en paralelo (entrada y derivación): pocas muestras por lote
+            if (decimated_x) {
+                double decimated_in[128], decimated_out[128];
+                uint32_t produced = input_decimator.Process(batch_in, (uint32_t)read, decimated_in);
+                output_decimator.Process(batch_tap, (uint32_t)read, decimated_out);
+                if (produced > 0) {
+                    if (decimated_x->will_wrap(produced))
+                        decimated_view.begin_write();
+                    for (uint32_t i = 0; i < produced; i++) {
+                        decimated_x->push(decimated_next_time);
+                        decimated_y->push(decimated_in[i]);
+                        decimated_filtered->push(decimated_out[i]);
+                        decimated_next_time += 1.0 / decimated_rate;
+                    }
+                    decimated_view.publish(decimated_x->start(), decimated_x->count());
+                }
+            }
+
+            if (!low_latency)
+                transmit();
         }
     }
 }
@@ -598,15 +1743,51 @@ void MainWindow::AnalysisWorker() {
         if (!fft || !scrollY)
             continue;
 
-        // Tomar hasta 1 segundo de muestras para el análisis FFT
-        uint32_t available = scrollY->count();
-        uint32_t max = settings->sampling_rate;
-        uint32_t count = available > max ? max : available;
+        // Baja frecuencia: 10 segundos de la señal diezmada (resolución de 0.1 Hz)
+        if (spectrum_low_frequency && decimated_fft) {
+            ScrollBuffer<double>* source = spectrum_of_output ? decimated_filtered : decimated_y;
+            BufferView view;
+            do {
+                view = decimated_view.acquire();
+                uint32_t max = (uint32_t)decimated_fft->GetSamplesSize();
+                uint32_t count = view.count > max ? max : view.count;
+
+                auto end = source->storage() + view.start + view.count;
+                decimated_fft->SetData(end - count, count);
+            } while (!decimated_view.validate(view));
+            decimated_fft->Compute();
+
+            std::this_thread::sleep_for(100ms);
+            continue;
+        }
+
+        // Entrada o derivación de la cadena (mismos índices: los buffers avanzan en paralelo)
+        ScrollBuffer<double>* source = spectrum_of_output ? filter_scrollY : scrollY;
+
+        // Tomar hasta 1 segundo de muestras de la ventana publicada (sin bloquear a SerialWorker)
+        // Si hubo una compactación durante la copia, se vuelve a leer la ventana nueva
+        BufferView view;
+        do {
+            view = published_view.acquire();
+            uint32_t max = settings->sampling_rate;
+            uint32_t count = view.count > max ? max : view.count;
 
-        auto end = scrollY->data() + available;
-        fft->SetData(end - count, count);
+            auto end = source->storage() + view.start + view.count;
+            fft->SetData(end - count, count);
+        } while (!published_view.validate(view));
         fft->Compute();
 
+        // Espectros de los filtros candidatos: las últimas muestras de cada carril
+        const FilterLanes& lanes = processing_chain.Lanes();
+        for (int lane = 0; lane < lanes.Lanes() && candidate_fft[lane]; lane++) {
+            FFT* candidate = candidate_fft[lane];
+            candidate_samples.resize(candidate->GetSamplesSize());
+            uint64_t first = 0;
+            uint32_t count = lanes.Read(lane, (uint32_t)candidate_samples.size(), candidate_samples.data(), first);
+            candidate->SetData(candidate_samples.data(), count);
+            candidate->Compute();
+        }
+
         std::this_thread::sleep_for(100ms);
     }
 }
@@ -615,9 +1796,14 @@ void MainWindow::Draw()
 {
     static double elapsed_time = 0;
 
+    // Tomar la ventana publicada por SerialWorker para todo el frame (no bloquea)
+    live_view = published_view.acquire();
+    UpdateSampleMapping();
+    decimated_live_view = decimated_view.acquire();
+
     // Actualizar tiempo transcurrido y límites de zoom automático solo en modo en vivo
-    if (started && scrollX && scrollX->count() > 0 && !frozen) {
-        elapsed_time = scrollX->back();
+    if (started && scrollX && live_view.count > 0 && !frozen) {
+        elapsed_time = scrollX->storage()[live_view.start + live_view.count - 1];
 
         // Auto-scroll: mantener ventana visible de max_time_visible segundos
         if (elapsed_time > max_time_visible) {
@@ -640,29 +1826,155 @@ void MainWindow::Draw()
         frozen_right_limit = frozen_left_limit + max_time_visible;
     }
 
+    // Dibujar panel lateral con controles (puede congelar/reanudar o cambiar de captura)
+    DrawSidebar();
+
     // Seleccionar fuente de datos según el estado (congelado vs en vivo)
     const double* dataX = nullptr;
     const double* dataY = nullptr;
     const double* dataY_filtered = nullptr;
     int current_draw_size = 0;
+
+    // En modo congelado se copian los punteros de las capturas con el lock y se grafica sin él
+    // (SerialWorker no espera al frame aunque tenga que copiar una captura, ver Snapshot.h)
+    SnapshotRef frozen_snapshot;
+    const SnapshotRef* snapshot = nullptr;
+    std::shared_ptr<const ZeroPhaseFilter::Result> zero_phase_result;  // Mantiene vivos los datos durante el frame
+    if (frozen && snapshots.Read(active_snapshot, frozen_snapshot, compared_snapshots))
+        snapshot = &frozen_snapshot;
     
-    if (frozen && !frozen_dataX.empty()) {
-        // Modo congelado: usar snapshot guardado (no se actualiza hasta reanudar)
-        dataX = frozen_dataX.data();
-        dataY = frozen_dataY.data();
-        dataY_filtered = frozen_dataY_filtered.data();
-        current_draw_size = frozen_size / settings->stride;
+    if (snapshot) {
+        // Modo congelado: usar la captura fijada (no se actualiza hasta reanudar)
+        dataX = snapshot->x;
+        dataY = snapshot->y;
+        dataY_filtered = snapshot->filtered;
+        current_draw_size = snapshot->count / settings->stride;
+
+        // Fase cero: la salida es la ida y vuelta del diseño activo sobre la entrada de la
+        // captura (ver ZeroPhase.h). Mientras se recalcula se sigue mostrando el resultado anterior
+        if (zero_phase_enabled) {
+            auto design = filter_designer.Current();
+            if (design && design->sections > 0 && design->sampling_rate == settings->sampling_rate)
+                zero_phase.Request(snapshots, snapshot->id, design);
+            zero_phase_result = zero_phase.Current();
+            if (zero_phase_result && zero_phase_result->snapshot_id == snapshot->id && zero_phase_result->output.size() == snapshot->count)
+                dataY_filtered = zero_phase_result->output.data();
+        }
     }
     else {
-        // Modo en vivo: usar buffers circulares actuales (actualizados por SerialWorker)
-        dataX = scrollX ? scrollX->data() : nullptr;
-        dataY = scrollY ? scrollY->data() : nullptr;
-        dataY_filtered = filter_scrollY ? filter_scrollY->data() : nullptr;
-        current_draw_size = size / settings->stride;
+        // Modo en vivo: usar la ventana publicada de los buffers circulares (actualizados por SerialWorker)
+        // ImPlot consume los datos dentro de este frame y la ventana sigue intacta aunque
+        // SerialWorker compacte mientras tanto (capacity >= 2 * view)
+        dataX = scrollX ? scrollX->storage() + live_view.start : nullptr;
+        dataY = scrollY ? scrollY->storage() + live_view.start : nullptr;
+        dataY_filtered = filter_scrollY ? filter_scrollY->storage() + live_view.start : nullptr;
     }
 
-    // Dibujar panel lateral con controles
-    DrawSidebar();
+    // Dibuja una señal en vivo: con la pirámide min/max cuando hay varias muestras por píxel
+    // (O(píxeles), sin perder picos) o con las muestras crudas de la ventana publicada al hacer zoom
+    // Con la vista diezmada activa, las bases de tiempo lentas usan la señal sin aliasing
+    auto plot_live = [&](const MinMaxPyramid& lod, const double* values, const ScrollBuffer<double>* decimated) {
+        double period = 1.0 / settings->sampling_rate;
+        int pixels = (int)ImPlot::GetPlotSize().x;
+        double samples_per_pixel = (right_limit - left_limit) / period / (pixels > 0 ? pixels : 1);
+        if (decimated_display && decimated && decimated_live_view.count > 0 && samples_per_pixel >= input_decimator.Factor()) {
+            const double* decimated_time = decimated_x->storage() + decimated_live_view.start;
+            const double* decimated_values = decimated->storage() + decimated_live_view.start;
+            double decimated_period = 1.0 / decimated_rate;
+            double first = std::floor((left_limit - decimated_time[0]) / decimated_period);
+            double last = std::ceil((right_limit - decimated_time[0]) / decimated_period) + 1;
+            int begin = (int)std::clamp(first, 0.0, (double)decimated_live_view.count);
+            int end = (int)std::clamp(last, 0.0, (double)decimated_live_view.count);
+            if (end > begin)
+                ImPlot::PlotLine("", decimated_time + begin, decimated_values + begin, end - begin);
+            return;
+        }
+        if (lod.Query(left_limit / period, right_limit / period, pixels, period, lod_x, lod_y)) {
+            ImPlot::PlotLine("", lod_x.data(), lod_y.data(), (int)lod_x.size());
+            return;
+        }
+
+        if (!dataX || !values || live_view.count == 0)
+            return;
+        double first = std::floor((left_limit - dataX[0]) / period);
+        double last = std::ceil((right_limit - dataX[0]) / period) + 1;
+        int begin = (int)std::clamp(first, 0.0, (double)live_view.count);
+        int end = (int)std::clamp(last, 0.0, (double)live_view.count);
+        if (end > begin)
+            ImPlot::PlotLine("", dataX + begin, values + begin, end - begin);
+    };
+
+    // En modo congelado, el tramo visible anterior a la captura se dibuja desde el historial
+    if (snapshot && HistoryAvailable() && frozen_left_limit < snapshot->first_time)
+        UpdateHistoryEnvelope(frozen_left_limit, snapshot->first_time < frozen_right_limit ? snapshot->first_time : frozen_right_limit,
+                              (int)(width - sidebar_width));
+    auto plot_history = [&](bool filtered) {
+        if (!snapshot || !HistoryAvailable() || frozen_left_limit >= snapshot->first_time || history_x.empty())
+            return;
+        ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.110f, 0.784f, 0.035f, 0.6f));
+        ImPlot::PlotLine("", history_x.data(), filtered ? history_out.data() : history_in.data(), (int)history_x.size());
+        ImPlot::PopStyleColor();
+    };
+
+    // Superpone las capturas marcadas para comparar, alineadas al inicio de la captura visible
+    auto plot_compared = [&](bool filtered) {
+        if (!snapshot)
+            return;
+        for (auto& other : compared_snapshots) {
+            if (other.count < 2)
+                continue;
+            double period = (other.last_time - other.first_time) / (other.count - 1);
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.9f, 0.6f, 0.1f, 0.7f));
+            ImPlot::PlotLine(std::format("#{}", other.id).c_str(), filtered ? other.filtered : other.y,
+                             other.count / settings->stride, period * settings->stride, snapshot->first_time,
+                             0, 0, settings->byte_stride);
+            ImPlot::PopStyleColor();
+        }
+    };
+
+    // Filtros candidatos en vivo: cada carril se dibuja con su color desde el anillo de
+    // FilterLanes (la muestra i corresponde al tiempo i / fs), con envolvente min/max por píxel
+    auto plot_candidates = [&]() {
+        const FilterLanes& lanes = processing_chain.Lanes();
+        if (frozen || !started || lanes.Lanes() == 0)
+            return;
+        double period = 1.0 / settings->sampling_rate;
+        int pixels = (int)ImPlot::GetPlotSize().x;
+        pixels = pixels > 0 ? pixels : 1;
+        double span = (right_limit - left_limit) / period + 2;
+        uint32_t wanted = span < FilterLanes::trace_capacity / 2 ? (uint32_t)span : FilterLanes::trace_capacity / 2;
+        candidate_trace.resize(wanted);
+        for (int lane = 0; lane < lanes.Lanes(); lane++) {
+            uint64_t first = 0;
+            uint32_t count = lanes.Read(lane, wanted, candidate_trace.data(), first);
+            if (count < 2)
+                continue;
+            ImPlot::PushStyleColor(ImPlotCol_Line, candidate_colors[lane]);
+            uint32_t per_pixel = count / pixels;
+            if (per_pixel < 2) {
+                ImPlot::PlotLine("", candidate_trace.data(), (int)count, period, first * period);
+            }
+            else {
+                candidate_x.clear();
+                candidate_y.clear();
+                for (uint32_t begin = 0; begin < count; begin += per_pixel) {
+                    uint32_t end = begin + per_pixel < count ? begin + per_pixel : count;
+                    double low = candidate_trace[begin], high = low;
+                    for (uint32_t i = begin + 1; i < end; i++) {
+                        low = candidate_trace[i] < low ? candidate_trace[i] : low;
+                        high = candidate_trace[i] > high ? candidate_trace[i] : high;
+                    }
+                    double time = (first + begin) * period;
+                    candidate_x.push_back(time);
+                    candidate_y.push_back(low);
+                    candidate_x.push_back(time);
+                    candidate_y.push_back(high);
+                }
+                ImPlot::PlotLine("", candidate_x.data(), candidate_y.data(), (int)candidate_x.size());
+            }
+            ImPlot::PopStyleColor();
+        }
+    };
 
     // Ventana principal: área de gráficos a la derecha del sidebar
     ImGui::SetNextWindowPos({ sidebar_width, 0 });
@@ -725,11 +2037,18 @@ void MainWindow::Draw()
         ImPlot::SetupAxisLimitsConstraints(ImAxis_X1, 0, INFINITY);
 
         // Dibujar línea con color verde #1CC809
-        if (dataX && dataY && current_draw_size > 0) {
+        if (snapshot && current_draw_size > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.110f, 0.784f, 0.035f, 1.0f));
             ImPlot::PlotLine("", dataX, dataY, current_draw_size, 0, 0, settings->byte_stride);
             ImPlot::PopStyleColor();
         }
+        else if (!frozen) {
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.110f, 0.784f, 0.035f, 1.0f));
+            plot_live(input_lod, dataY, decimated_y);
+            ImPlot::PopStyleColor();
+        }
+        plot_history(false);
+        plot_compared(false);
         ImPlot::EndPlot();
     }
 
@@ -767,39 +2086,95 @@ void MainWindow::Draw()
             ImPlot::SetupAxisLimitsConstraints(ImAxis_X1, 0, INFINITY);
 
             // Dibujar línea filtrada con color verde #1CC809
-            if (dataX && dataY_filtered && current_draw_size > 0) {
+            if (snapshot && current_draw_size > 0) {
                 ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.110f, 0.784f, 0.035f, 1.0f));
                 ImPlot::PlotLine("", dataX, dataY_filtered, current_draw_size, 0, 0, settings->byte_stride);
                 ImPlot::PopStyleColor();
             }
+            else if (!frozen) {
+                ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.110f, 0.784f, 0.035f, 1.0f));
+                plot_live(output_lod, dataY_filtered, decimated_filtered);
+                ImPlot::PopStyleColor();
+                plot_candidates();
+            }
+            plot_history(true);
+            plot_compared(true);
             ImPlot::EndPlot();
         }
 
-        // Botones de selección de filtro
-        const char* nombres[] = { "Ninguno", "Pasa bajos", "Pasa altos" };
-        for (int i = 0; i < std::size(nombres); i++)
-        {
-            if (i > 0)
-                ImGui::SameLine();
-
-            if (i == (int)selected_filter) {
-                ImGui::PushStyleColor(ImGuiCol_Button, ImGui::GetStyle().Colors[ImGuiCol_ButtonActive]);
-                ImGui::Button(nombres[i]);
-                ImGui::PopStyleColor();
+        DrawFilterDesigner();
+        DrawCandidates();
+        DrawProcessingChain();
+        DrawResponse();
+        DrawDeviceFilter();
+
+        // Rendimiento del filtro por bloques frente a iir1 en todas las frecuencias de muestreo
+        if (ImGui::TreeNode("Rendimiento del filtro")) {
+            if (ImGui::Button("Medir"))
+                RunFilterBenchmark();
+            ImGui::SameLine();
+            ImGui::TextDisabled("ns por muestra y seccion (Butterworth orden 8)");
+
+            if (!filter_benchmark.empty() && ImGui::BeginTable("##filter_benchmark", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                ImGui::TableSetupColumn("Fs (Hz)");
+                ImGui::TableSetupColumn("iir1");
+                ImGui::TableSetupColumn("Bloque");
+                ImGui::TableSetupColumn("Desenrollado");
+                ImGui::TableSetupColumn("AVX2");
+                ImGui::TableHeadersRow();
+                for (const FilterBenchmark& result : filter_benchmark) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d", result.rate);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", result.iir_ns);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", result.scalar_ns);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", result.unrolled_ns);
+                    ImGui::TableNextColumn();
+                    if (std::isnan(result.avx2_ns))
+                        ImGui::TextDisabled("-");
+                    else
+                        ImGui::Text("%.2f", result.avx2_ns);
+                }
+                ImGui::EndTable();
             }
-            else {
-                if (ImGui::Button(nombres[i])) {
-                    SelectFilter((Filter)i);
-                    ResetFilters();
+            // Por orden: la ruta elegida por tabla (AVX2 + kernel desenrollado) frente al lazo
+            if (!order_benchmark.empty() && ImGui::BeginTable("##order_benchmark", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                ImGui::TableSetupColumn("Orden");
+                ImGui::TableSetupColumn("Secciones");
+                ImGui::TableSetupColumn("Lazo");
+                ImGui::TableSetupColumn("Tabla");
+                ImGui::TableHeadersRow();
+                for (const OrderBenchmark& result : order_benchmark) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d", result.order);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d", result.sections);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", result.loop_ns);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", result.table_ns);
                 }
+                ImGui::EndTable();
+                ImGui::TextDisabled("ns por muestra de toda la cascada (Butterworth, corte fs/8)");
             }
-        }
-
-        // Control de frecuencia de corte (solo visible si hay filtro activo)
-        if (selected_filter != Filter::None
-            && ImGui::SliderInt("Frecuencia de corte", &cutoff_frequency[(int)selected_filter], min_cutoff_frequency, max_cutoff_frequency)) {
-            SetupFilter();
-            ResetFilters();
+            if (!filter_benchmark.empty()) {
+                // Carga de un núcleo a la frecuencia máxima: ns por muestra × muestras por segundo
+                double load = frecuencias[std::size(frecuencias) - 1] * 1e-9 * 100;
+                ImGui::TextDisabled("Conversion a %d Hz (ns/muestra, carga de un nucleo):", frecuencias[std::size(frecuencias) - 1]);
+                ImGui::TextDisabled("  ADC a V: formula %.2f (%.3f%%), tabla %.2f (%.3f%%)",
+                    convert_formula_ns, convert_formula_ns * load, convert_table_ns, convert_table_ns * load);
+                ImGui::TextDisabled("  V a DAC: formula %.2f (%.3f%%), lotes %.2f (%.3f%%)",
+                    quantize_formula_ns, quantize_formula_ns * load, quantize_batch_ns, quantize_batch_ns * load);
+            }
+            if (!filter_benchmark.empty() && input_decimator.Stages() > 0) {
+                ImGui::TextDisabled("Diezmado x%d a %.0f Hz: %.2f ns/muestra", input_decimator.Factor(), decimated_rate, decimator_ns);
+                ImGui::TextDisabled("Alias: %.0f dB medido con tonos, %.0f dB calculado", decimator_alias_db, input_decimator.AliasRejectionDb());
+            }
+            ImGui::TreePop();
         }
     }
 
@@ -810,6 +2185,11 @@ void MainWindow::Draw()
             analysis_cv.notify_one();
         }
         
+        // Espectro de baja frecuencia: FFT de 10 s sobre la señal diezmada
+        bool low_frequency = spectrum_low_frequency && decimated_fft;
+        FFT* spectrum = low_frequency ? decimated_fft : fft;
+        double spectrum_rate = low_frequency ? decimated_rate : settings->sampling_rate;
+
         // === GRÁFICO 3: ESPECTRO (FFT) ===
         if (ImPlot::BeginPlot("Espectro", { -1, graph_height }, ImPlotFlags_NoLegend)) {
             ImPlot::SetupAxisFormat(ImAxis_Y1, MetricFormatter, (void*)"V");
@@ -822,19 +2202,45 @@ void MainWindow::Draw()
             } else {
                 ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Linear);
                 // En escala lineal, mostrar desde 0 Hz hasta Nyquist (fs/2)
-                double nyquist_freq = settings->sampling_rate / 2.0;
+                double nyquist_freq = spectrum_rate / 2.0;
                 ImPlot::SetupAxisLimits(ImAxis_X1, 0, nyquist_freq, ImGuiCond_FirstUseEver);
             }
             
             ImPlot::SetupAxis(ImAxis_Y1, nullptr, ImPlotAxisFlags_AutoFit);
             ImPlot::SetupAxisLimitsConstraints(ImAxis_Y1, 0, INFINITY);
+            if (spectrum_response) {
+                ImPlot::SetupAxis(ImAxis_Y2, nullptr, ImPlotAxisFlags_AuxDefault);
+                ImPlot::SetupAxisFormat(ImAxis_Y2, "%.0f dB");
+                ImPlot::SetupAxisLimits(ImAxis_Y2, -100, 10, ImGuiCond_FirstUseEver);
+            }
 
             // Dibujar el espectro FFT
-            fft->Plot(settings->sampling_rate);
+            spectrum->Plot(spectrum_rate);
+
+            // Espectros de los filtros candidatos (FFT propia de cada carril, ver AnalysisWorker)
+            if (!low_frequency) {
+                for (int lane = 0; lane < processing_chain.Lanes().Lanes() && candidate_fft[lane]; lane++) {
+                    const FFT* candidate = candidate_fft[lane];
+                    ImPlot::PushStyleColor(ImPlotCol_Line, candidate_colors[lane]);
+                    ImPlot::PlotLine("", candidate->GetAmplitudes().data(), candidate->GetAmplitudesSize(),
+                                     settings->sampling_rate / (double)candidate->GetSamplesSize());
+                    ImPlot::PopStyleColor();
+                }
+            }
+
+            // Magnitud de la respuesta calculada sobre el eje derecho (solo se recalcula si cambió)
+            if (spectrum_response) {
+                UpdateResponse();
+                ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+                ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(1.0f, 0.6f, 0.1f, 0.8f));
+                ImPlot::PlotLine("Respuesta", response.Frequency(), response.MagnitudeDb(), FilterResponse::points);
+                ImPlot::PopStyleColor();
+                ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
+            }
             
             // Marcador visual de la frecuencia dominante (línea vertical roja)
-            if (show_dominant_frequency_marker && scrollY && scrollY->count() > 0) {
-                double dominant_freq = fft->Frequency(settings->sampling_rate);
+            if (show_dominant_frequency_marker && scrollY && live_view.count > 0) {
+                double dominant_freq = spectrum->Frequency(spectrum_rate);
                 if (dominant_freq > 0) {
                     // Obtener los límites actuales del gráfico para la altura de la línea
                     ImPlotRect limits = ImPlot::GetPlotLimits();
@@ -883,15 +2289,33 @@ void MainWindow::Draw()
         // Checkbox para mostrar/ocultar marcador de frecuencia dominante
         ImGui::SameLine();
         ImGui::Checkbox("Mostrar freq. dominante", &show_dominant_frequency_marker);
+        ImGui::SameLine();
+        ImGui::Checkbox("Espectro de la salida", &spectrum_of_output);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Analiza la etapa derivada de la cadena en lugar de la entrada");
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Respuesta del filtro", &spectrum_response);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Magnitud calculada (dB, eje derecho) del filtro o de la cadena, segun Respuesta en frecuencia");
+        }
+        if (decimated_fft) {
+            ImGui::SameLine();
+            ImGui::Checkbox("Baja frecuencia", &spectrum_low_frequency);
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("10 s de la senal diezmada a %.0f Hz (resolucion 0.1 Hz, hasta %.0f Hz)",
+                                  decimated_rate, decimated_rate * Decimator::passband);
+            }
+        }
 
             // === INFORMACIÓN DE ANÁLISIS ESPECTRAL ===
-            if (scrollY && scrollY->count() > 0) {
+            if (scrollY && live_view.count > 0) {
                 ImGui::Spacing();
                 ImGui::Separator();
                 
                 // Mostrar información de frecuencia dominante de forma prominente
-                double dominant_freq = fft->Frequency(settings->sampling_rate);
-                double dc_offset = fft->Offset();
+                double dominant_freq = spectrum->Frequency(spectrum_rate);
+                double dc_offset = spectrum->Offset();
                 
                 // Texto con formato destacado para frecuencia dominante
                 ImGui::Text("FRECUENCIA DOMINANTE (FUNDAMENTAL):");
@@ -911,7 +2335,7 @@ void MainWindow::Draw()
                 ImGui::Spacing();
                 
                 // Detectar las 5 primeras armónicas
-                auto harmonics = fft->FindHarmonics(settings->sampling_rate, 5);
+                auto harmonics = spectrum->FindHarmonics(spectrum_rate, 5);
                 
                 // Mostrar tabla con formato estructurado
                 if (!harmonics.empty()) {
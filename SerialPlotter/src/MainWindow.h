@@ -3,7 +3,7 @@
 // MainWindow gestiona toda la interfaz gráfica y lógica de adquisición/visualización:
 // - Comunicación serial con dispositivo externo (Arduino, etc.)
 // - Visualización en tiempo real de señales (entrada, filtrada y espectro FFT)
-// - Aplicación de filtros digitales (pasa bajos, pasa altos)
+// - Aplicación de filtros digitales diseñados en tiempo de ejecución (ver FilterDesign.h)
 // - Modo congelado (freeze) para análisis sin detener adquisición
 // - Multi-threading para adquisición y análisis paralelos
 //
@@ -16,10 +16,23 @@
 #include <chrono>
 #include <thread>
 
+#include "Biquad.h"
 #include "Buffers.h"
 #include "Serial.h"
+#include "CompressedHistory.h"
+#include "Decimator.h"
+#include "DeviceFilter.h"
 #include "FFT.h"
+#include "FilterDesign.h"
+#include "FilterResponse.h"
+#include "History.h"
+#include "ProcessingChain.h"
+#include "Pyramid.h"
+#include "SampleMapping.h"
+#include "SessionPool.h"
 #include "Settings.h"
+#include "Snapshot.h"
+#include "ZeroPhase.h"
 
 
 class MainWindow {
@@ -27,13 +40,6 @@ class MainWindow {
     using time_point = clock::time_point;
     using duration = std::chrono::duration<double>;
 
-    // Tipos de filtros disponibles
-    enum class Filter {
-        None,      // Sin filtrado
-        LowPass,   // Filtro pasa bajos (Butterworth orden 8)
-        HighPass   // Filtro pasa altos (Butterworth orden 8)
-    };
-
     // Comunicación serial
     Serial serial;
     
@@ -41,15 +47,58 @@ class MainWindow {
     std::thread serial_thread, analysis_thread;
     std::mutex analysis_mutex;
     std::condition_variable analysis_cv;
-    std::mutex data_mutex;  // Protege acceso concurrente a scrollX, scrollY y filter_scrollY durante freeze/unfreeze
+    ViewPublisher published_view;  // Ventana (inicio, cantidad, generación) publicada por SerialWorker tras cada lote
 
-    // Estructuras de datos principales
+    // Estructuras de datos principales (punteros al juego de la sesión actual, ver SessionPool)
+    SessionPool session_pool;
+    std::unique_ptr<SessionBuffers> session;
     FFT* fft = nullptr;
     ScrollBuffer<double>* scrollX = nullptr;      // Eje temporal (segundos)
     ScrollBuffer<double>* scrollY = nullptr;      // Señal de entrada (voltaje)
     ScrollBuffer<double>* filter_scrollY = nullptr; // Señal filtrada (voltaje)
+    BlockSummaries<>* input_blocks = nullptr;   // Resúmenes por bloque de scrollY (ventana de vista)
+    BlockSummaries<>* output_blocks = nullptr;  // Resúmenes por bloque de filter_scrollY
+
+    // Señales diezmadas sin aliasing (ver Decimator.h) para bases de tiempo lentas y espectro
+    // de baja frecuencia; nulos si la frecuencia de muestreo es demasiado baja para diezmar
+    Decimator input_decimator, output_decimator;  // Solo SerialWorker (salvo Configure en CreateBuffers)
+    FFT* decimated_fft = nullptr;
+    FFT* candidate_fft[FilterLanes::max_lanes] = {};  // Espectros de los filtros candidatos
+    ScrollBuffer<double>* decimated_x = nullptr;
+    ScrollBuffer<double>* decimated_y = nullptr;
+    ScrollBuffer<double>* decimated_filtered = nullptr;
+    ViewPublisher decimated_view;        // Ventana de las señales diezmadas publicada por SerialWorker
+    BufferView decimated_live_view;      // Tomada al inicio de Draw
+    double decimated_next_time = 0;
+    double decimated_rate = 0;           // Frecuencia de las señales diezmadas (Hz)
+    bool decimated_display = true;       // Bases de tiempo lentas desde la señal diezmada
+
+    // Pirámides min/max para graficar en vivo sin perder picos (ver Pyramid.h)
+    MinMaxPyramid input_lod, output_lod;
+    std::vector<double> lod_x, lod_y;  // Polilínea generada en cada frame (solo UI thread)
+
+    // Historial completo de la sesión en disco, para navegar más atrás de max_time
+    HistoryStore history;
+    CompressedHistory code_history;  // Alternativa en RAM cuando el historial en disco está desactivado
+    std::vector<double> history_x, history_in, history_out;  // Envolvente del rango visible (caché)
+    double history_left = 0, history_right = 0;              // Rango de la caché
+    int history_pixels = 0;
 
-    int max_time = 120;  // Tiempo máximo de buffer (segundos)
+    int max_time = 120;  // Tiempo máximo de buffer (segundos), derivado de settings->memory_budget_mb
+
+    // Métricas de memoria y arranque mostradas en la sección de información
+    double start_latency_ms = 0;  // Duración de Start() (buffers, filtros, hilos y puerto)
+
+    // Eco de baja latencia: SerialWorker envía la respuesta de cada lote antes de guardarlo en
+    // buffers, pirámides e historial. La latencia en la PC (lote leído → respuesta escrita) se
+    // mide por separado en cada modo (0 = normal, 1 = baja latencia) para compararlos
+    struct EchoLatency {
+        std::atomic<double> ready_us = 0, sent_us = 0, peak_us = 0;  // Hasta escribir, total y pico
+    };
+    std::atomic<bool> low_latency_echo = false;
+    EchoLatency echo_latency[2];
+    void RecordEchoLatency(bool low_latency, time_point arrival, time_point ready, time_point sent);
+    float info_height = 80;       // Alto de la sección de información en el frame anterior
 
     float max_time_visible = 16.0f;  // Ventana de tiempo visible por defecto (16 segundos = 1s/div × 16 divisiones)
     int time_scale_index = 9;  // Índice de la escala temporal seleccionada (1s/div por defecto)
@@ -64,18 +113,79 @@ class MainWindow {
 
     double next_time = 0;  // Tiempo acumulado desde inicio de adquisición
 
-    int size = 0;  // Cantidad de puntos a dibujar (con stride aplicado)
+    BufferView live_view;  // Ventana publicada que se usa durante el frame actual (tomada al inicio de Draw)
 
-    // Buffers temporales para lectura/escritura serial
+    // Buffers temporales para lectura/escritura serial (SerialWorker lee de a 128 bytes)
+    static constexpr uint32_t read_buffer_size = 512;
     std::vector<uint8_t> read_buffer, write_buffer;
 
     Settings* settings;
     SettingsWindow* settingsWindow;
 
     // Configuración de filtros digitales
-    int min_cutoff_frequency = 1, max_cutoff_frequency = 100;
-    int cutoff_frequency[3] = { 0, 20, 100 };  // [None, LowPass, HighPass]
-    Filter selected_filter = Filter::None;
+    // La UI edita filter_spec y pide el diseño a filter_designer (hilo propio); SerialWorker
+    // toma el último diseño publicado al inicio de cada lote (ver FilterDesign.h)
+    FilterSpec filter_spec;
+    FilterDesigner filter_designer;
+
+    // Cadena de etapas aplicada en SerialWorker (ver ProcessingChain.h); chain_config es la
+    // copia editable de la UI, que se publica con processing_chain.Configure()
+    ChainConfig chain_config;
+    ProcessingChain processing_chain;
+    PluginRegistry plugins;  // Etapas nativas disponibles para la cadena (ver Plugins.h)
+
+    // Filtros candidatos sobre la misma entrada, uno por carril SIMD (ver FilterLanes.h): se
+    // diseñan en la UI variando la frecuencia o el orden de filter_spec, se superponen en
+    // Salida y Espectro, y uno puede promoverse al filtro vivo con su estado
+    bool candidates_enabled = false;
+    int candidates_count = 4;                         // 4 u 8 (cuatro por registro AVX2)
+    int candidates_parameter = 0;                     // 0 = frecuencia, 1 = orden
+    double candidates_from = 10, candidates_to = 40;  // Rango de frecuencias (Hz, escala logarítmica)
+    int candidates_order_from = 2, candidates_order_to = 8;
+    FilterSpec candidate_specs[FilterLanes::max_lanes];
+    double candidates_rate = 0;
+    std::shared_ptr<const FilterLanes::Candidates> candidates;
+    std::vector<double> candidate_trace, candidate_x, candidate_y;  // Copia y envolvente para graficar (solo UI thread)
+    std::vector<double> candidate_samples;                          // Copia para los espectros (solo AnalysisWorker)
+
+    // Respuesta en frecuencia del diseño o de la cadena hasta la derivación (ver FilterResponse.h);
+    // se recalcula solo cuando cambia el diseño, la cadena, el modo o la frecuencia de muestreo
+    FilterResponse response;
+    std::shared_ptr<const FilterDesign> response_design;
+    ChainConfig response_chain;
+    double response_rate = 0;
+    bool response_of_chain = false, response_key_chain = false;  // Modo pedido y modo calculado
+    int response_view = 0;           // 0 = magnitud, 1 = fase, 2 = retardo de grupo
+
+    // Medición de rendimiento del filtro por bloques frente a iir1 (ns por muestra y sección)
+    struct FilterBenchmark {
+        int rate;
+        double iir_ns, scalar_ns, unrolled_ns, avx2_ns;
+    };
+    std::vector<FilterBenchmark> filter_benchmark;
+
+    // Costo por orden a la frecuencia actual: lazo por sección frente al kernel desenrollado
+    // elegido por tabla (ns por muestra de toda la cascada)
+    struct OrderBenchmark {
+        int order, sections;
+        double loop_ns, table_ns;
+    };
+    std::vector<OrderBenchmark> order_benchmark;
+    double decimator_ns = 0, decimator_alias_db = 0;  // Diezmado: costo y peor alias medido con tonos
+
+    // Conversión de muestras a la frecuencia máxima: fórmula por muestra frente a la tabla y al
+    // cuantizador por lotes (ns por muestra) y carga de un núcleo a 100 kHz con cada una
+    double convert_formula_ns = 0, convert_table_ns = 0, quantize_formula_ns = 0, quantize_batch_ns = 0;
+
+    // Filtro en punto fijo ejecutado en el AVR (ver DeviceFilter.h); device_filter es el
+    // último diseño cuantizado y enviado (solo UI thread)
+    DeviceLink device_link;
+    BiquadQ15 device_filter = {};
+    bool device_filter_valid = false;
+    std::string device_filter_error;
+    double device_snr_db = 0;             // Cuantización frente a la cascada en double
+    uint16_t device_test_seed = 0, device_expected_crc = 0;
+    int device_tests_requested = 0;
 
     int width, height;  // Dimensiones de la ventana
 
@@ -83,12 +193,16 @@ class MainWindow {
     bool frozen = false;
     double frozen_left_limit = 0, frozen_right_limit = 5;
     double frozen_down_limit = -7, frozen_up_limit = 7;
-    int frozen_size = 0;
     
-    // Buffers para almacenar snapshot de datos cuando se congela la visualización
-    std::vector<double> frozen_dataX;
-    std::vector<double> frozen_dataY;
-    std::vector<double> frozen_dataY_filtered;
+    // Capturas congeladas: fijan un rango de los buffers vivos y solo se copian si
+    // SerialWorker va a sobrescribirlo (ver Snapshot.h)
+    SnapshotStore snapshots;
+    int active_snapshot = 0;  // Id de la captura visible en modo congelado (0 = ninguna)
+    std::vector<SnapshotRef> compared_snapshots;  // Capturas superpuestas en el frame actual (sin lock)
+
+    // Filtrado de fase cero de la captura visible, en paralelo (ver ZeroPhase.h)
+    ZeroPhaseFilter zero_phase;
+    bool zero_phase_enabled = false;
 
 public:
     MainWindow(int width, int height, Settings& config, SettingsWindow& ventanaConfig);
@@ -99,24 +213,34 @@ private:
     void CreateBuffers();
     void DestroyBuffers();
 
-    // Transformación de valores ADC (0-255) a voltaje (-6V a +6V)
-    double TransformSample(uint8_t v);
-    uint8_t InverseTransformSample(double v);
+    // Conversión de valores ADC (0-255) a voltaje (-6V a +6V) y de vuelta (ver SampleMapping.h):
+    // la UI publica un mapeo nuevo al cambiar Máximo o Mínimo y SerialWorker toma el último
+    // al inicio de cada lote
+    std::atomic<std::shared_ptr<const SampleMapping>> sample_mapping;
+    void UpdateSampleMapping();
 
     // Control de conexión serial
     bool started = false;
     void ToggleConnection();
 
-    void Start();  // Inicia adquisición y hilos de trabajo
+    bool Start();  // Inicia adquisición y hilos de trabajo (false si no hay memoria para los buffers)
     void Stop();   // Detiene adquisición y espera a que terminen los hilos
 
     // Gestión de filtros digitales
-    void SelectFilter(Filter filter);
-    void SetupFilter();       // Configura parámetros del filtro según sampling_rate
-    static void ResetFilters(); // Limpia el estado interno de los filtros
+    void SetupFilter();         // Pide el diseño de filter_spec para la frecuencia de muestreo actual
+    void DrawFilterDesigner();  // Controles de banda, familia, orden y frecuencias
+    void RunFilterBenchmark();  // Mide iir1 y la cascada por bloques en cada frecuencia de muestreo
+    void UpdateCandidates();    // Rediseña los candidatos si cambió el filtro, el rango o la cantidad
+    void DrawCandidates();      // Rango, lista de candidatos con su color y promoción al filtro vivo
+    void DrawProcessingChain(); // Lista de etapas: parámetros, orden, tiempo y derivación
+    void DrawDeviceFilter();    // Cuantización, envío y verificación del filtro del dispositivo
+    void UpdateResponse();      // Recalcula la respuesta en frecuencia si cambió alguna clave
+    void DrawResponse();        // Magnitud, fase o retardo de grupo sobre grilla logarítmica
 
     // Control de hilos de trabajo
     bool do_serial_work = true;
+    std::atomic_bool memory_error = false;  // No se pudieron comprometer páginas de los buffers (adquisición detenida)
+    bool PrepareBuffers(uint32_t count);    // Compromete las páginas para agregar 'count' muestras a cada buffer
     bool filter_open = true;  // Sección Filtro abierta por defecto en UI
     void SerialWorker();      // Hilo que lee datos del puerto serial y aplica filtros
 
@@ -126,12 +250,22 @@ private:
     // Control del gráfico de espectros
     bool spectrum_log_scale = true;  // true = logarítmica, false = lineal
     bool show_dominant_frequency_marker = true;  // Mostrar marcador de frecuencia dominante
+    bool spectrum_of_output = false;  // Espectro de la derivación de la cadena en lugar de la entrada
+    bool spectrum_low_frequency = false;  // Espectro de 10 s sobre la señal diezmada
+    bool spectrum_response = false;  // Superponer la magnitud de la respuesta (dB, eje derecho)
     void AnalysisWorker();      // Hilo que calcula FFT periódicamente
 
     float sidebar_width = 240;  // Ancho del panel lateral de control (píxeles)
 
     void ToggleFreeze();  // Alterna entre modo congelado y en vivo
     void DrawSidebar();   // Dibuja el panel lateral con todos los controles
+    void DrawSnapshots(); // Lista de capturas guardadas (ver, comparar, descartar)
+    void UpdateHistoryEnvelope(double left, double right, int pixels);  // Recalcula la caché si cambió el rango
+    void ExportHistory(double left, double right);  // Exporta un rango del historial a CSV
+    BlockSummary SummarizeRange(const BlockSummaries<>& blocks, const ScrollBuffer<double>* values,
+                                double from, double to);  // Resumen exacto de [from, to] (bordes desde values)
+    void FitVerticalAxis();  // Ajusta el eje Y al rango de la señal visible (resúmenes por bloque)
+    bool HistoryAvailable() const { return history.IsOpen() || code_history.IsOpen(); }  // Disco o RAM comprimida
 
 public:
     bool open = true;
@@ -0,0 +1,202 @@
+// MainsCanceller.cpp - NLMS por bloques con referencia sintetizada y lazo de frecuencia
+
+#include "MainsCanceller.h"
+
+#include <cmath>
+#include <numbers>
+
+#include "Simd.h"
+
+using std::numbers::pi;
+
+void MainsCanceller::Configure(double nominal_frequency, int harmonic_count, double adaptation, double sampling_rate) {
+    if (nominal_frequency != nominal || sampling_rate != rate) {
+        nominal = nominal_frequency;
+        rate = sampling_rate;
+        Reset();
+    }
+    step = adaptation;
+
+    // Solo los armónicos que caen bajo el 90% de Nyquist
+    int count = harmonic_count < 1 ? 1 : harmonic_count > max_harmonics ? max_harmonics : harmonic_count;
+    while (count > 1 && count * (nominal + 2) > 0.45 * rate)
+        count--;
+    for (int h = count; h < max_harmonics; h++)
+        wr[h] = wi[h] = 0;
+    harmonics = count;
+}
+
+void MainsCanceller::Reset() {
+    frequency = nominal;
+    phase = 0;
+    for (int h = 0; h < max_harmonics; h++)
+        wr[h] = wi[h] = 0;
+    has_angle = false;
+    power_in = power_out = 0;
+}
+
+double MainsCanceller::Amplitude() const {
+    return std::sqrt(wr[0] * wr[0] + wi[0] * wi[0]);
+}
+
+double MainsCanceller::AttenuationDb() const {
+    if (power_in <= 0 || power_out <= 0)
+        return 0;
+    return 10 * std::log10(power_in / power_out);
+}
+
+void MainsCanceller::Phasors(double* pr, double* pi_, double* sr, double* si) const {
+    // e^{j h phase} y e^{j h w} por potencias sucesivas del fundamental
+    double w = 2 * pi * frequency / rate;
+    double br = std::cos(phase), bi = std::sin(phase);
+    double wr1 = std::cos(w), wi1 = std::sin(w);
+    pr[0] = br;
+    pi_[0] = bi;
+    sr[0] = wr1;
+    si[0] = wi1;
+    for (int h = 1; h < harmonics; h++) {
+        pr[h] = pr[h - 1] * br - pi_[h - 1] * bi;
+        pi_[h] = pr[h - 1] * bi + pi_[h - 1] * br;
+        sr[h] = sr[h - 1] * wr1 - si[h - 1] * wi1;
+        si[h] = sr[h - 1] * wi1 + si[h - 1] * wr1;
+    }
+}
+
+void MainsCanceller::Process(double* data, uint32_t count) {
+    if (harmonics == 0)
+        return;
+    for (uint32_t n = 0; n < count; n += block) {
+        uint32_t length = count - n < block ? count - n : block;
+        if (length % 4 == 0 && CpuHasAvx2())
+            ProcessBlockAvx2(data + n, length);
+        else
+            ProcessBlock(data + n, length);
+    }
+}
+
+void MainsCanceller::ProcessBlock(double* data, uint32_t count) {
+    double pr[max_harmonics], pi_[max_harmonics], sr[max_harmonics], si[max_harmonics];
+    double gr[max_harmonics] = {}, gi[max_harmonics] = {};
+    Phasors(pr, pi_, sr, si);
+
+    double input_power = 0, output_power = 0;
+    for (uint32_t n = 0; n < count; n++) {
+        double y = 0;
+        for (int h = 0; h < harmonics; h++)
+            y += wr[h] * pr[h] + wi[h] * pi_[h];
+
+        double x = data[n];
+        double e = x - y;
+        data[n] = e;
+        input_power += x * x;
+        output_power += e * e;
+
+        for (int h = 0; h < harmonics; h++) {
+            gr[h] += e * pr[h];
+            gi[h] += e * pi_[h];
+            double r = pr[h] * sr[h] - pi_[h] * si[h];
+            pi_[h] = pr[h] * si[h] + pi_[h] * sr[h];
+            pr[h] = r;
+        }
+    }
+    Update(gr, gi, count, input_power, output_power);
+}
+
+SIMD_TARGET_AVX2 static double SumLanes(__m256d v) {
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+SIMD_TARGET_AVX2 void MainsCanceller::ProcessBlockAvx2(double* data, uint32_t count) {
+    double pr[max_harmonics], pi_[max_harmonics], sr[max_harmonics], si[max_harmonics];
+    Phasors(pr, pi_, sr, si);
+
+    // Carril k: fasor en la muestra k; cada vector avanza 4 muestras
+    __m256d cr[max_harmonics], ci[max_harmonics], rr[max_harmonics], ri[max_harmonics];
+    __m256d gr[max_harmonics], gi[max_harmonics], vwr[max_harmonics], vwi[max_harmonics];
+    for (int h = 0; h < harmonics; h++) {
+        alignas(32) double lr[4], li[4];
+        double r = pr[h], i = pi_[h];
+        for (int k = 0; k < 4; k++) {
+            lr[k] = r;
+            li[k] = i;
+            double t = r * sr[h] - i * si[h];
+            i = r * si[h] + i * sr[h];
+            r = t;
+        }
+        cr[h] = _mm256_load_pd(lr);
+        ci[h] = _mm256_load_pd(li);
+        rr[h] = _mm256_set1_pd(r * pr[h] + i * pi_[h]);  // e^{j 4 h w} = p_h[4] conj(p_h[0])
+        ri[h] = _mm256_set1_pd(i * pr[h] - r * pi_[h]);
+        gr[h] = gi[h] = _mm256_setzero_pd();
+        vwr[h] = _mm256_set1_pd(wr[h]);
+        vwi[h] = _mm256_set1_pd(wi[h]);
+    }
+
+    __m256d input_power = _mm256_setzero_pd(), output_power = _mm256_setzero_pd();
+    for (uint32_t n = 0; n < count; n += 4) {
+        __m256d y = _mm256_setzero_pd();
+        for (int h = 0; h < harmonics; h++)
+            y = _mm256_fmadd_pd(vwi[h], ci[h], _mm256_fmadd_pd(vwr[h], cr[h], y));
+
+        __m256d x = _mm256_loadu_pd(data + n);
+        __m256d e = _mm256_sub_pd(x, y);
+        _mm256_storeu_pd(data + n, e);
+        input_power = _mm256_fmadd_pd(x, x, input_power);
+        output_power = _mm256_fmadd_pd(e, e, output_power);
+
+        for (int h = 0; h < harmonics; h++) {
+            gr[h] = _mm256_fmadd_pd(e, cr[h], gr[h]);
+            gi[h] = _mm256_fmadd_pd(e, ci[h], gi[h]);
+            __m256d r = _mm256_fmsub_pd(cr[h], rr[h], _mm256_mul_pd(ci[h], ri[h]));
+            ci[h] = _mm256_fmadd_pd(cr[h], ri[h], _mm256_mul_pd(ci[h], rr[h]));
+            cr[h] = r;
+        }
+    }
+
+    double sum_r[max_harmonics], sum_i[max_harmonics];
+    for (int h = 0; h < harmonics; h++) {
+        sum_r[h] = SumLanes(gr[h]);
+        sum_i[h] = SumLanes(gi[h]);
+    }
+    Update(sum_r, sum_i, count, SumLanes(input_power), SumLanes(output_power));
+}
+
+void MainsCanceller::Update(const double* gradient_r, const double* gradient_i, uint32_t count,
+                            double input_power, double output_power) {
+    // NLMS por bloques: |r|^2 = armónicos (cada par seno/coseno suma 1). El gradiente se
+    // escala por bloque completo, así un lote corto aporta en proporción a sus muestras y la
+    // velocidad de adaptación no depende del tamaño de los lotes
+    double gain = step / (harmonics * (double)block);
+    for (int h = 0; h < harmonics; h++) {
+        wr[h] += gain * gradient_r[h];
+        wi[h] += gain * gradient_i[h];
+    }
+
+    double w = 2 * pi * frequency / rate;
+    phase = std::fmod(phase + w * count, 2 * pi);
+
+    // Potencias promedio (constante de tiempo de ~100 bloques)
+    power_in += 0.01 * (input_power / count - power_in);
+    power_out += 0.01 * (output_power / count - power_out);
+
+    // Lazo de frecuencia: rotación del fundamental y = Re((wr - j wi) e^{j phase}) entre bloques
+    if (Amplitude() * Amplitude() > 1e-4 * power_in) {
+        double angle = std::atan2(-wi[0], wr[0]);
+        if (has_angle) {
+            double delta = std::remainder(angle - previous_angle, 2 * pi);
+            double error = delta / (2 * pi) * rate / count;
+            frequency += 0.02 * error;
+            if (frequency > nominal + 2)
+                frequency = nominal + 2;
+            if (frequency < nominal - 2)
+                frequency = nominal - 2;
+        }
+        previous_angle = angle;
+        has_angle = true;
+    }
+    else {
+        has_angle = false;
+    }
+}
@@ -0,0 +1,60 @@
+// MainsCanceller.h - Cancelador adaptivo de interferencia de red (NLMS por bloques)
+//
+// Resta de la señal una combinación de senos y cosenos sintetizados a la frecuencia de red y
+// sus armónicos. Los pesos (amplitud y fase de cada armónico) se ajustan con NLMS: como cada
+// par seno/coseno tiene potencia 1, la normalización es constante (step / armónicos). A
+// diferencia de un notch fijo, sigue la deriva de la red y no atenúa el contenido vecino.
+//
+// Enganche de frecuencia: si la referencia difiere de la red en df, el peso del fundamental
+// rota a 2 pi df rad/s. La rotación medida entre bloques corrige la frecuencia de la
+// referencia (lazo de frecuencia, acotado a +-2 Hz de la nominal).
+//
+// Características:
+// - Pesos fijos durante bloques de block muestras (NLMS por bloques); fasores por recurrencia
+//   (solo un seno y un coseno por bloque)
+// - Ruta AVX2: 4 muestras consecutivas en los 4 carriles, un par de registros por armónico
+// - Ruta escalar para bloques incompletos o sin AVX2
+//
+// Thread-safety: una instancia pertenece a un único hilo (el que llama a Process)
+
+#pragma once
+
+#include <cstdint>
+
+class MainsCanceller {
+public:
+	static constexpr int max_harmonics = 8;
+	static constexpr uint32_t block = 32;  // Muestras por actualización de los pesos
+
+	// Conserva los pesos si no cambian la frecuencia nominal ni la de muestreo
+	void Configure(double nominal, int harmonics, double step, double sampling_rate);
+
+	void Reset();
+
+	// Cancela en el lugar (elige la ruta AVX2 si está disponible)
+	void Process(double* data, uint32_t count);
+
+	double Frequency() const { return frequency; }    // Frecuencia de red estimada (Hz)
+	double Amplitude() const;                          // Amplitud del fundamental cancelado
+	double AttenuationDb() const;                      // Potencia de entrada / salida (promedio)
+	int Harmonics() const { return harmonics; }        // Armónicos activos (los que caen bajo Nyquist)
+
+private:
+	void ProcessBlock(double* data, uint32_t count);
+	void ProcessBlockAvx2(double* data, uint32_t count);  // count múltiplo de 4, hasta block
+	void Update(const double* gradient_r, const double* gradient_i, uint32_t count,
+	            double input_power, double output_power);
+
+	// Fasores de cada armónico al inicio del bloque y su paso por muestra
+	void Phasors(double* pr, double* pi, double* sr, double* si) const;
+
+	int harmonics = 0;
+	double nominal = 0, frequency = 0, step = 0, rate = 0;
+	double phase = 0;  // Fase del fundamental en la próxima muestra (radianes)
+
+	alignas(32) double wr[max_harmonics] = {}, wi[max_harmonics] = {};
+
+	double previous_angle = 0;
+	bool has_angle = false;
+	double power_in = 0, power_out = 0;
+};
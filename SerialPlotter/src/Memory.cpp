@@ -0,0 +1,88 @@
+// Memory.cpp - Implementación de la reserva con compromiso diferido (Windows API)
+
+#define NOMINMAX
+#include "Memory.h"
+
+#include <Windows.h>
+#include <psapi.h>
+#include <utility>
+
+ReservedMemory::ReservedMemory(ReservedMemory&& other) noexcept :
+    base(std::exchange(other.base, nullptr)),
+    reserved_bytes(std::exchange(other.reserved_bytes, 0)),
+    committed_bytes(std::exchange(other.committed_bytes, 0))
+{
+}
+
+ReservedMemory& ReservedMemory::operator=(ReservedMemory&& other) noexcept {
+    if (this != &other) {
+        Release();
+        base = std::exchange(other.base, nullptr);
+        reserved_bytes = std::exchange(other.reserved_bytes, 0);
+        committed_bytes = std::exchange(other.committed_bytes, 0);
+    }
+    return *this;
+}
+
+ReservedMemory::~ReservedMemory() {
+    Release();
+}
+
+bool ReservedMemory::Reserve(size_t bytes) {
+    Release();
+    if (bytes == 0)
+        return true;
+
+    // MEM_RESERVE solo ocupa espacio de direcciones: no cuenta como memoria comprometida
+    base = (char*)VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_READWRITE);
+    if (!base)
+        return false;
+
+    reserved_bytes = bytes;
+    return true;
+}
+
+void ReservedMemory::Release() {
+    if (base)
+        VirtualFree(base, 0, MEM_RELEASE);
+    base = nullptr;
+    reserved_bytes = 0;
+    committed_bytes = 0;
+}
+
+bool ReservedMemory::Commit(size_t bytes) {
+    if (bytes <= committed_bytes)
+        return true;
+    if (!base || bytes > reserved_bytes)
+        return false;
+
+    // Comprometer en pasos de commit_step para amortizar las llamadas al sistema
+    size_t target = (bytes + commit_step - 1) / commit_step * commit_step;
+    if (target > reserved_bytes)
+        target = reserved_bytes;
+
+    if (!VirtualAlloc(base + committed_bytes, target - committed_bytes, MEM_COMMIT, PAGE_READWRITE))
+        return false;
+    committed_bytes = target;
+    return true;
+}
+
+void ReservedMemory::Decommit() {
+    if (base && committed_bytes > 0)
+        VirtualFree(base, committed_bytes, MEM_DECOMMIT);
+    committed_bytes = 0;
+}
+
+size_t ReservedMemory::ResidentBytes() {
+    PROCESS_MEMORY_COUNTERS counters{ sizeof(counters) };
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.WorkingSetSize;
+}
+
+size_t ReservedMemory::CommittedBytes() {
+    PROCESS_MEMORY_COUNTERS counters{ sizeof(counters) };
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PagefileUsage;
+}
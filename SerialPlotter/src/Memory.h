@@ -0,0 +1,55 @@
+// Memory.h - Reserva de memoria con compromiso (commit) diferido de páginas
+//
+// ReservedMemory reserva espacio de direcciones para un buffer grande sin comprometer
+// memoria física ni del archivo de paginación. Las páginas se comprometen en pasos de
+// commit_step a medida que el buffer crece, así una sesión corta solo ocupa lo que usa.
+//
+// También expone la memoria del proceso (working set y memoria comprometida) para
+// mostrarla en la interfaz.
+
+#pragma once
+
+#include <cstddef>
+
+class ReservedMemory {
+public:
+	static constexpr size_t commit_step = 1 << 20;  // Las páginas se comprometen de a 1 MB
+
+	ReservedMemory() = default;
+	ReservedMemory(const ReservedMemory&) = delete;
+	ReservedMemory& operator=(const ReservedMemory&) = delete;
+
+	ReservedMemory(ReservedMemory&& other) noexcept;
+	ReservedMemory& operator=(ReservedMemory&& other) noexcept;
+
+	~ReservedMemory();
+
+	// Reserva 'bytes' de espacio de direcciones (sin comprometer páginas)
+	bool Reserve(size_t bytes);
+
+	// Libera la reserva completa
+	void Release();
+
+	// Compromete las páginas necesarias para que [0, bytes) sea utilizable
+	// Retorna false si no hay reserva o el sistema no pudo comprometerlas (sin memoria
+	// o archivo de paginación lleno): solo [0, committed()) es utilizable
+	bool Commit(size_t bytes);
+
+	// Devuelve al sistema las páginas comprometidas (conserva la reserva)
+	void Decommit();
+
+	void* data() const { return base; }
+	size_t reserved() const { return reserved_bytes; }
+	size_t committed() const { return committed_bytes; }
+
+	// Memoria residente (working set) del proceso en bytes
+	static size_t ResidentBytes();
+
+	// Memoria privada comprometida del proceso en bytes
+	static size_t CommittedBytes();
+
+private:
+	char* base = nullptr;
+	size_t reserved_bytes = 0;
+	size_t committed_bytes = 0;
+};
@@ -0,0 +1,115 @@
+// Plugins.cpp - Búsqueda y carga de las DLL de plugins (LoadLibrary; dlopen fuera de Windows)
+
+#include "Plugins.h"
+
+#include <format>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#ifdef _WIN32
+static constexpr const char* library_extension = ".dll";
+
+static void* OpenLibrary(const std::filesystem::path& path) {
+    return LoadLibraryW(path.c_str());
+}
+
+static void* FindSymbol(void* module, const char* name) {
+    return (void*)GetProcAddress((HMODULE)module, name);
+}
+
+static void CloseLibrary(void* module) {
+    FreeLibrary((HMODULE)module);
+}
+#else
+static constexpr const char* library_extension = ".so";
+
+static void* OpenLibrary(const std::filesystem::path& path) {
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+
+static void* FindSymbol(void* module, const char* name) {
+    return dlsym(module, name);
+}
+
+static void CloseLibrary(void* module) {
+    dlclose(module);
+}
+#endif
+
+StagePlugin::~StagePlugin() {
+    if (module)
+        CloseLibrary(module);
+}
+
+std::filesystem::path PluginRegistry::DefaultDirectory() {
+#ifdef _WIN32
+    wchar_t executable[MAX_PATH];
+    DWORD length = GetModuleFileNameW(nullptr, executable, MAX_PATH);
+    if (length == 0 || length == MAX_PATH)
+        return "plugins";
+    return std::filesystem::path(executable).parent_path() / "plugins";
+#else
+    std::error_code error;
+    auto executable = std::filesystem::read_symlink("/proc/self/exe", error);
+    return error ? std::filesystem::path("plugins") : executable.parent_path() / "plugins";
+#endif
+}
+
+int PluginRegistry::Scan(const std::filesystem::path& directory) {
+    errors.clear();
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error))
+        return 0;
+
+    int added = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        const std::filesystem::path& path = entry.path();
+        if (!entry.is_regular_file() || path.extension() != library_extension)
+            continue;
+
+        bool known = false;
+        for (const auto& plugin : loaded)
+            known |= plugin->path == path;
+        if (known)
+            continue;
+
+        std::string file = path.filename().string();
+        auto plugin = std::make_shared<StagePlugin>();
+        plugin->path = path;
+        plugin->module = OpenLibrary(path);
+        if (!plugin->module) {
+            errors.push_back(std::format("{}: no se pudo cargar", file));
+            continue;
+        }
+        auto get_api = (SpStageApiFunction)FindSymbol(plugin->module, SP_STAGE_API_SYMBOL);
+        const SpStageApi* api = get_api ? get_api() : nullptr;
+        if (!api) {
+            errors.push_back(std::format("{}: no exporta {}", file, SP_STAGE_API_SYMBOL));
+            continue;
+        }
+        if (api->api_version != SP_API_VERSION) {
+            errors.push_back(std::format("{}: version {} (se espera {})", file, api->api_version, SP_API_VERSION));
+            continue;
+        }
+        if (!api->describe_params || !api->init || !api->process || !api->reset || !api->release) {
+            errors.push_back(std::format("{}: faltan funciones de la interfaz", file));
+            continue;
+        }
+
+        const SpParam* params = nullptr;
+        uint32_t count = api->describe_params(&params);
+        count = count < SP_MAX_PARAMS ? count : SP_MAX_PARAMS;
+        for (uint32_t i = 0; params && i < count; i++)
+            plugin->params.push_back({ params[i].name ? params[i].name : "", params[i].min, params[i].max, params[i].initial });
+        plugin->api = api;
+        plugin->name = api->name ? api->name : path.stem().string();
+        loaded.push_back(std::move(plugin));
+        added++;
+    }
+    return added;
+}
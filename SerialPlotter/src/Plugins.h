@@ -0,0 +1,53 @@
+// Plugins.h - Carga de etapas nativas (DLL) con la interfaz C de stage_plugin.h
+//
+// PluginRegistry busca las DLL de la carpeta "plugins" junto al ejecutable, valida la
+// versión de la interfaz y copia la descripción de los parámetros. Cada StagePlugin
+// mantiene cargada su DLL mientras alguien lo referencie (la cadena y las instancias en
+// SerialWorker guardan un shared_ptr), así nunca se descarga código en uso.
+//
+// Thread-safety: Scan() y la lista de cargados solo desde el hilo de UI; los StagePlugin
+// son inmutables y se comparten con SerialWorker a través de la configuración de la cadena
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stage_plugin.h>
+
+struct StagePlugin {
+	struct Param {
+		std::string name;
+		double min = 0, max = 1, initial = 0;
+	};
+
+	std::string name;
+	std::filesystem::path path;
+	const SpStageApi* api = nullptr;
+	std::vector<Param> params;      // Como máximo SP_MAX_PARAMS
+	void* module = nullptr;         // HMODULE (o handle de dlopen)
+
+	StagePlugin() = default;
+	StagePlugin(const StagePlugin&) = delete;
+	StagePlugin& operator=(const StagePlugin&) = delete;
+	~StagePlugin();
+};
+
+class PluginRegistry {
+public:
+	// Carpeta "plugins" junto al ejecutable
+	static std::filesystem::path DefaultDirectory();
+
+	// Carga las bibliotecas nuevas de la carpeta (las ya cargadas se conservan) y retorna
+	// cuántas se agregaron; los rechazos quedan en Errors()
+	int Scan(const std::filesystem::path& directory);
+
+	const std::vector<std::shared_ptr<const StagePlugin>>& Loaded() const { return loaded; }
+	const std::vector<std::string>& Errors() const { return errors; }
+
+private:
+	std::vector<std::shared_ptr<const StagePlugin>> loaded;
+	std::vector<std::string> errors;  // Del último Scan()
+};
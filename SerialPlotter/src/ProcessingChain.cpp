@@ -0,0 +1,351 @@
+// ProcessingChain.cpp - Etapas de la cadena y aplicación de configuraciones por lote
+
+#include "ProcessingChain.h"
+
+#include <Iir.h>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+
+const char* StageName(StageType type) {
+    switch (type) {
+        case StageType::DcBlock:  return "Quitar continua";
+        case StageType::Gain:     return "Ganancia";
+        case StageType::Notch:    return "Notch";
+        case StageType::Filter:   return "Filtro";
+        case StageType::Decimate: return "Diezmado";
+        case StageType::MainsCancel: return "Cancelar red";
+        case StageType::MovingAverage: return "Media movil";
+        case StageType::Cic:      return "CIC";
+        case StageType::Median:   return "Mediana";
+        case StageType::Hampel:   return "Hampel";
+        case StageType::Plugin:   return "Plugin";
+    }
+    return "";
+}
+
+// ─── Etapas ──────────────────────────────────────────────────────────────────────────────
+
+void ProcessingChain::DcBlockStage::Configure(const StageConfig& config, double fs) {
+    // y[n] = x[n] - x[n-1] + r y[n-1], con r = exp(-2 pi fc / fs)
+    r = std::exp(-2 * std::numbers::pi * config.cutoff / fs);
+}
+
+void ProcessingChain::DcBlockStage::Process(double* data, uint32_t count) {
+    double px = x1, py = y1;
+    for (uint32_t n = 0; n < count; n++) {
+        double x = data[n];
+        py = x - px + r * py;
+        px = x;
+        data[n] = py;
+    }
+    x1 = px;
+    y1 = py;
+}
+
+void ProcessingChain::GainStage::Configure(const StageConfig& config, double) {
+    gain = std::pow(10.0, config.gain_db / 20);
+}
+
+void ProcessingChain::GainStage::Process(double* data, uint32_t count) {
+    for (uint32_t n = 0; n < count; n++)
+        data[n] *= gain;
+}
+
+static BiquadCoefficients NotchCoefficients(const StageConfig& config, double fs) {
+    double nyquist = fs / 2;
+    double frequency = config.frequency < 0.1 ? 0.1 : config.frequency > nyquist * 0.99 ? nyquist * 0.99 : config.frequency;
+    double width = config.width < 0.1 ? 0.1 : config.width;
+
+    Iir::RBJ::IIRNotch design;
+    design.setup(fs, frequency, frequency / width);
+    return ToCoefficients(design);
+}
+
+void ProcessingChain::NotchStage::Configure(const StageConfig& config, double fs) {
+    BiquadCoefficients coefficients = NotchCoefficients(config, fs);
+    notch.SetCoefficients(&coefficients, 1);  // Misma cantidad de secciones: conserva el estado
+}
+
+void ProcessingChain::NotchStage::Process(double* data, uint32_t count) {
+    notch.Process(data, count);
+}
+
+void ProcessingChain::FilterStage::Process(double* data, uint32_t count) {
+    // Sin compuerta Active(): Process carga el diseño pendiente y no hace nada si no hay filtro
+    filter->Process(data, count);
+}
+
+void ProcessingChain::DecimateStage::Configure(const StageConfig& config, double) {
+    factor = config.factor < 1 ? 1 : config.factor;
+    phase = phase % factor;
+}
+
+void ProcessingChain::DecimateStage::Process(double* data, uint32_t count) {
+    for (uint32_t n = 0; n < count; n++) {
+        if (phase == 0)
+            held = data[n];
+        data[n] = held;
+        if (++phase == factor)
+            phase = 0;
+    }
+}
+
+void ProcessingChain::MainsStage::Configure(const StageConfig& config, double fs) {
+    canceller.Configure(config.frequency, config.harmonics, config.step, fs);
+}
+
+void ProcessingChain::MainsStage::Process(double* data, uint32_t count) {
+    canceller.Process(data, count);
+}
+
+void ProcessingChain::CicStage::Configure(const StageConfig& config, double) {
+    // La media móvil es un CIC de una sola etapa
+    cic.Configure(config.length, config.type == StageType::Cic ? config.order : 1, config.compensate);
+}
+
+void ProcessingChain::CicStage::Process(double* data, uint32_t count) {
+    cic.Process(data, count);
+}
+
+void ProcessingChain::MedianStage::Configure(const StageConfig& config, double) {
+    median.Configure(config.length, config.type == StageType::Hampel, config.threshold);
+}
+
+void ProcessingChain::MedianStage::Process(double* data, uint32_t count) {
+    median.Process(data, count);
+}
+
+void ProcessingChain::PluginStage::Configure(const StageConfig& config, double sampling_rate) {
+    if (!config.plugin) {
+        plugin = nullptr;
+        state = nullptr;
+        return;
+    }
+    uint32_t count = (uint32_t)config.plugin->params.size();
+    bool same_instance = state && config.plugin == plugin && sampling_rate == fs;
+    if (same_instance && config.plugin_params == params)
+        return;
+
+    // Mismo plugin y frecuencia: cambiar parámetros sin perder el estado si el plugin lo permite
+    const SpStageApi* api = config.plugin->api;
+    if (same_instance && api->configure) {
+        api->configure(state.get(), config.plugin_params.data(), count);
+    }
+    else {
+        auto owner = config.plugin;
+        void* instance = api->init(sampling_rate, config.plugin_params.data(), count);
+        state = !instance ? nullptr : std::shared_ptr<void>(instance, [owner](void* s) { owner->api->release(s); });
+    }
+    plugin = config.plugin;
+    params = config.plugin_params;
+    fs = sampling_rate;
+}
+
+void ProcessingChain::PluginStage::Process(double* data, uint32_t count) {
+    // En el lugar: entrada y salida son el mismo lote (sin copias)
+    if (state)
+        plugin->api->process(state.get(), data, data, count);
+}
+
+// ─── Equivalente lineal ──────────────────────────────────────────────────────────────────
+
+// Convolución directa (solo para la respuesta en frecuencia: se calcula al cambiar la cadena)
+static std::vector<double> Convolve(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<double> result(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); i++)
+        for (size_t k = 0; k < b.size(); k++)
+            result[i + k] += a[i] * b[k];
+    return result;
+}
+
+LinearChain LinearizeChain(const ChainConfig& config, int last, double sampling_rate, const FilterDesign* design) {
+    LinearChain chain;
+    std::vector<double> smoothing;  // Medias móviles y CIC convolucionados
+    for (int i = 0; i <= last && i < (int)config.stages.size(); i++) {
+        const StageConfig& stage = config.stages[i];
+        switch (stage.type) {
+            case StageType::DcBlock: {
+                // y[n] = x[n] - x[n-1] + r y[n-1]
+                double r = std::exp(-2 * std::numbers::pi * stage.cutoff / sampling_rate);
+                chain.sections.push_back({ 1, -1, 0, -r, 0 });
+                break;
+            }
+            case StageType::Gain:
+                chain.gain *= std::pow(10.0, stage.gain_db / 20);
+                break;
+            case StageType::Notch:
+                chain.sections.push_back(NotchCoefficients(stage, sampling_rate));
+                break;
+            case StageType::Filter:
+                if (design) {
+                    chain.sections.insert(chain.sections.end(), design->coefficients, design->coefficients + design->sections);
+                    if (design->fir)
+                        chain.fir = design->fir;
+                }
+                break;
+            case StageType::MovingAverage:
+            case StageType::Cic: {
+                auto taps = CicFilter::Taps(stage.length, stage.type == StageType::Cic ? stage.order : 1, stage.compensate);
+                smoothing = smoothing.empty() ? std::move(taps) : Convolve(smoothing, taps);
+                break;
+            }
+            case StageType::Decimate:
+            case StageType::MainsCancel:
+            case StageType::Median:
+            case StageType::Hampel:
+            case StageType::Plugin:
+                break;
+        }
+    }
+
+    // Un único FIR equivalente: el de las medias y el del diseño (sin preparar, solo los coeficientes)
+    if (!smoothing.empty()) {
+        auto kernel = std::make_shared<FirKernel>();
+        kernel->taps = chain.fir ? Convolve(chain.fir->taps, smoothing) : std::move(smoothing);
+        chain.fir = std::move(kernel);
+    }
+    return chain;
+}
+
+// ─── Cadena ──────────────────────────────────────────────────────────────────────────────
+
+void ProcessingChain::Configure(const ChainConfig& config) {
+    pending.store(std::make_shared<const ChainConfig>(config), std::memory_order_release);
+}
+
+void ProcessingChain::Reset() {
+    stages.clear();
+    types.clear();
+    applied = nullptr;
+    applied_rate = 0;
+    filter.Reset();
+    lanes.Reset();
+    processed = 0;
+    superseded = nullptr;
+    has_superseded = false;
+    for (int i = 0; i < max_stages; i++) {
+        stage_ns[i].store(0, std::memory_order_relaxed);
+        stage_peak_ns[i].store(0, std::memory_order_relaxed);
+        mains_frequency[i].store(0, std::memory_order_relaxed);
+        mains_amplitude[i].store(0, std::memory_order_relaxed);
+        mains_attenuation[i].store(0, std::memory_order_relaxed);
+        replaced[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+ProcessingChain::MainsStatus ProcessingChain::Mains(int index) const {
+    if (index < 0 || index >= max_stages)
+        return {};
+    return { mains_frequency[index].load(std::memory_order_relaxed),
+             mains_amplitude[index].load(std::memory_order_relaxed),
+             mains_attenuation[index].load(std::memory_order_relaxed) };
+}
+
+void ProcessingChain::Apply(const std::shared_ptr<const ChainConfig>& config, double sampling_rate) {
+    std::vector<Stage> next;
+    std::vector<StageType> next_types;
+    int count = !config ? 0 : (int)config->stages.size() < max_stages ? (int)config->stages.size() : max_stages;
+    next.reserve(count);
+
+    for (int i = 0; i < count; i++) {
+        const StageConfig& stage = config->stages[i];
+
+        // Misma posición y mismo tipo: se reutiliza la etapa con su estado
+        if (i < (int)stages.size() && types[i] == stage.type) {
+            next.push_back(std::move(stages[i]));
+        }
+        else {
+            switch (stage.type) {
+                case StageType::DcBlock:  next.emplace_back(DcBlockStage{}); break;
+                case StageType::Gain:     next.emplace_back(GainStage{}); break;
+                case StageType::Notch:    next.emplace_back(NotchStage{}); break;
+                case StageType::Filter:   next.emplace_back(FilterStage{ &filter }); break;
+                case StageType::Decimate: next.emplace_back(DecimateStage{}); break;
+                case StageType::MainsCancel: next.emplace_back(MainsStage{}); break;
+                case StageType::MovingAverage:
+                case StageType::Cic:      next.emplace_back(CicStage{}); break;
+                case StageType::Median:
+                case StageType::Hampel:   next.emplace_back(MedianStage{}); break;
+                case StageType::Plugin:   next.emplace_back(PluginStage{}); break;
+            }
+            stage_ns[i].store(0, std::memory_order_relaxed);
+            stage_peak_ns[i].store(0, std::memory_order_relaxed);
+        }
+        std::visit([&](auto& s) { s.Configure(stage, sampling_rate); }, next.back());
+        next_types.push_back(stage.type);
+    }
+
+    stages = std::move(next);
+    types = std::move(next_types);
+    tap = !config || config->tap < -1 ? -1 : config->tap >= count ? count - 1 : config->tap;
+    applied = config;
+    applied_rate = sampling_rate;
+}
+
+void ProcessingChain::Process(double* data, double* tap_out, uint32_t count, double sampling_rate,
+                              std::shared_ptr<const FilterDesign> design) {
+    auto config = pending.load(std::memory_order_acquire);
+    if (config != applied || sampling_rate != applied_rate)
+        Apply(config, sampling_rate);
+
+    // Reinicios pedidos por la UI (solo etapas Plugin: las demás no exponen su estado)
+    uint32_t resets = reset_requests.exchange(0, std::memory_order_acquire);
+    for (int i = 0; resets && i < (int)stages.size(); i++) {
+        auto* plugin = std::get_if<PluginStage>(&stages[i]);
+        if ((resets & (1u << i)) && plugin && plugin->state)
+            plugin->plugin->api->reset(plugin->state.get());
+    }
+
+    // Promoción de un candidato: el filtro vivo sigue con los coeficientes y el estado del carril
+    int promoted = lanes.TakePromotion();
+    if (promoted >= 0 && lanes.Design(promoted)) {
+        double state1[BiquadCascade::max_sections], state2[BiquadCascade::max_sections];
+        lanes.State(promoted, state1, state2);
+        filter.Adopt(lanes.Design(promoted), state1, state2);
+        superseded = design;
+        has_superseded = true;
+    }
+    if (!has_superseded || design != superseded) {
+        has_superseded = false;
+        superseded = nullptr;
+        filter.Update(std::move(design));
+    }
+
+    if (tap < 0)
+        std::copy(data, data + count, tap_out);
+
+    bool lanes_done = false;
+    for (int i = 0; i < (int)stages.size(); i++) {
+        if (types[i] == StageType::Filter && !lanes_done) {
+            lanes.Process(data, count, processed);
+            lanes_done = true;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        std::visit([&](auto& s) { s.Process(data, count); }, stages[i]);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / count;
+        stage_ns[i].store(stage_ns[i].load(std::memory_order_relaxed) * 0.99 + ns * 0.01, std::memory_order_relaxed);
+        double peak = stage_peak_ns[i].load(std::memory_order_relaxed) * 0.995;
+        stage_peak_ns[i].store(ns > peak ? ns : peak, std::memory_order_relaxed);
+
+        if (auto* mains = std::get_if<MainsStage>(&stages[i])) {
+            mains_frequency[i].store(mains->canceller.Frequency(), std::memory_order_relaxed);
+            mains_amplitude[i].store(mains->canceller.Amplitude(), std::memory_order_relaxed);
+            mains_attenuation[i].store(mains->canceller.AttenuationDb(), std::memory_order_relaxed);
+        }
+        if (auto* median = std::get_if<MedianStage>(&stages[i]))
+            replaced[i].store(median->median.Replaced(), std::memory_order_relaxed);
+
+        if (i == tap)
+            std::copy(data, data + count, tap_out);
+    }
+
+    // Cadena vacía: la derivación es la entrada sin cambios
+    if (stages.empty() && tap >= 0)
+        std::copy(data, data + count, tap_out);
+
+    if (!lanes_done)
+        lanes.Process(data, count, processed);
+    processed += count;
+}
@@ -0,0 +1,209 @@
+// ProcessingChain.h - Cadena configurable de etapas de procesamiento por bloques
+//
+// SerialWorker ya no aplica un único filtro fijo: cada lote pasa por una cadena de etapas
+// armada en la UI (remoción de continua, ganancia, notch, cancelación adaptiva de red,
+// media móvil y CIC, mediana y rechazo de picos, filtro diseñado, diezmado y etapas
+// nativas cargadas como plugins, ver Plugins.h).
+//
+// Características:
+// - Cada etapa procesa el lote completo en el lugar; la cadena se recorre con std::visit
+//   una vez por etapa y por lote (sin despacho virtual por muestra)
+// - Cada etapa guarda su propio estado; al cambiar la configuración se conserva el estado
+//   de las etapas que siguen en la misma posición con el mismo tipo
+// - Tiempo medido por etapa (ns por muestra: promedio exponencial y pico por lote)
+// - Derivación (tap): la salida de cualquier etapa, o la entrada, se copia aparte para
+//   graficarla y analizarla, mientras al dispositivo siempre se envía la salida final
+// - Filtros candidatos (ver FilterLanes.h): corren sobre la entrada de la etapa Filter (o
+//   sobre la salida final si no hay etapa Filter) y uno puede promoverse al filtro vivo
+//
+// Thread-safety: la UI publica configuraciones inmutables con Configure(); SerialWorker
+// las toma en el borde de un lote dentro de Process(). Los tiempos son atómicos.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "Biquad.h"
+#include "Cic.h"
+#include "FilterLanes.h"
+#include "LiveFilter.h"
+#include "MainsCanceller.h"
+#include "Plugins.h"
+#include "RunningMedian.h"
+
+enum class StageType {
+	DcBlock,    // Pasa altos de un polo para quitar la continua
+	Gain,
+	Notch,      // Notch RBJ propio de la etapa (independiente del filtro diseñado)
+	Filter,     // Filtro diseñado en la sección Filtro (ver FilterDesign.h)
+	Decimate,   // Retiene una de cada 'factor' muestras (la salida sigue alineada con el eje de tiempo)
+	MainsCancel, // Resta la red y sus armónicos con pesos adaptivos (ver MainsCanceller.h)
+	MovingAverage, // Media móvil de 'length' muestras, O(1) por muestra (ver Cic.h)
+	Cic,        // 'order' medias móviles de 'length' muestras en cascada (ver Cic.h)
+	Median,     // Mediana móvil de 'length' muestras (ver RunningMedian.h)
+	Hampel,     // Reemplaza por la mediana las muestras a más de 'threshold' desvíos (MAD)
+	Plugin      // Etapa de una DLL cargada en tiempo de ejecución (ver stage_plugin.h)
+};
+
+// Parámetros de una etapa (cada tipo usa solo los suyos)
+struct StageConfig {
+	StageType type = StageType::Filter;
+	double cutoff = 0.5;        // DcBlock: frecuencia de corte en Hz
+	double gain_db = 0;         // Gain
+	double frequency = 50;      // Notch: frecuencia central en Hz; MainsCancel: frecuencia nominal de red
+	double width = 2;           // Notch: ancho de banda en Hz
+	int factor = 4;             // Decimate
+	int harmonics = 4;          // MainsCancel: fundamental y armónicos cancelados
+	double step = 0.05;         // MainsCancel: paso NLMS por bloque (0 a 1)
+	int length = 16;            // MovingAverage, Cic: muestras por media; Median, Hampel: ventana (impar)
+	int order = 3;              // Cic: medias en cascada
+	bool compensate = false;    // MovingAverage, Cic: FIR de compensación de la caída en la banda pasante
+	double threshold = 3;       // Hampel: umbral en desvíos estándar estimados con el MAD
+	std::shared_ptr<const StagePlugin> plugin;               // Plugin
+	std::array<double, SP_MAX_PARAMS> plugin_params = {};    // Plugin: en el orden de describe_params
+
+	bool operator==(const StageConfig&) const = default;
+};
+
+struct ChainConfig {
+	std::vector<StageConfig> stages;
+	int tap = 0;                // Etapa cuya salida se grafica (-1 = entrada)
+
+	bool operator==(const ChainConfig&) const = default;
+};
+
+const char* StageName(StageType type);
+
+// Equivalente lineal de una cadena, para su respuesta en frecuencia (ver FilterResponse.h)
+struct LinearChain {
+	std::vector<BiquadCoefficients> sections;
+	std::shared_ptr<const FirKernel> fir;
+	double gain = 1;
+};
+
+// Etapas 0 a last (inclusive) con el diseño dado para la etapa Filter (puede ser nullptr).
+// Decimate se omite: retener muestras no es invariante en el tiempo. MainsCancel también:
+// es adaptiva (en régimen se comporta como un notch angosto en cada armónico); Median y
+// Hampel no son lineales; Plugin es desconocida y también se omite. MovingAverage
+// y Cic se convolucionan en el FIR de la cadena (junto con el del diseño, si es FIR)
+LinearChain LinearizeChain(const ChainConfig& config, int last, double sampling_rate, const FilterDesign* design);
+
+class ProcessingChain {
+public:
+	static constexpr int max_stages = 8;
+
+	// Publica una configuración nueva (UI thread); se aplica en el próximo lote
+	void Configure(const ChainConfig& config);
+
+	// Descarta el estado de todas las etapas (llamar sin SerialWorker corriendo)
+	void Reset();
+
+	// Procesa un lote en el lugar. design: último diseño para la etapa Filter (o nullptr)
+	// tap: recibe la salida de la etapa derivada (count muestras)
+	void Process(double* data, double* tap, uint32_t count, double sampling_rate,
+	             std::shared_ptr<const FilterDesign> design);
+
+	// Costo medido de cada etapa de la configuración aplicada (ns por muestra)
+	double StageNs(int index) const { return index >= 0 && index < max_stages ? stage_ns[index].load(std::memory_order_relaxed) : 0; }
+
+	// Lote más lento reciente de cada etapa (ns por muestra, decae ~0.5 % por lote)
+	double StagePeakNs(int index) const { return index >= 0 && index < max_stages ? stage_peak_ns[index].load(std::memory_order_relaxed) : 0; }
+
+	// Pide descartar la historia de una etapa Plugin en el próximo lote (llama a su reset)
+	void ResetStage(int index) { if (index >= 0 && index < max_stages) reset_requests.fetch_or(1u << index, std::memory_order_release); }
+
+	// Estado publicado de una etapa MainsCancel (ceros si la etapa es de otro tipo)
+	struct MainsStatus {
+		double frequency = 0, amplitude = 0, attenuation_db = 0;
+	};
+	MainsStatus Mains(int index) const;
+
+	// Muestras reemplazadas por una etapa Hampel desde que se creó (0 si es de otro tipo)
+	uint64_t Replaced(int index) const { return index >= 0 && index < max_stages ? replaced[index].load(std::memory_order_relaxed) : 0; }
+
+	// Estado del filtro diseñado (contadores de cambios, ver LiveFilter.h)
+	const LiveFilter& Filter() const { return filter; }
+
+	// Filtros candidatos: la UI publica candidatos, pide promociones y lee las salidas
+	FilterLanes& Lanes() { return lanes; }
+	const FilterLanes& Lanes() const { return lanes; }
+
+private:
+	struct DcBlockStage {
+		double r = 0, x1 = 0, y1 = 0;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	struct GainStage {
+		double gain = 1;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	struct NotchStage {
+		BiquadCascade notch;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	struct FilterStage {
+		LiveFilter* filter = nullptr;
+		void Configure(const StageConfig&, double) {}
+		void Process(double* data, uint32_t count);
+	};
+	struct DecimateStage {
+		int factor = 1, phase = 0;
+		double held = 0;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	struct MainsStage {
+		MainsCanceller canceller;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	struct CicStage {
+		CicFilter cic;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	struct MedianStage {
+		RunningMedian median;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	struct PluginStage {
+		std::shared_ptr<const StagePlugin> plugin;
+		std::shared_ptr<void> state;  // El deleter llama a release y mantiene cargada la DLL
+		std::array<double, SP_MAX_PARAMS> params = {};
+		double fs = 0;
+		void Configure(const StageConfig& config, double fs);
+		void Process(double* data, uint32_t count);
+	};
+	using Stage = std::variant<DcBlockStage, GainStage, NotchStage, FilterStage, DecimateStage, MainsStage, CicStage, MedianStage, PluginStage>;
+
+	void Apply(const std::shared_ptr<const ChainConfig>& config, double sampling_rate);
+
+	std::atomic<std::shared_ptr<const ChainConfig>> pending;
+	std::atomic<uint32_t> reset_requests = 0;  // Un bit por etapa
+
+	// Solo SerialWorker
+	std::shared_ptr<const ChainConfig> applied;
+	double applied_rate = 0;
+	std::vector<Stage> stages;
+	std::vector<StageType> types;
+	int tap = 0;
+	LiveFilter filter;  // Único: la etapa Filter toma el diseño de la sección Filtro
+	FilterLanes lanes;
+	uint64_t processed = 0;  // Muestras procesadas desde Reset() (índice de los candidatos)
+
+	// Al promover un candidato, el diseño que la UI reemplaza se ignora hasta que llegue otro
+	std::shared_ptr<const FilterDesign> superseded;
+	bool has_superseded = false;
+
+	std::atomic<double> stage_ns[max_stages] = {}, stage_peak_ns[max_stages] = {};
+	std::atomic<double> mains_frequency[max_stages] = {}, mains_amplitude[max_stages] = {}, mains_attenuation[max_stages] = {};
+	std::atomic<uint64_t> replaced[max_stages] = {};
+};
@@ -0,0 +1,116 @@
+// Pyramid.cpp - Implementación de la pirámide min/max de nivel de detalle
+
+#include "Pyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Cubeta vacía: cualquier muestra la reemplaza al combinarse
+static constexpr PyramidBucket empty_bucket = {
+	std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), 0
+};
+
+static void Merge(PyramidBucket& into, const PyramidBucket& bucket) {
+	into.min = std::min(into.min, bucket.min);
+	into.max = std::max(into.max, bucket.max);
+	into.sum += bucket.sum;
+}
+
+void MinMaxPyramid::Reset(uint32_t history) {
+	level_count = 0;
+	for (int level = 0; level < max_levels && BucketSize(level) <= history; level++) {
+		Level& l = levels[level];
+		// +2 cubetas de margen: la más antigua puede estar siendo reemplazada por el productor
+		l.ring.assign(history / BucketSize(level) + 2, empty_bucket);
+		l.partial = empty_bucket;
+		l.partial_count = 0;
+		l.committed.store(0, std::memory_order_relaxed);
+		level_count++;
+	}
+}
+
+void MinMaxPyramid::Push(double value) {
+	if (level_count == 0)
+		return;
+
+	Level& base = levels[0];
+	float v = (float)value;
+	base.partial.min = std::min(base.partial.min, v);
+	base.partial.max = std::max(base.partial.max, v);
+	base.partial.sum += value;
+
+	if (++base.partial_count == BucketSize(0)) {
+		Commit(0, base.partial);
+		base.partial = empty_bucket;
+		base.partial_count = 0;
+	}
+}
+
+void MinMaxPyramid::Commit(int level, const PyramidBucket& bucket) {
+	// Publicar la cubeta completa en el nivel actual
+	Level& l = levels[level];
+	uint64_t n = l.committed.load(std::memory_order_relaxed);
+	l.ring[n % l.ring.size()] = bucket;
+	l.committed.store(n + 1, std::memory_order_release);
+
+	// Cada dos cubetas de un nivel se completa una del nivel superior:
+	// el costo por muestra es 1 + 1/2 + 1/4 + ... < 2 (O(1) amortizado)
+	if (level + 1 >= level_count)
+		return;
+
+	Level& up = levels[level + 1];
+	Merge(up.partial, bucket);
+	if (++up.partial_count == 2) {
+		PyramidBucket merged = up.partial;
+		up.partial = empty_bucket;
+		up.partial_count = 0;
+		Commit(level + 1, merged);
+	}
+}
+
+bool MinMaxPyramid::Query(double first, double last, int pixels, double period,
+                          std::vector<double>& xs, std::vector<double>& ys) const {
+	if (level_count == 0 || pixels <= 0 || last <= first)
+		return false;
+
+	// Zoom cercano: menos de dos cubetas del nivel 0 por píxel
+	double per_pixel = (last - first) / pixels;
+	if (per_pixel < 2.0 * BucketSize(0))
+		return false;
+
+	// Nivel más grueso cuya cubeta no supera un píxel
+	int level = 0;
+	while (level + 1 < level_count && BucketSize(level + 1) <= per_pixel)
+		level++;
+
+	const Level& l = levels[level];
+	uint64_t size = l.ring.size();
+	uint64_t bucket_size = BucketSize(level);
+	uint64_t committed = l.committed.load(std::memory_order_acquire);
+	uint64_t oldest = committed > size - 1 ? committed - (size - 1) : 0;
+
+	uint64_t begin = std::max<uint64_t>(oldest, (uint64_t)std::max(0.0, first) / bucket_size);
+	uint64_t end = std::min<uint64_t>(committed, (uint64_t)std::ceil(last / bucket_size) + 1);
+
+	xs.clear();
+	ys.clear();
+	for (uint64_t b = begin; b < end; b++) {
+		const PyramidBucket& bucket = l.ring[b % size];
+		double x = (b * bucket_size + bucket_size / 2) * period;
+		xs.push_back(x);
+		ys.push_back(bucket.min);
+		xs.push_back(x);
+		ys.push_back(bucket.max);
+	}
+
+	// Descartar las cubetas que el productor pudo reemplazar mientras se leían
+	uint64_t now = l.committed.load(std::memory_order_acquire);
+	uint64_t now_oldest = now > size - 1 ? now - (size - 1) : 0;
+	if (now_oldest > begin) {
+		size_t drop = std::min<size_t>(xs.size(), 2 * (now_oldest - begin));
+		xs.erase(xs.begin(), xs.begin() + drop);
+		ys.erase(ys.begin(), ys.begin() + drop);
+	}
+	return true;
+}
@@ -0,0 +1,65 @@
+// Pyramid.h - Pirámide min/max de nivel de detalle (LOD) para graficar señales largas
+//
+// El stride de ImPlot saltea muestras: oculta picos y produce aliasing visual.
+// MinMaxPyramid guarda, para cada nivel, el mínimo, el máximo y la suma de cubetas
+// de 2^(base_shift + nivel) muestras. Al graficar se elige el nivel cuya cubeta
+// ocupa aproximadamente un píxel y se dibujan dos puntos (mínimo y máximo) por
+// cubeta: cualquier zoom se dibuja en O(píxeles) sin perder picos.
+//
+// Características:
+// - Construcción incremental durante la adquisición: O(1) amortizado por muestra
+// - Cada nivel es un buffer circular que cubre 'history' muestras
+// - El lector (UI) usa solo cubetas completas, publicadas con un contador atómico
+//
+// Thread-safety:
+// - Un único productor (SerialWorker) llama a Push()
+// - Lectores concurrentes llaman a Query() sin bloquear al productor
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Resumen de una cubeta de muestras
+struct PyramidBucket {
+	float min, max;  // Extremos de la cubeta (float alcanza para un ADC de 8 bits)
+	double sum;      // Suma de las muestras (para promedios)
+};
+
+class MinMaxPyramid {
+public:
+	static constexpr int base_shift = 3;   // Nivel 0: cubetas de 8 muestras
+	static constexpr int max_levels = 24;
+
+	// Reserva los niveles necesarios para conservar 'history' muestras
+	// Solo debe llamarse cuando no hay productor ni lectores activos
+	void Reset(uint32_t history);
+
+	// Agrega una muestra (productor)
+	void Push(double value);
+
+	// Genera la polilínea min/max del rango de muestras [first, last) para 'pixels' píxeles
+	// period: tiempo entre muestras (la muestra i se ubica en i * period)
+	// Retorna false si hay menos de dos cubetas del nivel 0 por píxel: en ese caso
+	// conviene dibujar directamente las muestras crudas
+	bool Query(double first, double last, int pixels, double period,
+	           std::vector<double>& xs, std::vector<double>& ys) const;
+
+	// Cantidad de muestras que resume una cubeta del nivel indicado
+	static uint64_t BucketSize(int level) { return uint64_t(1) << (base_shift + level); }
+
+private:
+	struct Level {
+		std::vector<PyramidBucket> ring;     // Cubetas completas (buffer circular)
+		PyramidBucket partial;               // Cubeta en construcción
+		uint32_t partial_count = 0;          // Cubetas (o muestras en el nivel 0) acumuladas
+		std::atomic_uint64_t committed = 0;  // Cantidad total de cubetas completas publicadas
+	};
+
+	void Commit(int level, const PyramidBucket& bucket);
+
+	std::array<Level, max_levels> levels;
+	int level_count = 0;
+};
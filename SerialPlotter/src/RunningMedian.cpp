@@ -0,0 +1,114 @@
+// RunningMedian.cpp - Histograma con árbol de Fenwick, mediana y prueba de Hampel
+
+#include "RunningMedian.h"
+
+#include <algorithm>
+#include <cmath>
+
+void RunningMedian::Configure(int new_window, bool new_hampel, double new_threshold) {
+    new_window = new_window < 1 ? 1 : new_window > max_window ? max_window : new_window;
+    new_window |= 1;
+    hampel = new_hampel;
+    threshold = new_threshold < 0.5 ? 0.5 : new_threshold;
+    if (new_window == window)
+        return;
+
+    window = new_window;
+    half = window / 2;
+    values.assign(window, 0);
+    value_bins.assign(window, 0);
+    tree.assign(bins + 1, 0);
+    bin_value.assign(bins, 0);
+    Reset();
+}
+
+void RunningMedian::Reset() {
+    std::fill(tree.begin(), tree.end(), 0);
+    position = 0;
+    primed = false;
+    replaced = 0;
+}
+
+int RunningMedian::Bin(double value) const {
+    double scaled = (value + range) * (bins / (2 * range));
+    scaled = scaled > 0 ? scaled : 0;  // También NaN
+    return scaled < bins - 1 ? (int)scaled : bins - 1;
+}
+
+void RunningMedian::Add(int bin, int delta) {
+    for (int i = bin + 1; i <= bins; i += i & -i)
+        tree[i] += delta;
+}
+
+int RunningMedian::Prefix(int bin) const {
+    int sum = 0;
+    for (int i = bin + 1; i > 0; i -= i & -i)
+        sum += tree[i];
+    return sum;
+}
+
+int RunningMedian::Select(int rank) const {
+    // Descenso binario: mayor posición con menos de 'rank' muestras acumuladas
+    int position = 0;
+    for (int step = bins; step > 0; step >>= 1) {
+        if (position + step <= bins && tree[position + step] < rank) {
+            position += step;
+            rank -= tree[position];
+        }
+    }
+    return position;  // Índice 1..bins del siguiente = bin 0..bins-1
+}
+
+void RunningMedian::Process(double* data, uint32_t count) {
+    if (window == 0 || count == 0)
+        return;
+
+    // Primera muestra: la ventana se llena con ella (sin transitorio desde cero)
+    if (!primed) {
+        int bin = Bin(data[0]);
+        std::fill(values.begin(), values.end(), data[0]);
+        std::fill(value_bins.begin(), value_bins.end(), (uint16_t)bin);
+        bin_value[bin] = data[0];
+        Add(bin, window);
+        primed = true;
+    }
+
+    const double width = 2 * range / bins;
+    for (uint32_t n = 0; n < count; n++) {
+        double x = data[n];
+        int bin = Bin(x);
+
+        // Reemplazar la muestra más antigua por la nueva
+        Add(value_bins[position], -1);
+        Add(bin, 1);
+        bin_value[bin] = x;
+        values[position] = x;
+        value_bins[position] = (uint16_t)bin;
+        if (++position == (uint32_t)window)
+            position = 0;
+
+        int median_bin = Select(half + 1);
+        double median = bin_value[median_bin];
+        if (!hampel) {
+            data[n] = median;
+            continue;
+        }
+
+        // Muestra central de la ventana (h muestras atrás)
+        uint32_t center = position + half < (uint32_t)window ? position + half : position + half - window;
+        double candidate = values[center];
+        double distance = std::fabs(candidate - median) / (threshold * 1.4826);
+
+        // MAD < distance: al menos h + 1 muestras a menos de 'distance' (en bins) de la mediana
+        int reach = (int)std::ceil(distance / width) - 1;
+        bool outlier = false;
+        if (reach >= 0) {
+            int low = median_bin - reach, high = median_bin + reach;
+            int inside = Prefix(high < bins - 1 ? high : bins - 1) - (low > 0 ? Prefix(low - 1) : 0);
+            outlier = inside >= half + 1;
+        }
+        if (outlier)
+            replaced++;
+        data[n] = outlier ? median : candidate;
+    }
+}
@@ -0,0 +1,58 @@
+// RunningMedian.h - Mediana móvil y rechazo de picos (Hampel) con histograma indexado
+//
+// La ventana (impar, 2h + 1 muestras) se guarda como histograma de bins fijos sobre ±16 V
+// con un árbol de Fenwick encima: agregar o quitar una muestra y buscar la k-ésima son
+// O(log bins) (14 pasos) sin importar el largo de la ventana.
+//
+// Modos:
+// - Mediana: la salida es la mediana de la ventana
+// - Hampel: la muestra central se reemplaza por la mediana si se aleja más de
+//   threshold * 1.4826 * MAD (desvío absoluto mediano); si no, pasa sin cambios.
+//   No hace falta calcular el MAD: |x - m| > t MAD equivale a que al menos h + 1
+//   muestras estén a menos de |x - m| / t de la mediana, una consulta de rango en el árbol
+//
+// Resolución: 32 V / bins ≈ 2 mV (los códigos del ADC están a ~47 mV, cada uno cae en un
+// bin propio). La mediana devuelve el último valor que cayó en su bin, así con códigos
+// del ADC a la entrada la salida es exactamente uno de ellos.
+//
+// Retardo: h muestras en ambos modos
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class RunningMedian {
+public:
+	static constexpr int bins = 1 << 14;
+	static constexpr double range = 16;     // Volts a cada lado de cero
+	static constexpr int max_window = 8191;
+
+	// window se redondea a impar; conserva el estado si la ventana no cambia
+	void Configure(int window, bool hampel, double threshold);
+	void Reset();
+
+	// Filtra 'count' muestras en el lugar
+	void Process(double* data, uint32_t count);
+
+	int Window() const { return window; }
+	uint64_t Replaced() const { return replaced; }  // Muestras reemplazadas por Hampel desde Reset()
+
+private:
+	int Bin(double value) const;
+	void Add(int bin, int delta);
+	int Prefix(int bin) const;       // Muestras en los bins 0..bin
+	int Select(int rank) const;      // Bin de la muestra número 'rank' (desde 1) en orden
+
+	int window = 0, half = 0;
+	bool hampel = false;
+	double threshold = 3;
+
+	std::vector<int32_t> tree;       // Fenwick (índices 1..bins)
+	std::vector<double> bin_value;   // Último valor que cayó en cada bin
+	std::vector<double> values;      // Ventana circular de entradas
+	std::vector<uint16_t> value_bins;
+	uint32_t position = 0;
+	bool primed = false;
+	uint64_t replaced = 0;
+};
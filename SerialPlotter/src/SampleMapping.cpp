@@ -0,0 +1,60 @@
+// SampleMapping.cpp - Tabla de entrada y cuantizador de salida (escalar y AVX2)
+
+#include "SampleMapping.h"
+
+#include "Simd.h"
+
+SampleMapping::SampleMapping(int minimum, int maximum) : minimum(minimum), maximum(maximum) {
+    // Misma expresión que la conversión muestra a muestra (12 V repartidos entre los códigos)
+    double factor = 12.0 / (maximum - minimum);
+    for (int code = 0; code < 256; code++)
+        table[code] = (code - minimum) * factor - 6;
+    scale = (maximum - minimum) / 12.0;
+}
+
+void SampleMapping::ToVoltage(const uint8_t* codes, uint32_t count, double* out) const {
+    for (uint32_t i = 0; i < count; i++)
+        out[i] = table[codes[i]];
+}
+
+uint8_t SampleMapping::ToCode(double voltage) const {
+    // Acotar antes de redondear (un NaN queda en 0); x + 0.5 truncado = redondeo hacia arriba
+    double x = (voltage + 6) * scale + minimum;
+    x = x > 0 ? x : 0;
+    x = x < 254 ? x : 254;
+    return (uint8_t)(x + 0.5);
+}
+
+void SampleMapping::ToCode(const double* voltages, uint32_t count, uint8_t* out) const {
+    if (CpuHasAvx2())
+        ToCodeAvx2(voltages, count, out);
+    else
+        ToCodeScalar(voltages, count, out);
+}
+
+void SampleMapping::ToCodeScalar(const double* voltages, uint32_t count, uint8_t* out) const {
+    for (uint32_t i = 0; i < count; i++)
+        out[i] = ToCode(voltages[i]);
+}
+
+// Mismas operaciones que ToCode: max(x, 0) deja los NaN en 0 (devuelve el segundo operando)
+static SIMD_TARGET_AVX2 __m128i QuantizeAvx2(__m256d v, __m256d scale, __m256d minimum) {
+    __m256d x = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(v, _mm256_set1_pd(6)), scale), minimum);
+    x = _mm256_min_pd(_mm256_max_pd(x, _mm256_setzero_pd()), _mm256_set1_pd(254));
+    return _mm256_cvttpd_epi32(_mm256_add_pd(x, _mm256_set1_pd(0.5)));
+}
+
+SIMD_TARGET_AVX2 void SampleMapping::ToCodeAvx2(const double* voltages, uint32_t count, uint8_t* out) const {
+    const __m256d v_scale = _mm256_set1_pd(scale), v_minimum = _mm256_set1_pd(minimum);
+
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i low = QuantizeAvx2(_mm256_loadu_pd(voltages + i), v_scale, v_minimum);
+        __m128i high = QuantizeAvx2(_mm256_loadu_pd(voltages + i + 4), v_scale, v_minimum);
+        __m128i words = _mm_packus_epi32(low, high);                   // 8 x uint16
+        __m128i bytes = _mm_packus_epi16(words, _mm_setzero_si128());  // 8 x uint8
+        _mm_storel_epi64((__m128i*)(out + i), bytes);
+    }
+    for (; i < count; i++)
+        out[i] = ToCode(voltages[i]);
+}
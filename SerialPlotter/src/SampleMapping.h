@@ -0,0 +1,38 @@
+// SampleMapping.h - Conversión entre códigos del ADC (0-255) y voltaje (-6 V a +6 V)
+//
+// El mapeo lo definen los ajustes Mínimo (código de -6 V) y Máximo (código de +6 V).
+// Cada instancia es inmutable: al cambiar el mapeo la UI publica una nueva (ver MainWindow).
+//
+// Características:
+// - Entrada: tabla de 256 voltajes, una lectura por muestra en lugar de resta, producto y resta
+// - Salida: cuantizador por lotes (ruta AVX2 de 8 muestras por iteración y ruta escalar con
+//   el mismo redondeo, así ambas dan el mismo código)
+// - El código 255 nunca se produce: inicia los comandos al dispositivo (ver DeviceFilter.h)
+
+#pragma once
+
+#include <cstdint>
+
+class SampleMapping {
+public:
+	SampleMapping(int minimum, int maximum);
+
+	int Minimum() const { return minimum; }
+	int Maximum() const { return maximum; }
+
+	double ToVoltage(uint8_t code) const { return table[code]; }
+	void ToVoltage(const uint8_t* codes, uint32_t count, double* out) const;
+
+	// Redondeo al código más cercano (mitades hacia arriba) acotado a 0..254
+	uint8_t ToCode(double voltage) const;
+
+	// Cuantiza un lote (elige la ruta AVX2 si está disponible)
+	void ToCode(const double* voltages, uint32_t count, uint8_t* out) const;
+	void ToCodeScalar(const double* voltages, uint32_t count, uint8_t* out) const;
+	void ToCodeAvx2(const double* voltages, uint32_t count, uint8_t* out) const;
+
+private:
+	int minimum, maximum;
+	double scale;  // Códigos por volt: código = (v + 6) * scale + minimum
+	alignas(32) double table[256];
+};
@@ -0,0 +1,60 @@
+// SessionPool.cpp - Implementación del pool de buffers y FFT por sesión
+
+#include "SessionPool.h"
+
+std::unique_ptr<SessionBuffers> SessionPool::Acquire(int sampling_rate, uint32_t capacity, uint32_t view, int decimation) {
+    // Buscar desde el más reciente: es el caso típico de desconectar y volver a conectar
+    for (size_t i = free_buffers.size(); i-- > 0;) {
+        SessionBuffers& candidate = *free_buffers[i];
+        if (candidate.sampling_rate != sampling_rate || candidate.capacity != capacity || candidate.view != view || candidate.decimation != decimation)
+            continue;
+
+        auto buffers = std::move(free_buffers[i]);
+        free_buffers.erase(free_buffers.begin() + i);
+        buffers->input_blocks->clear();
+        buffers->output_blocks->clear();
+        reused++;
+        return buffers;
+    }
+
+    auto buffers = std::make_unique<SessionBuffers>();
+    buffers->sampling_rate = sampling_rate;
+    buffers->capacity = capacity;
+    buffers->view = view;
+    buffers->decimation = decimation;
+    buffers->fft = std::make_unique<FFT>(sampling_rate);
+    for (auto& candidate : buffers->candidate_fft)
+        candidate = std::make_unique<FFT>(sampling_rate < SessionBuffers::candidate_fft_size ? sampling_rate : SessionBuffers::candidate_fft_size);
+    buffers->x = std::make_unique<ScrollBuffer<double>>(capacity, view);
+    buffers->y = std::make_unique<ScrollBuffer<double>>(capacity, view);
+    buffers->filtered = std::make_unique<ScrollBuffer<double>>(capacity, view);
+    buffers->input_blocks = std::make_unique<BlockSummaries<>>(view);
+    buffers->output_blocks = std::make_unique<BlockSummaries<>>(view);
+    if (decimation > 1) {
+        buffers->decimated_fft = std::make_unique<FFT>(sampling_rate * 10 / decimation);
+        buffers->decimated_x = std::make_unique<ScrollBuffer<double>>(capacity / decimation, view / decimation);
+        buffers->decimated_y = std::make_unique<ScrollBuffer<double>>(capacity / decimation, view / decimation);
+        buffers->decimated_filtered = std::make_unique<ScrollBuffer<double>>(capacity / decimation, view / decimation);
+    }
+    created++;
+    return buffers;
+}
+
+void SessionPool::Release(std::unique_ptr<SessionBuffers> buffers) {
+    if (!buffers)
+        return;
+
+    // Los datos de la sesión terminada ya no se usan (las capturas se copiaron antes)
+    buffers->x->release_pages();
+    buffers->y->release_pages();
+    buffers->filtered->release_pages();
+    if (buffers->decimated_x) {
+        buffers->decimated_x->release_pages();
+        buffers->decimated_y->release_pages();
+        buffers->decimated_filtered->release_pages();
+    }
+
+    if (free_buffers.size() == max_cached)
+        free_buffers.erase(free_buffers.begin());
+    free_buffers.push_back(std::move(buffers));
+}
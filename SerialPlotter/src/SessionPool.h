@@ -0,0 +1,65 @@
+// SessionPool.h - Reutilización de buffers y FFT entre sesiones de adquisición
+//
+// Cada conexión necesita tres ScrollBuffer grandes y una FFT con su plan de FFTW (y, si
+// hay diezmado, tres ScrollBuffer más chicos y la FFT de baja frecuencia), más las FFT
+// de los filtros candidatos.
+// En lugar de crearlos y destruirlos en cada Start()/Stop(), SessionPool guarda los
+// juegos liberados indexados por (frecuencia de muestreo, capacidad, vista, diezmado) y los
+// entrega de nuevo en la siguiente conexión con la misma configuración: reconectar
+// no reserva memoria ni vuelve a planificar la FFT.
+//
+// Características:
+// - Se conservan como máximo max_cached juegos libres (se descarta el más antiguo)
+// - Al guardar un juego en el pool se devuelven las páginas de sus ScrollBuffer (se conservan
+//   la reserva de direcciones y los planes de FFTW): un juego libre no ocupa memoria física
+//   y no cuenta contra el presupuesto de memoria de la sesión siguiente
+// - Contadores de aciertos y creaciones para mostrar en la interfaz
+//
+// Thread-safety: solo se usa desde el hilo de UI (CreateBuffers/DestroyBuffers)
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Buffers.h"
+#include "FFT.h"
+#include "FilterLanes.h"
+
+// Juego de buffers de una sesión: tiempo, entrada, salida filtrada, resúmenes por bloque y FFT
+struct SessionBuffers {
+	int sampling_rate = 0;
+	uint32_t capacity = 0, view = 0;
+	int decimation = 1;
+
+	std::unique_ptr<FFT> fft;
+	std::unique_ptr<ScrollBuffer<double>> x, y, filtered;
+	std::unique_ptr<BlockSummaries<>> input_blocks, output_blocks;  // Resúmenes por bloque de y / filtered (RMS, auto-ajuste)
+
+	// Señales diezmadas por 'decimation' y su FFT de 10 segundos (nulos si decimation = 1)
+	std::unique_ptr<FFT> decimated_fft;
+	std::unique_ptr<ScrollBuffer<double>> decimated_x, decimated_y, decimated_filtered;
+
+	// Espectros de los filtros candidatos (hasta candidate_fft_size muestras, ver FilterLanes.h)
+	static constexpr int candidate_fft_size = 16384;
+	std::unique_ptr<FFT> candidate_fft[FilterLanes::max_lanes];
+};
+
+class SessionPool {
+public:
+	static constexpr size_t max_cached = 2;  // Juegos libres conservados (p. ej. dos frecuencias)
+
+	// Devuelve un juego vacío para la configuración pedida, reutilizando uno libre si existe
+	std::unique_ptr<SessionBuffers> Acquire(int sampling_rate, uint32_t capacity, uint32_t view, int decimation);
+
+	// Devuelve un juego al pool para la próxima sesión (libera las páginas de sus buffers)
+	void Release(std::unique_ptr<SessionBuffers> buffers);
+
+	uint64_t Reused() const { return reused; }
+	uint64_t Created() const { return created; }
+
+private:
+	std::vector<std::unique_ptr<SessionBuffers>> free_buffers;  // Del más antiguo al más reciente
+	uint64_t reused = 0, created = 0;
+};
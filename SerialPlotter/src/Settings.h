@@ -4,7 +4,7 @@
 // - Parmetros de comunicacin serial (puerto, baud rate)
 // - Frecuencia de muestreo y cantidad de muestras para FFT
 // - Mapeo de valores ADC a voltaje
-// - Opciones de rendimiento (stride para optimizacin de grficos)
+// - Opciones de rendimiento (stride para optimizacin de grficos, presupuesto de memoria)
 // - Opciones de visualizacin (FPS, etc.)
 
 #pragma once
@@ -28,6 +28,17 @@ struct Settings {
     int stride = 4;                                 // Dibuja 1 de cada N muestras (reduce puntos en grfico)
     int byte_stride = sizeof(double) * stride;      // Stride en bytes para ImPlot
 
+    // Presupuesto de memoria para los buffers de adquisicin en MB (se aplica al conectar)
+    // La capacidad en muestras se deriva de este valor y de la cantidad de canales
+    int memory_budget_mb = 64;
+
+    // Historial de larga duracin volcado a un archivo temporal (se aplica al conectar)
+    bool disk_history = true;
+
+    // Historial comprimido en RAM de los cdigos de 8 bits (se aplica al conectar)
+    // Se usa para navegar el pasado cuando el historial en disco est desactivado
+    bool compressed_history = false;
+
     // Opciones de interfaz
     bool show_frame_time = false;                   // Mostrar FPS en UI
     bool open = false;                              // Estado ventana de configuracin (DEPRECATED)
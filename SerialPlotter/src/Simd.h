@@ -0,0 +1,36 @@
+// Simd.h - Detección de AVX2 en tiempo de ejecución para los kernels vectorizados
+//
+// Los kernels AVX2 se compilan con SIMD_TARGET_AVX2 (sin cambiar las opciones de
+// compilación del resto del programa) y solo se llaman si CpuHasAvx2() es true.
+// En cualquier otro caso se usa la versión escalar.
+
+#pragma once
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SIMD_TARGET_AVX2
+#else
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+#include <immintrin.h>
+
+// true si el procesador y el sistema operativo soportan AVX2 y FMA
+inline bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+	static const bool supported = [] {
+		int info[4];
+		__cpuid(info, 1);
+		bool fma = (info[2] & (1 << 12)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		if (!fma || !osxsave || (_xgetbv(0) & 6) != 6)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}();
+	return supported;
+#else
+	static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	return supported;
+#endif
+}
@@ -0,0 +1,134 @@
+// Snapshot.cpp - Implementación de capturas congeladas con copia diferida
+
+#include "Snapshot.h"
+
+#include <algorithm>
+
+void SnapshotStore::Attach(const double* x, const double* y, const double* filtered) {
+    std::lock_guard lock(mutex);
+    base_x = x;
+    base_y = y;
+    base_filtered = filtered;
+}
+
+int SnapshotStore::Freeze(const BufferView& view) {
+    if (view.count == 0 || !base_x)
+        return 0;
+
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->start = view.start;
+    snapshot->count = view.count;
+    snapshot->x = base_x + view.start;
+    snapshot->y = base_y + view.start;
+    snapshot->filtered = base_filtered + view.start;
+    snapshot->first_time = snapshot->x[0];
+    snapshot->last_time = snapshot->x[view.count - 1];
+
+    std::lock_guard lock(mutex);
+    snapshot->id = next_id++;
+
+    // Descartar la captura más antigua si se alcanzó el límite
+    if (snapshots.size() >= max_snapshots)
+        snapshots.erase(snapshots.begin());
+
+    snapshots.push_back(std::move(snapshot));
+    UpdatePinnedRange();
+
+    // El llamador valida la ventana después (ViewPublisher::validate). Sin esta barrera la lectura
+    // de la secuencia podría adelantarse a la escritura de pinned_range (store->load con
+    // release/acquire) y el productor, del otro lado, podría no ver la captura al compactar
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return snapshots.back()->id;
+}
+
+void SnapshotStore::Release(int id) {
+    std::lock_guard lock(mutex);
+    std::erase_if(snapshots, [id](const auto& s) { return s->id == id; });
+    UpdatePinnedRange();
+}
+
+void SnapshotStore::MaterializeAll() {
+    std::lock_guard lock(mutex);
+    for (auto& snapshot : snapshots)
+        Materialize(*snapshot);
+    UpdatePinnedRange();
+}
+
+void SnapshotStore::BeforeWrite(uint32_t first, uint32_t last) {
+    // Pareja de la barrera de Freeze: ordena el begin_write previo del productor antes de leer
+    // pinned_range. Así, o la UI ve la generación nueva y reintenta, o el productor ve la captura
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Camino rápido (sin mutex): el tramo no toca ninguna captura fijada
+    uint64_t pinned = pinned_range.load(std::memory_order_acquire);
+    uint32_t pinned_first = pinned >> 32, pinned_last = (uint32_t)pinned;
+    if (first >= last || first >= pinned_last || last <= pinned_first)
+        return;
+
+    std::lock_guard lock(mutex);
+    for (auto& snapshot : snapshots) {
+        if (!snapshot->materialized && first < snapshot->start + snapshot->count && snapshot->start < last)
+            Materialize(*snapshot);
+    }
+    UpdatePinnedRange();
+}
+
+bool SnapshotStore::Read(int id, SnapshotRef& active, std::vector<SnapshotRef>& compared) {
+    compared.clear();
+    std::lock_guard lock(mutex);
+    const Snapshot* found = Find(id);
+    if (!found)
+        return false;
+
+    // Los punteros a las copias propias siguen válidos sin el mutex: solo la UI descarta capturas.
+    // Los que apuntan al almacenamiento vivo, hasta que el productor avance read_margin segundos
+    auto ref = [](const Snapshot& snapshot) {
+        return SnapshotRef{ snapshot.id, snapshot.count, snapshot.first_time, snapshot.last_time,
+                            snapshot.x, snapshot.y, snapshot.filtered };
+    };
+    active = ref(*found);
+    for (auto& snapshot : snapshots) {
+        if (snapshot->compare && snapshot.get() != found)
+            compared.push_back(ref(*snapshot));
+    }
+    return true;
+}
+
+std::unique_lock<std::mutex> SnapshotStore::Lock() {
+    return std::unique_lock(mutex);
+}
+
+Snapshot* SnapshotStore::Find(int id) {
+    for (auto& snapshot : snapshots) {
+        if (snapshot->id == id)
+            return snapshot.get();
+    }
+    return nullptr;
+}
+
+void SnapshotStore::Materialize(Snapshot& snapshot) {
+    if (snapshot.materialized)
+        return;
+
+    // Copia contigua del rango fijado (sin el % capacity de ScrollBuffer::operator[])
+    snapshot.owned_x.assign(snapshot.x, snapshot.x + snapshot.count);
+    snapshot.owned_y.assign(snapshot.y, snapshot.y + snapshot.count);
+    snapshot.owned_filtered.assign(snapshot.filtered, snapshot.filtered + snapshot.count);
+
+    snapshot.x = snapshot.owned_x.data();
+    snapshot.y = snapshot.owned_y.data();
+    snapshot.filtered = snapshot.owned_filtered.data();
+    snapshot.materialized = true;
+}
+
+void SnapshotStore::UpdatePinnedRange() {
+    uint32_t first = UINT32_MAX, last = 0;
+    for (auto& snapshot : snapshots) {
+        if (snapshot->materialized)
+            continue;
+        first = std::min(first, snapshot->start);
+        last = std::max(last, snapshot->start + snapshot->count);
+    }
+
+    pinned_range.store(last > first ? (uint64_t)first << 32 | last : 0, std::memory_order_release);
+}
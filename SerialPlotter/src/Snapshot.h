@@ -0,0 +1,108 @@
+// Snapshot.h - Capturas congeladas con copia diferida (copy-on-write)
+//
+// Congelar ya no copia las muestras: una captura solo fija (pin) el rango
+// [start, start + count) del almacenamiento de scrollX, scrollY y filter_scrollY.
+// Mientras SerialWorker no escriba sobre ese rango, la captura lee directamente
+// del almacenamiento vivo. Antes de cada lote el productor avisa qué tramos va a
+// escribir (BeforeWrite) y solo entonces se copian las capturas afectadas.
+//
+// Características:
+// - Congelar es O(1): no depende de la cantidad de muestras visibles
+// - Varias capturas simultáneas para comparar (hasta max_snapshots)
+// - El chequeo del productor es lock-free salvo cuando realmente hay que copiar
+//
+// Thread-safety:
+// - La UI copia los punteros de las capturas con el mutex tomado (Read) y grafica sin él
+// - SerialWorker solo toma el mutex cuando un lote se acerca a un rango fijado: avisa los
+//   tramos del lote más read_margin segundos, así una captura que la UI lee del almacenamiento
+//   vivo se copia al menos read_margin antes de sobrescribirse (un frame dura mucho menos)
+// - Congelar y compactar se ordenan con barreras seq_cst a ambos lados (ver Snapshot.cpp)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Buffers.h"
+
+// Captura congelada de las tres señales (tiempo, entrada y filtrada)
+struct Snapshot {
+	int id = 0;
+	uint32_t start = 0, count = 0;         // Rango fijado dentro del almacenamiento de los ScrollBuffer
+	double first_time = 0, last_time = 0;  // Tiempo de la primera y última muestra (segundos)
+
+	// Datos de la captura: apuntan al almacenamiento vivo o a las copias propias
+	const double* x = nullptr;
+	const double* y = nullptr;
+	const double* filtered = nullptr;
+
+	bool materialized = false;  // true si ya se copió porque el productor iba a sobrescribirla
+	bool compare = false;       // Superponer en los gráficos al ver otra captura
+
+	// Copias propias (vacías mientras la captura sigue fijada)
+	std::vector<double> owned_x, owned_y, owned_filtered;
+};
+
+// Campos de una captura copiados para graficarla sin el mutex (los datos no se copian)
+// Válidos hasta que la UI descarte la captura (Release o Freeze al superar el límite)
+struct SnapshotRef {
+	int id = 0;
+	uint32_t count = 0;
+	double first_time = 0, last_time = 0;
+	const double* x = nullptr;
+	const double* y = nullptr;
+	const double* filtered = nullptr;
+};
+
+class SnapshotStore {
+public:
+	static constexpr int max_snapshots = 4;  // Al superar el límite se descarta la más antigua
+	static constexpr double read_margin = 0.5;  // Segundos de anticipación con que se copian las capturas
+
+	// Asocia el almacenamiento de los buffers vivos (llamar al crear los buffers)
+	void Attach(const double* x, const double* y, const double* filtered);
+
+	// Fija la ventana publicada como nueva captura - O(1)
+	// Retorna el id de la captura (0 si la ventana está vacía)
+	int Freeze(const BufferView& view);
+
+	// Descarta una captura
+	void Release(int id);
+
+	// Copia todas las capturas fijadas (antes de liberar o recrear los buffers vivos)
+	void MaterializeAll();
+
+	// Productor: avisa que se va a escribir el tramo [first, last) del almacenamiento
+	// (incluyendo read_margin segundos por delante del lote)
+	// Copia las capturas que se superponen con ese tramo antes de que se sobrescriban
+	void BeforeWrite(uint32_t first, uint32_t last);
+
+	// UI: copia los campos de la captura 'id' y de las marcadas para comparar (sin 'id')
+	// Retorna false si la captura ya no existe. Toma el mutex solo durante la copia
+	bool Read(int id, SnapshotRef& active, std::vector<SnapshotRef>& compared);
+
+	// UI: bloquea las capturas mientras se leen sus datos
+	std::unique_lock<std::mutex> Lock();
+
+	// Acceso a las capturas (solo con Lock() tomado)
+	Snapshot* Find(int id);
+	const std::vector<std::unique_ptr<Snapshot>>& List() const { return snapshots; }
+
+private:
+	void Materialize(Snapshot& snapshot);
+	void UpdatePinnedRange();
+
+	std::mutex mutex;
+	std::vector<std::unique_ptr<Snapshot>> snapshots;
+	int next_id = 1;
+
+	const double* base_x = nullptr;
+	const double* base_y = nullptr;
+	const double* base_filtered = nullptr;
+
+	// Rango que cubre todas las capturas fijadas: (first << 32) | last (0 si no hay ninguna)
+	std::atomic_uint64_t pinned_range = 0;
+};
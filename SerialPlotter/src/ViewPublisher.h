@@ -0,0 +1,76 @@
+// ViewPublisher.h - Publicación de la ventana visible de los ScrollBuffer (seqlock)
+//
+// Separado de Buffers.h para poder probarlo sin ImPlot ni Windows (ver tests/)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// BufferView - Ventana inmutable publicada por el productor
+struct BufferView {
+	uint32_t start = 0;       // Posición del primer elemento en el almacenamiento interno
+	uint32_t count = 0;       // Cantidad de elementos visibles
+	uint64_t generation = 0;  // Generación: cambia cada vez que el productor compacta los datos
+};
+
+// ViewPublisher - Publicación tipo seqlock de la ventana visible de uno o más ScrollBuffer
+//
+// Agregar datos con push() nunca modifica elementos ya publicados, así que el productor
+// solo publica la nueva ventana al final de cada lote. La compactación sí mueve datos:
+// el productor la encierra entre begin_write() y publish(), lo que cambia la generación.
+//
+// Lectores: acquire() -> usar storage() + start -> validate(). Si validate() devuelve
+// false, hubo una compactación mientras se leía y los datos deben descartarse.
+// Una ventana publicada k elementos antes de una compactación sigue intacta mientras se
+// escriban menos de (capacity - 2 * view) - k elementos nuevos desde la compactación:
+// un lector que no valida necesita capacity >= 2 * (view + elementos escritos mientras lee).
+class ViewPublisher {
+public:
+	// Productor: marca el inicio de una modificación que mueve datos publicados
+	void begin_write() {
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	// Productor: publica la ventana actual y cierra la modificación abierta (si la hay)
+	void publish(uint32_t start, uint32_t count) {
+		window.store((uint64_t)start << 32 | count, std::memory_order_release);
+		uint64_t seq = sequence.load(std::memory_order_relaxed);
+		if (seq & 1)
+			sequence.store(seq + 1, std::memory_order_release);
+	}
+
+	// Lector: obtiene una ventana consistente (solo reintenta durante una compactación)
+	BufferView acquire() const {
+		while (true) {
+			uint64_t seq = sequence.load(std::memory_order_acquire);
+			if (seq & 1) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			uint64_t w = window.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence.load(std::memory_order_relaxed) == seq)
+				return { (uint32_t)(w >> 32), (uint32_t)w, seq >> 1 };
+		}
+	}
+
+	// Lector: indica si los datos leídos desde 'view' siguen siendo válidos
+	bool validate(const BufferView& view) const {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return sequence.load(std::memory_order_relaxed) == view.generation << 1;
+	}
+
+	// Reinicia la publicación (solo cuando no hay lectores ni productor activos)
+	void reset() {
+		sequence.store(0, std::memory_order_relaxed);
+		window.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic_uint64_t sequence = 0;  // Impar mientras el productor mueve datos publicados
+	std::atomic_uint64_t window = 0;    // (start << 32) | count
+};
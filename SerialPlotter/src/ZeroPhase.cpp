@@ -0,0 +1,157 @@
+// ZeroPhase.cpp - Ida y vuelta por tramos con márgenes de calentamiento
+
+#include "ZeroPhase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+uint32_t ZeroPhaseFilter::Warmup(const FilterDesign& design) {
+    constexpr uint32_t block = 4096;
+    constexpr uint32_t max_warmup = 1 << 22;
+
+    BiquadCascade cascade;
+    cascade.SetCoefficients(design.coefficients, design.sections);
+
+    // Respuesta al impulso por bloques hasta que un bloque completo quede bajo el umbral
+    std::vector<double> response(block, 0.0);
+    response[0] = 1;
+    double peak = 0;
+    uint32_t length = 0;
+    while (length < max_warmup) {
+        cascade.Process(response.data(), block);
+        double block_peak = 0;
+        for (double v : response)
+            block_peak = std::max(block_peak, std::fabs(v));
+        peak = std::max(peak, block_peak);
+        length += block;
+        if (block_peak <= 1e-9 * peak)
+            break;
+        std::fill(response.begin(), response.end(), 0.0);
+    }
+    return length;
+}
+
+// Muestra i de la señal con extensión impar en ambos bordes
+static double Extended(const double* in, uint32_t count, int64_t i) {
+    if (i < 0)
+        return 2 * in[0] - in[std::min<int64_t>(-i, count - 1)];
+    if (i >= count)
+        return 2 * in[count - 1] - in[std::max<int64_t>(2 * (int64_t)(count - 1) - i, 0)];
+    return in[i];
+}
+
+// Filtra [first, last) con margen a cada lado y escribe solo el tramo propio
+static void FilterSegment(const double* in, double* out, uint32_t count, uint32_t first, uint32_t last,
+                          uint32_t warmup, const FilterDesign& design) {
+    int64_t begin = (int64_t)first - warmup;
+    int64_t end = (int64_t)last + warmup;
+    std::vector<double> buffer(end - begin);
+    for (int64_t i = begin; i < end; i++)
+        buffer[i - begin] = Extended(in, count, i);
+
+    BiquadCascade cascade;
+    cascade.SetCoefficients(design.coefficients, design.sections);
+    cascade.Prime(buffer.front());
+    cascade.Process(buffer.data(), (uint32_t)buffer.size());
+
+    std::reverse(buffer.begin(), buffer.end());
+    cascade.Reset();
+    cascade.Prime(buffer.front());
+    cascade.Process(buffer.data(), (uint32_t)buffer.size());
+    std::reverse(buffer.begin(), buffer.end());
+
+    std::copy(buffer.begin() + (first - begin), buffer.begin() + (last - begin), out + first);
+}
+
+int ZeroPhaseFilter::Filter(const double* in, double* out, uint32_t count, const FilterDesign& design, int threads, uint32_t warmup) {
+    if (count == 0)
+        return 0;
+
+    // Tramos de al menos 4 márgenes: el trabajo extra queda por debajo del 50%
+    uint32_t segments = std::clamp<uint32_t>(count / (4 * warmup), 1, threads < 1 ? 1 : threads);
+    uint32_t length = (count + segments - 1) / segments;
+
+    std::vector<std::thread> workers;
+    for (uint32_t s = 1; s < segments; s++) {
+        uint32_t first = s * length;
+        uint32_t last = std::min(count, first + length);
+        workers.emplace_back(FilterSegment, in, out, count, first, last, warmup, std::cref(design));
+    }
+    FilterSegment(in, out, count, 0, std::min(count, length), warmup, design);
+    for (std::thread& worker : workers)
+        worker.join();
+    return (int)segments;
+}
+
+ZeroPhaseFilter::ZeroPhaseFilter() {
+    thread = std::thread(&ZeroPhaseFilter::Worker, this);
+}
+
+ZeroPhaseFilter::~ZeroPhaseFilter() {
+    {
+        std::lock_guard lock(mutex);
+        running = false;
+    }
+    cv.notify_one();
+    thread.join();
+}
+
+void ZeroPhaseFilter::Request(SnapshotStore& store, int snapshot_id, std::shared_ptr<const FilterDesign> design) {
+    {
+        std::lock_guard lock(mutex);
+        if (snapshot_id == requested_id && design == requested_design)
+            return;
+        requested_id = snapshot_id;
+        requested_design = design;
+
+        pending = true;
+        pending_store = &store;
+        pending_id = snapshot_id;
+        pending_design = std::move(design);
+    }
+    cv.notify_one();
+}
+
+void ZeroPhaseFilter::Worker() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return pending || !running; });
+        if (!running)
+            return;
+
+        SnapshotStore* store = pending_store;
+        int id = pending_id;
+        std::shared_ptr<const FilterDesign> design = std::move(pending_design);
+        pending = false;
+
+        // El filtrado se hace sin el mutex: la UI puede seguir pidiendo mientras tanto
+        lock.unlock();
+        auto begin = std::chrono::steady_clock::now();
+
+        // Copia de la entrada (una vez por captura): los datos pueden estar en el
+        // almacenamiento vivo, que SerialWorker sobrescribe tras materializar la captura
+        if (id != input_id) {
+            auto snapshot_lock = store->Lock();
+            const Snapshot* snapshot = store->Find(id);
+            if (snapshot)
+                input.assign(snapshot->y, snapshot->y + snapshot->count);
+            else
+                input.clear();
+            input_id = id;
+        }
+
+        if (!input.empty() && design && design->sections > 0) {
+            auto result = std::make_shared<Result>();
+            result->snapshot_id = id;
+            result->design = design;
+            result->output.resize(input.size());
+            result->warmup = Warmup(*design);
+            result->segments = Filter(input.data(), result->output.data(), (uint32_t)input.size(), *design,
+                                      (int)std::max(1u, std::thread::hardware_concurrency()), result->warmup);
+            result->elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            current.store(std::move(result), std::memory_order_release);
+        }
+        lock.lock();
+    }
+}
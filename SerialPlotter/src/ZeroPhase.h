@@ -0,0 +1,79 @@
+// ZeroPhase.h - Filtrado de fase cero (ida y vuelta) de capturas congeladas, en paralelo
+//
+// Aplica la cascada del diseño activo hacia adelante y hacia atrás sobre la entrada de
+// una captura: la fase se cancela (sin retardo de grupo) y la magnitud queda al cuadrado.
+//
+// Paralelismo: la captura se divide en tramos, uno por hilo. Cada tramo se filtra con un
+// margen de calentamiento a cada lado (warmup muestras, lo que tarda la respuesta al
+// impulso de la cascada en caer por debajo de 1e-9 de su pico): el transitorio del estado
+// inicial se disipa dentro del margen y los tramos se empalman sin costuras visibles.
+//
+// Bordes: extensión impar (2 x[0] - x[k]) como filtfilt, con el estado de régimen de la
+// primera muestra extendida (BiquadCascade::Prime) en cada pasada.
+//
+// Thread-safety: la UI llama a Request y Current; el filtrado corre en un hilo propio
+// (que a su vez reparte los tramos en hilos de trabajo) y publica el resultado completo
+// con un std::atomic<std::shared_ptr>, como FilterDesigner
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "FilterDesign.h"
+#include "Snapshot.h"
+
+class ZeroPhaseFilter {
+public:
+	struct Result {
+		int snapshot_id = 0;
+		std::shared_ptr<const FilterDesign> design;
+		std::vector<double> output;  // Misma cantidad de muestras que la captura
+		uint32_t warmup = 0;         // Margen de calentamiento por tramo
+		int segments = 0;            // Tramos procesados en paralelo
+		double elapsed_ms = 0;
+	};
+
+	ZeroPhaseFilter();
+	~ZeroPhaseFilter();
+
+	// Pide filtrar la entrada de una captura con un diseño IIR (si hay un pedido pendiente se
+	// reemplaza; repetir el último pedido no hace nada). La entrada se copia una vez por captura
+	void Request(SnapshotStore& store, int snapshot_id, std::shared_ptr<const FilterDesign> design);
+
+	// Último resultado publicado (nullptr si todavía no hay ninguno)
+	std::shared_ptr<const Result> Current() const {
+		return current.load(std::memory_order_acquire);
+	}
+
+	// Ida y vuelta de 'count' muestras con hasta 'threads' hilos y el margen dado (ver Warmup);
+	// retorna la cantidad de tramos usados
+	static int Filter(const double* in, double* out, uint32_t count, const FilterDesign& design, int threads, uint32_t warmup);
+
+	// Muestras hasta que la respuesta al impulso cae por debajo de 1e-9 de su pico
+	static uint32_t Warmup(const FilterDesign& design);
+
+private:
+	void Worker();
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool running = true;
+	bool pending = false;
+	SnapshotStore* pending_store = nullptr;
+	int pending_id = 0;
+	std::shared_ptr<const FilterDesign> pending_design;
+
+	// Último pedido (para ignorar repeticiones) y copia de la entrada (solo el hilo propio)
+	int requested_id = 0;
+	std::shared_ptr<const FilterDesign> requested_design;
+	int input_id = 0;
+	std::vector<double> input;
+
+	std::atomic<std::shared_ptr<const Result>> current;
+};
@@ -0,0 +1,72 @@
+// history_bench.cpp - Medición del historial en disco (HistoryStore), sin la interfaz
+//
+// 1. Volcado sostenido: un productor agrega muestras tan rápido como el volcado las acepta
+//    (se frena si se adelanta más de hot_chunks - 2 bloques) y se mide la velocidad
+// 2. Lectura aleatoria: rangos de read_samples muestras en posiciones al azar del archivo,
+//    con la mediana, el percentil 99 y el máximo de la latencia
+//
+// Uso: history_bench [bloques] (por defecto 256 bloques = 128 MB de archivo)
+
+#include "History.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+static constexpr uint32_t read_samples = 4096;  // Muestras por lectura (una ventana de análisis típica)
+static constexpr int reads = 2000;
+
+int main(int argc, char** argv) {
+    uint64_t chunks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    uint64_t samples = chunks * HistoryStore::chunk_samples;
+
+    HistoryStore history;
+    if (!history.Open()) {
+        std::printf("No se pudo crear el archivo temporal\n");
+        return 1;
+    }
+
+    // Volcado sostenido
+    auto start = bench_clock::now();
+    for (uint64_t n = 0; n < samples; n++) {
+        if (n % HistoryStore::chunk_samples == 0) {
+            while (n / HistoryStore::chunk_samples >= history.Stats().spilled_chunks + HistoryStore::hot_chunks - 2)
+                std::this_thread::yield();
+        }
+        history.Append(std::sin(n * 1e-3), std::cos(n * 1e-3));
+    }
+    while (history.Stats().spilled_chunks < chunks)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    double seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+    HistoryStats stats = history.Stats();
+    double megabytes = chunks * 2.0 * HistoryStore::chunk_samples * sizeof(float) / 1e6;
+    std::printf("Volcado: %llu bloques (%.0f MB) en %.2f s\n", (unsigned long long)chunks, megabytes, seconds);
+    std::printf("  velocidad del volcado: %.0f MB/s (solo copia), %.0f MB/s (de punta a punta)\n",
+                stats.spill_mb_per_s, megabytes / seconds);
+    std::printf("  bloques perdidos: %llu\n", (unsigned long long)stats.lost_chunks);
+
+    // Lectura aleatoria de rangos fríos
+    std::mt19937_64 random(1234);
+    std::uniform_int_distribution<uint64_t> position(0, samples - read_samples);
+    std::vector<double> in(read_samples), out(read_samples);
+    std::vector<double> latency(reads);
+    for (int i = 0; i < reads; i++) {
+        auto begin = bench_clock::now();
+        history.Read(position(random), read_samples, in.data(), out.data());
+        latency[i] = std::chrono::duration<double, std::micro>(bench_clock::now() - begin).count();
+    }
+    std::sort(latency.begin(), latency.end());
+    std::printf("Lectura aleatoria (%u muestras, %d lecturas): mediana %.1f us, p99 %.1f us, max %.1f us\n",
+                read_samples, reads, latency[reads / 2], latency[reads * 99 / 100], latency.back());
+
+    history.Close();
+    return stats.lost_chunks == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+// memory_bench.cpp - Medición del inicio de sesión y la memoria residente de los buffers
+//
+// Compara, para una sesión corta, reservar con ReservedMemory y comprometer a medida que llegan
+// los lotes (como ScrollBuffer) contra asignar y tocar toda la capacidad al inicio (como antes
+// del presupuesto de memoria). Para cada variante mide la duración del "Start" (crear los tres
+// buffers y preparar el primer lote) y la memoria residente y comprometida del proceso al
+// terminar la sesión.
+//
+// Uso: memory_bench [frecuencia_hz] [presupuesto_mb] [segundos] (por defecto 100000 512 5)
+
+#include "Memory.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using bench_clock = std::chrono::steady_clock;
+
+static constexpr int channels = 3;       // Tiempo, entrada y salida (double)
+static constexpr uint32_t batch = 128;   // Muestras por lote de SerialWorker
+
+struct Result {
+    double start_ms = 0;
+    double resident_mb = 0, committed_mb = 0;
+};
+
+static double Megabytes(size_t after, size_t before) {
+    return after > before ? (after - before) / 1048576.0 : 0;
+}
+
+// Reserva completa y compromiso diferido lote a lote
+static Result Lazy(size_t capacity, uint64_t samples) {
+    size_t resident = ReservedMemory::ResidentBytes(), committed = ReservedMemory::CommittedBytes();
+    Result result;
+
+    auto start = bench_clock::now();
+    ReservedMemory memory[channels];
+    for (auto& channel : memory) {
+        if (!channel.Reserve(capacity * sizeof(double)) || !channel.Commit(batch * sizeof(double))) {
+            std::printf("  sin memoria al iniciar\n");
+            return result;
+        }
+    }
+    result.start_ms = std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+
+    for (uint64_t n = 0; n < samples && n + batch <= capacity; n += batch) {
+        for (auto& channel : memory) {
+            if (!channel.Commit((n + batch) * sizeof(double))) {
+                std::printf("  sin memoria en la muestra %llu\n", (unsigned long long)n);
+                return result;
+            }
+            double* data = (double*)channel.data();
+            for (uint32_t i = 0; i < batch; i++)
+                data[n + i] = (double)(n + i);
+        }
+    }
+
+    result.resident_mb = Megabytes(ReservedMemory::ResidentBytes(), resident);
+    result.committed_mb = Megabytes(ReservedMemory::CommittedBytes(), committed);
+    return result;
+}
+
+// Asignación completa al inicio (cada página se toca al inicializar en cero)
+static Result Eager(size_t capacity, uint64_t samples) {
+    size_t resident = ReservedMemory::ResidentBytes(), committed = ReservedMemory::CommittedBytes();
+    Result result;
+
+    auto start = bench_clock::now();
+    std::vector<double> memory[channels];
+    for (auto& channel : memory)
+        channel.assign(capacity, 0.0);
+    result.start_ms = std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+
+    for (uint64_t n = 0; n < samples && n < capacity; n++) {
+        for (auto& channel : memory)
+            channel[n] = (double)n;
+    }
+
+    result.resident_mb = Megabytes(ReservedMemory::ResidentBytes(), resident);
+    result.committed_mb = Megabytes(ReservedMemory::CommittedBytes(), committed);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int rate = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int budget_mb = argc > 2 ? std::atoi(argv[2]) : 512;
+    double seconds = argc > 3 ? std::atof(argv[3]) : 5;
+
+    size_t capacity = (size_t)budget_mb * 1048576 / (channels * sizeof(double));
+    uint64_t samples = (uint64_t)(rate * seconds);
+    std::printf("%d Hz, presupuesto %d MB (%.0f s de capacidad), sesion de %.0f s\n",
+                rate, budget_mb, (double)capacity / rate, seconds);
+
+    Result lazy = Lazy(capacity, samples);
+    std::printf("Diferido: inicio %.2f ms, residente %.1f MB, comprometida %.1f MB\n",
+                lazy.start_ms, lazy.resident_mb, lazy.committed_mb);
+
+    Result eager = Eager(capacity, samples);
+    std::printf("Completo: inicio %.2f ms, residente %.1f MB, comprometida %.1f MB\n",
+                eager.start_ms, eager.resident_mb, eager.committed_mb);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// session_soak.cpp - Prueba de resistencia de SessionPool: 1000 ciclos de Start/Stop
+//
+// Cada ciclo hace lo mismo que CreateBuffers/DestroyBuffers: toma un juego del pool, agrega
+// unos segundos de muestras (compromete páginas), calcula la FFT y lo devuelve. Los ciclos
+// alternan dos frecuencias de muestreo, así los dos juegos en caché se reutilizan.
+// Después del primer par de ciclos la memoria comprometida del proceso debe quedar plana y
+// no debe crearse ningún juego nuevo.
+//
+// Uso: session_soak [ciclos] (por defecto 1000)
+
+#include "SessionPool.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Configuración de una sesión (valores de CreateBuffers con el presupuesto por defecto de 64 MB)
+struct SessionConfig {
+    int sampling_rate;
+    int decimation;
+};
+
+static constexpr SessionConfig configs[] = { { 3840, 8 }, { 100000, 128 } };
+static constexpr int session_seconds = 2;       // Muestras agregadas por ciclo
+static constexpr size_t tolerance = 1 << 20;    // Variación admitida de la memoria comprometida
+
+static void RunSession(SessionPool& pool, const SessionConfig& config) {
+    uint64_t budget_samples = 64ull * 1024 * 1024 * BlockSummaries<>::block_size /
+                              (3 * sizeof(double) * BlockSummaries<>::block_size + 2 * sizeof(BlockSummary));
+    uint32_t capacity = (uint32_t)budget_samples;
+    uint32_t view = 30 * config.sampling_rate;
+    uint32_t frame = config.sampling_rate / 4 + 512;
+    if (capacity < 2 * (view + frame))
+        view = capacity / 2 - frame;
+
+    auto session = pool.Acquire(config.sampling_rate, capacity, view, config.decimation);
+
+    double batch_time[128], batch_value[128];
+    double time = 0;
+    for (int n = 0; n < config.sampling_rate * session_seconds; n += 128) {
+        if (!session->x->prepare(128) || !session->y->prepare(128) || !session->filtered->prepare(128)) {
+            std::printf("Sin memoria para los buffers\n");
+            std::exit(1);
+        }
+        for (int i = 0; i < 128; i++) {
+            batch_time[i] = time;
+            batch_value[i] = std::sin(2 * 3.14159265358979 * 50 * time);
+            session->x->push(batch_time[i]);
+            session->y->push(batch_value[i]);
+            session->filtered->push(batch_value[i]);
+            time += 1.0 / config.sampling_rate;
+        }
+        session->input_blocks->write(batch_value, batch_time, 128);
+        session->output_blocks->write(batch_value, batch_time, 128);
+    }
+
+    session->fft->SetData(session->y->data(), session->y->count());
+    session->fft->Compute();
+    pool.Release(std::move(session));
+}
+
+int main(int argc, char** argv) {
+    int cycles = argc > 1 ? std::atoi(argv[1]) : 1000;
+    SessionPool pool;
+
+    // Primer par de ciclos: crea los dos juegos y los planes de FFTW
+    for (const SessionConfig& config : configs)
+        RunSession(pool, config);
+    size_t baseline = ReservedMemory::CommittedBytes();
+    size_t peak = baseline;
+
+    for (int cycle = 0; cycle < cycles; cycle++) {
+        RunSession(pool, configs[cycle % std::size(configs)]);
+        size_t committed = ReservedMemory::CommittedBytes();
+        peak = committed > peak ? committed : peak;
+        if ((cycle + 1) % 100 == 0)
+            std::printf("ciclo %4d: comprometida %.1f MB (inicial %.1f MB)\n", cycle + 1,
+                        committed / 1048576.0, baseline / 1048576.0);
+    }
+
+    size_t final_bytes = ReservedMemory::CommittedBytes();
+    std::printf("Juegos creados: %llu, reutilizados: %llu, pico %.1f MB\n",
+                (unsigned long long)pool.Created(), (unsigned long long)pool.Reused(), peak / 1048576.0);
+
+    bool flat = final_bytes <= baseline + tolerance;
+    bool pooled = pool.Created() == std::size(configs);
+    if (!flat)
+        std::printf("FALLA: la memoria comprometida crecio %.1f MB\n", (final_bytes - baseline) / 1048576.0);
+    if (!pooled)
+        std::printf("FALLA: se crearon juegos nuevos despues del primer ciclo\n");
+    return flat && pooled ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// view_publisher_test.cpp - Prueba de estrés de ViewPublisher (un productor, varios lectores)
+//
+// El productor agrega lotes a un almacenamiento con la misma política que ScrollBuffer::push
+// (compacta las últimas view - 1 muestras al inicio al llenarse) y publica la ventana tras
+// cada lote. Cada muestra guarda su índice absoluto, así un lector puede verificar que una
+// ventana validada es consecutiva y nunca retrocede. Pensada para correr con ThreadSanitizer.
+
+#include "ViewPublisher.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t capacity = 4096;
+constexpr uint32_t view = 1024;
+constexpr uint64_t total_samples = 2'000'000;
+constexpr int readers = 3;
+
+// Almacenamiento atómico (relaxed): los lectores leen mientras el productor escribe y
+// descartan lo leído si validate() falla, como en un seqlock
+std::vector<std::atomic_uint64_t> storage(capacity);
+ViewPublisher publisher;
+std::atomic_bool done = false;
+std::atomic_int failures = 0;
+
+void Producer() {
+    uint32_t size = 0, offset = 0;
+    uint64_t next = 1;  // 0 queda para "sin escribir"
+    uint32_t batch = 1;
+
+    while (next <= total_samples) {
+        // Mismo criterio que ScrollBuffer::will_wrap
+        if (size + batch > capacity)
+            publisher.begin_write();
+
+        for (uint32_t i = 0; i < batch; i++) {
+            if (size == capacity) {
+                uint32_t count = view - 1;
+                for (uint32_t j = 0; j < count; j++)
+                    storage[j].store(storage[capacity - count + j].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                storage[count].store(next++, std::memory_order_relaxed);
+                size = view;
+                offset = 0;
+                continue;
+            }
+            storage[size++].store(next++, std::memory_order_relaxed);
+            if (size > view)
+                offset = size - view;
+        }
+
+        publisher.publish(offset, size < view ? size : view);
+        batch = batch % 128 + 1;  // Lotes de 1 a 128 muestras, como SerialWorker
+    }
+    done = true;
+}
+
+void Reader(int id) {
+    uint64_t last_seen = 0, last_generation = 0, validated = 0;
+    std::vector<uint64_t> copy(view);
+
+    while (!done) {
+        BufferView window = publisher.acquire();
+        if (window.count > view || window.start + window.count > capacity) {
+            std::printf("lector %d: ventana fuera de rango (%u, %u)\n", id, window.start, window.count);
+            failures++;
+            return;
+        }
+        if (window.generation < last_generation) {
+            std::printf("lector %d: la generación retrocedió\n", id);
+            failures++;
+            return;
+        }
+        last_generation = window.generation;
+
+        for (uint32_t i = 0; i < window.count; i++)
+            copy[i] = storage[window.start + i].load(std::memory_order_relaxed);
+        if (!publisher.validate(window) || window.count == 0)
+            continue;
+
+        validated++;
+        for (uint32_t i = 1; i < window.count; i++) {
+            if (copy[i] != copy[0] + i) {
+                std::printf("lector %d: ventana validada no consecutiva en %u (%llu, %llu)\n", id, i,
+                            (unsigned long long)copy[0], (unsigned long long)copy[i]);
+                failures++;
+                return;
+            }
+        }
+        uint64_t newest = copy[window.count - 1];
+        if (newest < last_seen) {
+            std::printf("lector %d: la ventana retrocedió (%llu < %llu)\n", id,
+                        (unsigned long long)newest, (unsigned long long)last_seen);
+            failures++;
+            return;
+        }
+        last_seen = newest;
+    }
+
+    if (validated == 0) {
+        std::printf("lector %d: ninguna ventana validada\n", id);
+        failures++;
+    }
+}
+
+}
+
+int main() {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; i++)
+        threads.emplace_back(Reader, i);
+    threads.emplace_back(Producer);
+    for (auto& thread : threads)
+        thread.join();
+
+    if (failures > 0) {
+        std::printf("view_publisher_test: %d fallas\n", failures.load());
+        return 1;
+    }
+    std::printf("view_publisher_test: OK (%llu muestras, %d lectores)\n", (unsigned long long)total_samples, readers);
+    return 0;
+}